@@ -56,6 +56,17 @@ private:
     bee::EaseType m_rotationEase = bee::EaseType::EaseOutQuad;
     bool m_isTweening = false;
 
+    // The roll that is being tweened, read by the tween callbacks
+    struct PlayerMove
+    {
+        glm::vec3 initialPosition;
+        glm::vec3 targetPosition;
+        glm::vec3 pivotPoint;
+        glm::vec3 rotationAxis;
+        glm::quat initialRotation;
+    };
+    PlayerMove m_playerMove;
+
     std::vector<entt::entity> m_tiles;
     std::vector<entt::entity> m_cubeSides;
 
@@ -76,8 +87,7 @@ private:
 
     glm::vec3 CalculatePivotPoint(const glm::vec3& initialPosition, const glm::vec3& movement, float cubeSize);
 
-    void StartPlayerMovementTween(bee::Transform& m_playerTransform,
-                                  const glm::vec3& initialPosition,
+    void StartPlayerMovementTween(const glm::vec3& initialPosition,
                                   const glm::vec3& targetPosition,
                                   const glm::vec3& pivotPoint,
                                   const glm::vec3& rotationAxis,
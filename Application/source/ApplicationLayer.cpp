@@ -155,7 +155,7 @@ void ApplicationLayer::MovePlayer(glm::int2 direction)
     glm::vec3 rotationAxis = CalculateRotationAxis(movementDirection);
     glm::vec3 pivotPoint = CalculatePivotPoint(initialPosition, movement, cubeSize);
 
-    StartPlayerMovementTween(m_playerTransform, initialPosition, targetPosition, pivotPoint, rotationAxis, initialRotation);
+    StartPlayerMovementTween(initialPosition, targetPosition, pivotPoint, rotationAxis, initialRotation);
     m_isTweening = true;
 }
 
@@ -199,35 +199,44 @@ glm::vec3 ApplicationLayer::CalculatePivotPoint(const glm::vec3& initialPosition
     return initialPosition + (movement * 0.5f) - glm::vec3(0, cubeSize / 2.0f, 0);
 }
 
-void ApplicationLayer::StartPlayerMovementTween(bee::Transform& m_playerTransform,
-                                                const glm::vec3& initialPosition,
+void ApplicationLayer::StartPlayerMovementTween(const glm::vec3& initialPosition,
                                                 const glm::vec3& targetPosition,
                                                 const glm::vec3& pivotPoint,
                                                 const glm::vec3& rotationAxis,
                                                 const glm::quat& initialRotation)
 {
+    m_playerMove = {initialPosition, targetPosition, pivotPoint, rotationAxis, initialRotation};
+
     auto tween = CREATE_TWEEN(float, 0.0f, glm::half_pi<float>(), 0.2f);
-    tween->OnUpdate(
-        [&m_playerTransform, initialPosition, rotationAxis, pivotPoint, initialRotation](const float& angle, float )
+    tween.OnUpdate(
+        [](void* context, const float& angle, float)
         {
-            glm::quat rotationQuat = glm::angleAxis(angle, rotationAxis);
-            glm::vec3 offset = initialPosition - pivotPoint;
+            auto& layer = *static_cast<ApplicationLayer*>(context);
+            const PlayerMove& move = layer.m_playerMove;
+            auto& playerTransform = bee::Engine.Registry().get<bee::Transform>(layer.m_player);
+
+            glm::quat rotationQuat = glm::angleAxis(angle, move.rotationAxis);
+            glm::vec3 offset = move.initialPosition - move.pivotPoint;
             glm::vec3 rotatedOffset = rotationQuat * offset;
-            glm::vec3 newPosition = pivotPoint + rotatedOffset;
+            glm::vec3 newPosition = move.pivotPoint + rotatedOffset;
 
-            m_playerTransform.SetPosition(newPosition);
-            m_playerTransform.SetRotationQuat(rotationQuat * initialRotation);
-        });
+            playerTransform.SetPosition(newPosition);
+            playerTransform.SetRotationQuat(rotationQuat * move.initialRotation);
+        },
+        this);
 
-    tween->OnFinish(
-        [this, &m_playerTransform, targetPosition](const float& )
+    tween.OnFinish(
+        [](void* context, const float&)
         {
-            m_playerTransform.SetPosition(targetPosition);
-            m_isTweening = false;
-            CheckTiles(targetPosition);
-        });
-
-    tween->SetEase(m_rotationEase);
+            auto& layer = *static_cast<ApplicationLayer*>(context);
+            auto& playerTransform = bee::Engine.Registry().get<bee::Transform>(layer.m_player);
+            playerTransform.SetPosition(layer.m_playerMove.targetPosition);
+            layer.m_isTweening = false;
+            layer.CheckTiles(layer.m_playerMove.targetPosition);
+        },
+        this);
+
+    tween.SetEase(m_rotationEase);
     bee::Tweener::AddTween(tween);
 }
 
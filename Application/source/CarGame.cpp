@@ -40,7 +40,7 @@ void CarGame::OnUpdate(float deltaTime)
     for (auto tire : m_tires)
     {
         auto& transform = bee::Engine.Registry().get<bee::Transform>(tire);
-        transform.SetRotation(transform.GetRotationEuler() + glm::vec3(m_tireSpeed, 0.0f, 0.0f) * player.speed * deltaTime);
+        transform.Rotate(glm::vec3(m_tireSpeed, 0.0f, 0.0f) * player.speed * deltaTime);
     }
 
     HandleInput(deltaTime);
@@ -3,10 +3,11 @@
 #include "CarGame.h"
 //#include <iostream>
 
-int main()
+int main(int argc, char* argv[])
 {
     EngineSettings settings;
     settings.projectPath = "Application";
+    bee::ParseArguments(settings, argc, argv);
     bee::Engine.Initialize(settings);
     bee::Engine.PushAppLayer(new CarGame());
     bee::Engine.Run();
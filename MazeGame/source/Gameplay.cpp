@@ -1,6 +1,5 @@
 #include "gameplay.hpp"
 #include <algorithm>
-#include <random>
 
 constexpr glm::int3 directions[] = {
     {0, 0, 1},
@@ -83,7 +82,7 @@ bool Gameplay::Step()
     while (true)
     {
         std::array<int, 6> indices = {0, 1, 2, 3, 4, 5};
-        std::shuffle(indices.begin(), indices.end(), std::mt19937(std::random_device()()));
+        std::shuffle(indices.begin(), indices.end(), bee::ThreadRandom());
 
         int i = 0;
         glm::int3 direction;
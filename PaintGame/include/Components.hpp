@@ -3,8 +3,9 @@
 
 struct Bullet
 {
-    float lifetime = 10.0f;
+    float lifetime = 10.0f;  // seconds until expiry fires
     glm::vec3 color;
+    bee::TimerHandle expiry;  // destroys the bullet when its lifetime is over, runtime only
 
     template <typename Archive>
     void serialize(Archive& archive)
@@ -19,6 +20,12 @@ struct Rigidbody
     glm::vec3 acceleration;
     glm::vec3 previousPosition;
 
+    // Sleeping state, runtime only
+    bool sleeping = false;
+    uint32_t lowVelocitySteps = 0;  // steps in a row the body moved slower than the sleep velocity
+    uint32_t island = 0;            // island of the last step
+    uint64_t sleepVersion = 0;      // transform version when the body fell asleep, moving the body wakes it up
+
     template <typename Archive>
     void serialize(Archive& archive)
     {
@@ -53,8 +60,18 @@ struct BoxCollider
     }
 };
 
-struct PaintSplash
+// Paint settings of a level, put it on any entity of the scene. Levels without one use the defaults.
+struct PaintSettings
 {
+    int budgetMegabytes = 64;  // CPU and GPU copies of all atlases of the level
+    float texelsPerUnit = 32.0f;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        make_optional_nvp(archive, "budgetMegabytes", budgetMegabytes);
+        make_optional_nvp(archive, "texelsPerUnit", texelsPerUnit);
+    }
 };
 
 #ifdef BEE_PLATFORM_PC
@@ -72,6 +89,15 @@ static void DrawBoxCollider(entt::entity entity)
     ImGui::DragFloat3("Size", &boxCollider.size[0], 0.1f);
 }
 
+static void DrawPaintSettings(entt::entity entity)
+{
+    auto& registry = bee::Engine.Registry();
+    auto& settings = registry.get<PaintSettings>(entity);
+
+    ImGui::SliderInt("Budget (MB)", &settings.budgetMegabytes, 8, 512);
+    ImGui::SliderFloat("Texels Per Unit", &settings.texelsPerUnit, 4.0f, 128.0f, "%.1f");
+}
+
 #ifdef BEE_PLATFORM_PC
 #pragma warning(pop)
 #endif
@@ -1,6 +1,7 @@
 #pragma once
 #include "bee.hpp"
 #include "Physics.hpp"
+#include "PaintSystem.hpp"
 
 class Gameplay : public bee::Layer
 {
@@ -23,11 +24,11 @@ private:
     entt::entity m_gun;
     entt::entity m_bulletPrefab;
     entt::entity m_paintSplashPrefab;
-    entt::entity m_paintImagePrefab;
     entt::entity m_barrel;
     entt::entity m_earth;
 
     std::array<Ref<bee::resource::Texture>, 4> m_paintTextures;
+    PaintSystem m_paint;
 
     glm::vec3 m_gunOffset = glm::vec3(-0.5f, 1.5f, 0.25f);
 
@@ -44,6 +45,9 @@ private:
     glm::vec3 m_paintColor = glm::vec3(1.0f, 0.0f, 0.0f);
 
     bool m_destroyBulletOnHit = false;
+    bool m_exactPaintHits = true;
+    float m_paintProbeDistance = 0.5f;
+    float m_paintRadius = 0.3f;
 
 private:
     void UpdateCamera();
@@ -57,8 +61,8 @@ private:
 
     void CheckCollisions();
     void OnBulletHit(entt::entity bullet, entt::entity collider, const Physics::CollisionInfo& info);
-    void UpdatePaintSplashes();
-    void UpdateBullets(float dt);
+    bool FindPaintSurface(entt::entity bullet, entt::entity collider, Physics::CollisionInfo& info) const;
+    static void OnBulletExpired(void* context, uint64_t bullet);
 };
 
 
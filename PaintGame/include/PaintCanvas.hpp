@@ -0,0 +1,109 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+/// <summary>
+/// RGBA8 image that is painted on the CPU. Writes mark the tiles they touch so only those have to be uploaded.
+/// Nothing in here talks to the renderer, the canvas and the splat functions below work without a GPU.
+/// </summary>
+class PaintCanvas
+{
+public:
+    static constexpr int tileSize = 32;
+
+    PaintCanvas() = default;
+    PaintCanvas(int width, int height, const glm::u8vec4& color);
+
+    int Width() const { return m_width; }
+    int Height() const { return m_height; }
+    size_t Bytes() const { return m_pixels.size() * sizeof(glm::u8vec4); }
+
+    glm::u8vec4* Pixels() { return m_pixels.data(); }
+    const glm::u8vec4* Pixels() const { return m_pixels.data(); }
+    glm::u8vec4& At(int x, int y) { return m_pixels[static_cast<size_t>(y) * m_width + x]; }
+    const glm::u8vec4& At(int x, int y) const { return m_pixels[static_cast<size_t>(y) * m_width + x]; }
+
+    // Marks the tiles touching the pixels [x0, x1] x [y0, y1] as changed
+    void MarkDirty(int x0, int y0, int x1, int y1);
+    size_t DirtyTileCount() const { return m_dirtyTiles.size(); }
+
+    // Calls fn(x, y, width, height) for every changed tile and clears the changes
+    template <typename Fn>
+    void FlushDirtyTiles(Fn&& fn);
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    int m_tilesX = 0;
+    int m_tilesY = 0;
+    std::vector<glm::u8vec4> m_pixels;
+    std::vector<uint8_t> m_tileDirty;
+    std::vector<uint32_t> m_dirtyTiles;
+};
+
+// Square cell of a paint atlas holding one triangle, the triangle covers the half below the diagonal
+struct AtlasCell
+{
+    int x = 0;
+    int y = 0;
+    int size = 0;
+};
+
+// Packs the cells on shelves, largest first, into an atlas of the given width.
+// Returns the used height, 0 if a cell is wider than the atlas.
+int PackAtlas(const std::vector<int>& sizes, int width, std::vector<AtlasCell>& cells);
+
+// Texture coordinates of the corners of the triangle in the cell, on texel centers so nearest sampling stays in the cell
+void GetCellUVs(const AtlasCell& cell, int atlasWidth, int atlasHeight, glm::vec2 uvs[3]);
+
+struct PaintBrush
+{
+    glm::vec3 center = glm::vec3(0.0f);
+    glm::vec3 normal = glm::vec3(0.0f, 1.0f, 0.0f);
+    glm::vec3 tangent = glm::vec3(1.0f, 0.0f, 0.0f);  // orientation of the mask around the normal
+    float radius = 0.25f;                             // also how far in front of and behind the surface it reaches
+    glm::vec4 color = glm::vec4(1.0f);                // alpha is the strength
+
+    // Coverage over the square around the center, one byte per texel. Paints a disc when there is no mask.
+    const uint8_t* mask = nullptr;
+    int maskWidth = 0;
+    int maskHeight = 0;
+};
+
+// Paints the brush into the cell of a triangle, the corners are in the space of the brush.
+// Triangles facing away from the brush are skipped. Returns the amount of texels that changed.
+int SplatTriangle(PaintCanvas& canvas,
+                  const AtlasCell& cell,
+                  const glm::vec3& a,
+                  const glm::vec3& b,
+                  const glm::vec3& c,
+                  const PaintBrush& brush);
+
+// Fills the cell with the texture sampled at the uvs of the triangle, the texture repeats. No texture fills it white.
+void BakeTriangle(PaintCanvas& canvas,
+                  const AtlasCell& cell,
+                  const glm::vec2 uvs[3],
+                  const glm::u8vec4* texture,
+                  int textureWidth,
+                  int textureHeight);
+
+template <typename Fn>
+void PaintCanvas::FlushDirtyTiles(Fn&& fn)
+{
+    for (uint32_t tile : m_dirtyTiles)
+    {
+        m_tileDirty[tile] = 0;
+        const int x = static_cast<int>(tile % m_tilesX) * tileSize;
+        const int y = static_cast<int>(tile / m_tilesX) * tileSize;
+        fn(x, y, std::min(tileSize, m_width - x), std::min(tileSize, m_height - y));
+    }
+    m_dirtyTiles.clear();
+}
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
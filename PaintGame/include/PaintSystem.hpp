@@ -0,0 +1,92 @@
+#pragma once
+#include "bee.hpp"
+#include "PaintCanvas.hpp"
+#include "Components.hpp"
+
+/// <summary>
+/// Accumulates paint in textures instead of spawning decals. When a level is prepared every mesh of a static collider
+/// is swapped for a copy in which every triangle has its own cell in a paint atlas, baked from the original texture.
+/// Splats are rasterized into the atlas on the CPU and only the tiles that changed are uploaded. The atlases stay
+/// within the budget of the level, meshes that don't fit keep their original look and can't be painted.
+/// </summary>
+class PaintSystem
+{
+public:
+    // Reads back the textures and bakes the atlases of every mesh that can be painted, with the PaintSettings of the
+    // level. Call after loading a level, painting never touches the GPU besides the tile uploads.
+    void Prepare(entt::registry& registry);
+
+    // Splats paint around the point on the meshes of the entity and its children, angle rotates the brush mask.
+    // Returns false if nothing was painted.
+    bool Paint(entt::registry& registry,
+               entt::entity root,
+               const glm::vec3& position,
+               const glm::vec3& normal,
+               const glm::vec3& color,
+               float radius,
+               float angle);
+
+    // The alpha of the texture is the shape of the brush
+    void SetBrushMask(const bee::resource::Texture& texture);
+
+    // Uploads the changed tiles of every atlas, call once per frame
+    void Upload(entt::registry& registry);
+
+    // Gives every prepared mesh its original mesh and texture back
+    void Clear(entt::registry& registry);
+
+    void OnImGuiRender(entt::registry& registry);
+
+    float minTexelsPerUnit = 4.0f;  // atlases that need a lower density to fit the budget are not created
+
+private:
+    static constexpr int maxCellSize = 128;
+    static constexpr int maxAtlasSize = 4096;
+
+    struct Surface
+    {
+        Ref<bee::resource::Mesh> originalMesh;
+        Ref<bee::resource::Texture> originalTexture;
+        Ref<bee::resource::Mesh> paintMesh;
+        Ref<bee::resource::Texture> paintTexture;
+        PaintCanvas canvas;
+        std::vector<AtlasCell> cells;  // in the triangle order of the original mesh BVH
+        size_t bytes = 0;
+        uint64_t lastPainted = 0;
+    };
+
+    struct TexturePixels
+    {
+        std::vector<unsigned char> pixels;
+        int width = 0;
+        int height = 0;
+    };
+
+    std::unordered_map<entt::entity, Surface> m_surfaces;
+    std::unordered_map<int, TexturePixels> m_texturePixels;  // original textures read back for baking, by xsr handle
+    PaintSettings m_settings;
+    std::vector<uint8_t> m_mask;
+    int m_maskWidth = 0;
+    int m_maskHeight = 0;
+
+    size_t m_usedBytes = 0;
+    uint64_t m_paintCount = 0;
+    size_t m_uploadedTiles = 0;
+    size_t m_evictions = 0;
+
+    size_t Budget() const { return static_cast<size_t>(m_settings.budgetMegabytes) * 1024 * 1024; }
+    Surface* GetSurface(entt::registry& registry, entt::entity entity);
+    bool CreateSurface(entt::registry& registry, entt::entity entity, Surface& surface);
+    void RestoreSurface(entt::registry& registry, entt::entity entity, Surface& surface);
+    bool EvictLeastRecentlyPainted(entt::registry& registry);
+    const TexturePixels& GetTexturePixels(const bee::resource::Texture& texture);
+};
+
+// Rasterizes known triangles into small canvases and compares the texels, then times the splat and the bake
+std::vector<bee::benchmark::Result> BenchmarkPaintCanvas();
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
@@ -2,15 +2,6 @@
 #include "Bee.hpp"
 #include "common.hpp"
 
-//written by ChatGPT
-struct EntityPairHash
-{
-    std::size_t operator()(const std::pair<entt::entity, entt::entity>& pair) const
-    {
-        return std::hash<int>()((int)pair.first) ^ std::hash<int>()((int)pair.second);
-    }
-};
-
 class Physics : public bee::Layer
 {
 public:
@@ -32,57 +23,177 @@ public:
         float impactVelocity;
     };
 
-    bool HasCollided(entt::entity entityA, entt::entity entityB, CollisionInfo& info) const;
+    enum class ContactState : uint8_t
+    {
+        Begin,  // the pair started touching this step
+        Stay,   // the pair was already touching last step
+        End     // the pair stopped touching, info is from the last step it touched
+    };
+
+    struct ContactEvent
+    {
+        entt::entity entityA;  // the rigidbody for sweep contacts
+        entt::entity entityB;
+        ContactState state;
+        CollisionInfo info;
+    };
+
+    // All contacts of the last fixed step, sorted by pair. End events can refer to entities that were destroyed.
+    const std::vector<ContactEvent>& GetContactEvents() const { return m_contactEvents; }
+
+    // Calls fn(const ContactEvent&) for every contact of the last fixed step that the entity is part of
+    template <typename Fn>
+    void ForEachContact(entt::entity entity, Fn&& fn) const;
+
+    // Wakes the rigidbody and every body in its island. Sleeping bodies also wake up by themselves when they get moved,
+    // get a velocity, or something they rest on moves or is destroyed.
+    void WakeUp(entt::entity entity);
+
+    // Runs a test scene with every thread count of the job system, checks the results are bitwise the same and times
+    // the steps. Leaves the current scene as it was.
+    std::vector<bee::benchmark::Result> BenchmarkStep();
 
 private:
     float m_gravity = -9.81f;
     float m_reflectionCoefficient = 0.85f;
 
-    // Define a struct for the Oriented Bounding Box (OBB), written by ChatGPT
-    struct OBB
+    // Share of the renderables in a generated stress scene that get a box collider, and of those roots that also get a
+    // rigidbody. Children stay static, their transform is relative to a parent that doesn't move.
+    float m_stressColliderFraction = 0.25f;
+    float m_stressRigidbodyFraction = 0.2f;
+    static void DecorateStressScene(entt::registry& registry, entt::entity entity, bee::Random& random, void* context);
+
+    using OBB = bee::OBB;
+
+    // World space boxes of all colliders, only rebuilt when the transform of the collider or one of its parents
+    // changed, or the collider size did
+    struct CachedOBB
     {
-        glm::vec3 center;
-        glm::vec3 axes[3];    // Normalized local axes (rotation)
-        glm::vec3 halfSizes;  // Half-sizes along each local axis (including scaling)
-
-        // copy constructor
-        OBB(const OBB& other)
-        {
-            center = other.center;
-            axes[0] = other.axes[0];
-            axes[1] = other.axes[1];
-            axes[2] = other.axes[2];
-            halfSizes = other.halfSizes;
-        }
-
-        // default constructor
-        OBB() = default;
-
-        // assignment operator
-        OBB& operator=(const OBB& other)
-        {
-            center = other.center;
-            axes[0] = other.axes[0];
-            axes[1] = other.axes[1];
-            axes[2] = other.axes[2];
-            halfSizes = other.halfSizes;
-            return *this;
-        }
+        OBB obb;
+        uint64_t worldVersion = 0;
+        glm::vec3 size = glm::vec3(0.0f);
+        uint32_t stamp = 0;
     };
+    std::unordered_map<entt::entity, CachedOBB> entityOBBs;
+    size_t m_obbCacheHits = 0;
+    size_t m_obbCacheMisses = 0;
 
-    std::unordered_map<std::pair<entt::entity, entt::entity>, CollisionInfo, EntityPairHash> m_collisions;
-    std::unordered_map<entt::entity, OBB> entityOBBs;
+    // contacts found this step, turned into events at the end of the step
+    std::vector<ContactEvent> m_contacts;
+    std::vector<ContactEvent> m_previousContacts;
+    std::vector<ContactEvent> m_contactEvents;
+    // Stay contacts of sleeping bodies, sorted by pair. They are kept for waking and islands but not published.
+    std::vector<ContactEvent> m_restingContacts;
+    // per entity ranges into m_contactIndices, which holds indices into m_contactEvents
+    std::unordered_map<entt::entity, std::pair<uint32_t, uint32_t>> m_entityContacts;
+    std::vector<uint32_t> m_contactIndices;
 
+    // Broadphase, colliders without a rigidbody go in the static tree and only get reinserted if they leave their
+    // fat bounds. Rigidbodies go in the dynamic tree with bounds stretched along their movement.
+    struct ColliderProxy
+    {
+        int proxy = bee::AABBTree::Null;
+        bool dynamic = false;
+        uint32_t order = 0;  // position in the collider view, static pairs are stored in this order
+        uint32_t stamp = 0;
+    };
+
+    bee::AABBTree m_staticTree = bee::AABBTree(0.05f);
+    bee::AABBTree m_dynamicTree = bee::AABBTree(0.1f);
+    std::unordered_map<entt::entity, ColliderProxy> m_proxies;
+    uint32_t m_stamp = 0;
+
+    bool m_drawBroadphase = false;
+    std::vector<std::pair<entt::entity, entt::entity>> m_candidatePairs;
+    std::vector<size_t> m_pairGroups;  // start of every run of candidate pairs with the same first entity
+    size_t m_sweepCandidates = 0;
+
+    // The step runs in parallel phases over fixed size chunks. Every chunk writes to its own output, which is merged in
+    // chunk order, so the result is the same for any number of threads.
+    static constexpr size_t bodiesPerChunk = 64;
+    static constexpr size_t collidersPerChunk = 64;
+    static constexpr size_t pairGroupsPerChunk = 32;
+    struct StepChunk
+    {
+        std::vector<std::pair<entt::entity, entt::entity>> pairs;
+        std::vector<ContactEvent> contacts;
+        size_t sweepCandidates = 0;
+        // narrowphase scratch buffers, candidates are packed in blocks of four for the batch tests
+        std::vector<entt::entity> sweepEntities;
+        std::vector<OBB> candidateOBBs;
+        std::vector<bee::OBB4> candidateBlocks;
+    };
+    std::vector<StepChunk> m_chunks;
+    std::vector<entt::entity> m_staticColliders;  // colliders in the static tree in view order
+    std::vector<glm::vec3> m_bodyDisplacements;   // per body in m_bodies, used to update the dynamic tree
+
+    // Sleeping, bodies that touch form an island and an island only sleeps once all its bodies have been slower than
+    // the sleep velocity for enough steps. Sleeping bodies skip integration and the sweep, and keep their contacts
+    // without publishing them again until they wake up.
+    bool m_allowSleeping = true;
+    float m_sleepVelocity = 0.3f;
+    int m_sleepSteps = 30;
+    std::vector<entt::entity> m_islandBodies;  // bodies grouped per island
+    std::vector<uint32_t> m_islandOffsets;     // island i is [m_islandOffsets[i], m_islandOffsets[i + 1])
+    std::vector<entt::entity> m_bodies;  // all rigidbodies of the step in view order
+    std::vector<uint32_t> m_bodyParents;  // union find over m_bodies
+    std::unordered_map<entt::entity, uint32_t> m_bodyIndices;
+    size_t m_sleepingBodies = 0;
+    size_t m_fellAsleep = 0;
+    size_t m_wokeUp = 0;
+    size_t m_totalSleeps = 0;
+    size_t m_totalWakes = 0;
+
+    // drops the trees, box caches, islands and contacts, the next step rebuilds them
+    void Reset();
+    void GatherBodies();
+    void PrepareChunks(size_t count);
+    void WakeSleepingBodies();
+    void WakeIsland(uint32_t island);
+    void UpdateIslands();
     void UpdatePositions(float deltaTime);
+    void UpdateBroadphase(entt::entity entity, const OBB& obb, bool dynamic, uint32_t order, const glm::vec3& displacement);
+    // Proxies not updated this step, only those of the static tree when dynamic is false. Dynamic proxies are updated
+    // after the sweep, so those can only be removed at the end of the step.
+    void RemoveStaleProxies(bool dynamic);
+    const OBB& UpdateOBB(entt::entity entity, const glm::vec3& size, const bee::Transform& transform);
     void CheckCollisions();
-    bool LineSegmentOBBIntersection(const glm::vec3& start,
-                                    const glm::vec3& end,
-                                    const OBB& obb,
-                                    float& t,
-                                    glm::vec3& intersectionPoint,
-                                    glm::vec3& normal);
+    void QueryStaticPairs(size_t collider, StepChunk& chunk) const;
+    void TestPairGroup(size_t group, StepChunk& chunk) const;
+    void SweepBody(size_t body, StepChunk& chunk);
+    void QueryBodyTouches(size_t body, StepChunk& chunk) const;
+    CollisionInfo GetStaticContactInfo(entt::entity entityA,
+                                       entt::entity entityB,
+                                       float penetration,
+                                       const glm::vec3& normal) const;
+    void PublishContactEvents();
+
+    // Calls fn(const ContactEvent&) for every contact the sleeping body rests on
+    template <typename Fn>
+    void ForEachRestingContact(entt::entity entity, Fn&& fn) const;
 };
 
+template <typename Fn>
+void Physics::ForEachContact(entt::entity entity, Fn&& fn) const
+{
+    auto it = m_entityContacts.find(entity);
+    if (it == m_entityContacts.end()) return;
+
+    const auto [offset, count] = it->second;
+    for (uint32_t i = offset; i < offset + count; i++) fn(m_contactEvents[m_contactIndices[i]]);
+}
+
+template <typename Fn>
+void Physics::ForEachRestingContact(entt::entity entity, Fn&& fn) const
+{
+    // sorted by pair and the body is always the first entity, so its contacts are one run
+    auto first = std::lower_bound(m_restingContacts.begin(),
+                                  m_restingContacts.end(),
+                                  entity,
+                                  [](const ContactEvent& contact, entt::entity body) { return contact.entityA < body; });
+    for (; first != m_restingContacts.end() && first->entityA == entity; ++first) fn(*first);
+}
+
 
 /*
 Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
@@ -34,10 +34,6 @@ void Gameplay::OnAttach()
     GAME_EXCEPTION_IF(paintSplash.empty(), "No PaintSplashPrefab found in Scene");
     m_paintSplashPrefab = paintSplash.front();
 
-    auto paintImage = bee::ecs::FindEntitiesByName(bee::Engine.Registry(), "PaintImagePrefab");
-    GAME_EXCEPTION_IF(paintImage.empty(), "No PaintImagePrefab found in Scene");
-    m_paintImagePrefab = paintImage.front();
-
     auto earth = bee::ecs::FindEntitiesByName(bee::Engine.Registry(), "Earth");
     GAME_EXCEPTION_IF(earth.empty(), "No Earthfound in Scene");
     m_earth = earth.front();
@@ -47,33 +43,31 @@ void Gameplay::OnAttach()
     // m_paintTextures[1] = bee::resource::LoadResource<bee::resource::Texture>("assets/Paint/paint_splat_b_double.png");
     // m_paintTextures[2] = bee::resource::LoadResource<bee::resource::Texture>("assets/Paint/paint_splat_c_double.png");
     // m_paintTextures[3] = bee::resource::LoadResource<bee::resource::Texture>("assets/Paint/paint_splat_d_double.png");
+    m_paint.SetBrushMask(*m_paintTextures[0]);
+    m_paint.Prepare(registry);
 
     bee::Engine.Device().HideCursor(true);
 }
 
-void Gameplay::OnDetach() {}
+void Gameplay::OnDetach() { m_paint.Clear(bee::Engine.Registry()); }
 
 void Gameplay::OnRender() {}
 
-void Gameplay::OnEngineInit() {}
+void Gameplay::OnEngineInit()
+{
+    bee::ComponentManager::RegisterComponent<PaintSettings, DrawPaintSettings>("PaintSettings", true, true);
+    bee::benchmark::Register("Paint", []() { return BenchmarkPaintCanvas(); });
+}
 
 void Gameplay::OnImGuiRender()
 {
     ImGui::Begin("Gameplay");
     ImGui::Text("Press 'F1' to show cursor");
-    int splashCount = (int)bee::Engine.Registry().view<PaintSplash>().size();
 
-    // clear paint splashes button
-    if (ImGui::Button("Clear Paint Splashes"))
-    {
-        auto view = bee::Engine.Registry().view<PaintSplash>();
-        for (auto entity : view)
-        {
-            bee::ecs::DestroyEntity(entity, bee::Engine.Registry());
-        }
-    }
+    // clear paint button
+    if (ImGui::Button("Clear Paint")) m_paint.Prepare(bee::Engine.Registry());
 
-    ImGui::Text("Paint Splashes: %d", splashCount);
+    m_paint.OnImGuiRender(bee::Engine.Registry());
     ImGui::SliderFloat3("Gun Offset", glm::value_ptr(m_gunOffset), 0.0f, 1.0f, "%.3f");
     ImGui::SliderFloat("Camera Sensitivity", &m_cameraSensitivity, 0.0f, 1.0f, "%.3f");
     ImGui::SliderFloat("Player Speed", &m_playerSpeed, 0.0f, 10.0f, "%.3f");
@@ -84,6 +78,9 @@ void Gameplay::OnImGuiRender()
     ImGui::SliderFloat("Bullet Lifetime", &m_bulletLifetime, 0.0f, 20.0f, "%.3f");
     ImGui::SliderFloat("Min Bullet Velocity", &m_minBulletVelocity, 0.0f, 1.0f, "%.3f");
     ImGui::Checkbox("Destroy Bullet On Hit", &m_destroyBulletOnHit);
+    ImGui::Checkbox("Exact Paint Hits", &m_exactPaintHits);
+    ImGui::SliderFloat("Paint Probe Distance", &m_paintProbeDistance, 0.0f, 2.0f, "%.3f");
+    ImGui::SliderFloat("Paint Radius", &m_paintRadius, 0.01f, 2.0f, "%.3f");
     ImGui::Checkbox("Rainbow Paint", &m_rainbowPaint);
     ImGui::ColorEdit3("Paint Color", &m_paintColor[0]);
     ImGui::End();
@@ -91,7 +88,7 @@ void Gameplay::OnImGuiRender()
 
 void Gameplay::OnUpdate(float dt)
 {
-    UpdateBullets(dt);
+    m_paint.Upload(bee::Engine.Registry());
     if (!bee::Engine.Device().IsCursorHidden()) return;
     UpdatePosition(dt);
     UpdateCamera();
@@ -163,9 +160,13 @@ void Gameplay::ShootBullet()
     {
         registry.remove<bee::Disabled>(newBullet);
     }
-    registry.emplace<Bullet>(newBullet, m_bulletLifetime, m_paintColor);
+    Bullet& bullet = registry.emplace<Bullet>(newBullet, m_bulletLifetime, m_paintColor);
+    bullet.expiry =
+        bee::Engine.Timers().Schedule(bullet.lifetime, &Gameplay::OnBulletExpired, nullptr, entt::to_integral(newBullet));
     bee::Transform& bulletTransform = bee::Engine.Registry().get<bee::Transform>(newBullet);
     bulletTransform.SetPosition(bee::GetWorldPosition(m_barrel, bee::Engine.Registry()));
+    // drawn between physics steps, replaced so it does not keep the snapshots copied from the prefab
+    registry.emplace_or_replace<bee::Interpolated>(newBullet);
 
     glm::mat4 barrelWorld = bee::GetWorldModel(m_barrel, registry);
     glm::vec3 barrelForward = glm::vec3(barrelWorld[2]);
@@ -202,11 +203,8 @@ void Gameplay::UpdateCamera()
         mouse_delta = glm::vec2(x, y) / m_cameraSensitivity;
     }
 
-    glm::vec3 newRotation =
-        camTransform.GetRotationEuler() - glm::vec3(mouse_delta.y, mouse_delta.x, 0.0f) * m_cameraSensitivity;
-    // clamp pitch
-    newRotation.x = glm::clamp(newRotation.x, -89.0f, 89.0f);
-    camTransform.SetRotation(newRotation);
+    // pitch is clamped to 89 degrees
+    camTransform.AddYawPitch(-mouse_delta.x * m_cameraSensitivity, -mouse_delta.y * m_cameraSensitivity, 89.0f);
 }
 
 void Gameplay::UpdatePosition(float dt)
@@ -284,7 +282,55 @@ void Gameplay::UpdateGunPos()
     bee::SetWorldPosition(m_gun, gunPos, registry);
 }
 
-void Gameplay::OnBulletHit(entt::entity bullet, entt::entity other, const Physics::CollisionInfo& info)
+// The physics contact is on the box of the collider. Casts the path of the bullet against the meshes of the collider
+// and its children to move the contact onto the real surface. Returns false if the path misses the meshes.
+bool Gameplay::FindPaintSurface(entt::entity bullet, entt::entity collider, Physics::CollisionInfo& info) const
+{
+    auto& registry = bee::Engine.Registry();
+
+    glm::vec3 direction = -info.normal;
+    float travelDistance = 0.0f;
+    if (const Rigidbody* rigidbody = registry.try_get<Rigidbody>(bullet))
+    {
+        const glm::vec3 travel = info.worldPosition - rigidbody->previousPosition;
+        if (glm::dot(travel, travel) > 1e-8f)
+        {
+            travelDistance = glm::length(travel);
+            direction = travel / travelDistance;
+        }
+    }
+    const bee::raycasting::Ray ray(info.worldPosition - direction * m_paintProbeDistance, direction);
+    // only surfaces near the contact count, not a wall behind the collider the ray happens to reach
+    const float maxDistance = 2.0f * m_paintProbeDistance + travelDistance;
+
+    bool hasTriangles = false;
+    bee::raycasting::HitInfo closest = {false, std::numeric_limits<float>::max(), glm::vec3(0.0f), glm::vec3(0.0f)};
+    std::vector<entt::entity> stack = {collider};
+    while (!stack.empty())
+    {
+        entt::entity entity = stack.back();
+        stack.pop_back();
+        if (const auto* node = registry.try_get<bee::HierarchyNode>(entity))
+            stack.insert(stack.end(), node->children.begin(), node->children.end());
+
+        const auto* renderable = registry.try_get<bee::Renderable>(entity);
+        if (!renderable || !renderable->visible || !renderable->mesh || !renderable->mesh->HasGeometry()) continue;
+
+        hasTriangles = true;
+        const auto hit = bee::raycasting::IntersectRayWithMesh(ray, bee::GetWorldModel(entity, registry), *renderable->mesh);
+        if (hit.hit && hit.distance <= maxDistance && hit.distance < closest.distance) closest = hit;
+    }
+
+    // meshes without triangles keep the box contact
+    if (!hasTriangles) return true;
+    if (!closest.hit) return false;
+
+    info.worldPosition = closest.position;
+    info.normal = closest.normal;
+    return true;
+}
+
+void Gameplay::OnBulletHit(entt::entity bullet, entt::entity other, const Physics::CollisionInfo& contact)
 {
     auto& registry = bee::Engine.Registry();
 
@@ -293,7 +339,8 @@ void Gameplay::OnBulletHit(entt::entity bullet, entt::entity other, const Physic
         return;
     }
 
-    if (info.impactVelocity > m_minBulletVelocity)
+    Physics::CollisionInfo info = contact;
+    if (info.impactVelocity > m_minBulletVelocity && (!m_exactPaintHits || FindPaintSurface(bullet, other, info)))
     {
         entt::entity newSplash = bee::ecs::DuplicateEntity(registry, m_paintSplashPrefab);
         registry.remove<bee::Disabled>(newSplash);
@@ -311,77 +358,42 @@ void Gameplay::OnBulletHit(entt::entity bullet, entt::entity other, const Physic
         emitter.particleSpecs.multiplyColorGradient.clear();
         emitter.particleSpecs.multiplyColorGradient.addColor(0.0f, glm::vec4(bulletColor, 1.0f));
 
-        entt::entity newImage = bee::ecs::DuplicateEntity(registry, m_paintImagePrefab);
-        registry.remove<bee::Disabled>(newImage);
-        bee::Transform& imageTransform = registry.get<bee::Transform>(newImage);
-        // Generate a random rotation angle between 0 and 360 degrees
+        // Generate a random rotation angle between 0 and 360 degrees for the brush
         float randomAngle = glm::radians(glm::linearRand(0.0f, 360.0f));
-
-        // Apply a random rotation around the normal while keeping it aligned as forward direction
-        glm::quat randomRotation = glm::angleAxis(randomAngle, info.normal);
-        rotationQuat = randomRotation * rotationQuat;  // Combine random rotation with initial orientation
-
-        imageTransform.SetRotationQuat(rotationQuat);
-
-        bee::Renderable& renderable = registry.get<bee::Renderable>(newImage);
-        renderable.multiplier = glm::vec4(bulletColor, 1.0f);
-
-        int splashCount = 1 + (int)registry.view<PaintSplash>().size();
-        float smallValue = 1e-5f;
-        imageTransform.SetPosition(info.worldPosition + info.normal * (((float)splashCount * smallValue + 1e-4f)));
-
-        bee::ecs::SetParentChildRelationship(newImage, other, registry);
-
-        registry.emplace<PaintSplash>(newImage);
+        m_paint.Paint(registry, other, info.worldPosition, info.normal, bulletColor, m_paintRadius, randomAngle);
     }
 
-    if (m_destroyBulletOnHit) registry.destroy(bullet);
+    if (m_destroyBulletOnHit)
+    {
+        bee::Engine.Timers().Cancel(registry.get<Bullet>(bullet).expiry);
+        registry.destroy(bullet);
+    }
 }
 
-void Gameplay::UpdatePaintSplashes() {}
-
-void Gameplay::UpdateBullets(float dt)
+void Gameplay::OnBulletExpired(void*, uint64_t bullet)
 {
+    // already gone if the bullet was destroyed some other way, the entity version changed
     auto& registry = bee::Engine.Registry();
-    auto bulletView = bee::ecs::GetView<Bullet>(registry);
-    for (auto bullet : bulletView)
-    {
-        Bullet& bulletComponent = registry.get<Bullet>(bullet);
-        bulletComponent.lifetime -= dt;
-
-        if (bulletComponent.lifetime <= 0.0f)
-        {
-            registry.destroy(bullet);
-        }
-    }
+    const auto entity = static_cast<entt::entity>(bullet);
+    if (registry.valid(entity)) registry.destroy(entity);
 }
 
 void Gameplay::CheckCollisions()
 {
     Physics* physics = bee::Engine.GetAppLayer<Physics>();
+    auto& registry = bee::Engine.Registry();
 
-    auto bulletView = bee::ecs::GetView<Bullet>(bee::Engine.Registry());
-    auto colliderView = bee::ecs::GetView<BoxCollider>(bee::Engine.Registry());
-
-    for (auto bullet : bulletView)
+    // bullets are rigidbodies, so they are always the first entity of their contacts
+    for (const auto& contact : physics->GetContactEvents())
     {
-        for (auto collider : colliderView)
-        {
-            if (bullet == collider)
-            {
-                continue;
-            }
-            Physics::CollisionInfo info;
-            if (physics->HasCollided(bullet, collider, info))
-            {
-                OnBulletHit(bullet, collider, info);
-            }
-        }
+        if (contact.state == Physics::ContactState::End) continue;
+        if (!registry.valid(contact.entityA) || !registry.all_of<Bullet>(contact.entityA)) continue;
+
+        OnBulletHit(contact.entityA, contact.entityB, contact.info);
     }
 }
 
 
-
 /*
 Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
 */
\ No newline at end of file
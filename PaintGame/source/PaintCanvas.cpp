@@ -0,0 +1,226 @@
+#include "PaintCanvas.hpp"
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+PaintCanvas::PaintCanvas(int width, int height, const glm::u8vec4& color)
+    : m_width(width),
+      m_height(height),
+      m_tilesX((width + tileSize - 1) / tileSize),
+      m_tilesY((height + tileSize - 1) / tileSize),
+      m_pixels(static_cast<size_t>(width) * height, color),
+      m_tileDirty(static_cast<size_t>(m_tilesX) * m_tilesY, 0)
+{
+}
+
+void PaintCanvas::MarkDirty(int x0, int y0, int x1, int y1)
+{
+    x0 = std::max(x0, 0) / tileSize;
+    y0 = std::max(y0, 0) / tileSize;
+    x1 = std::min(x1, m_width - 1) / tileSize;
+    y1 = std::min(y1, m_height - 1) / tileSize;
+    for (int y = y0; y <= y1; y++)
+    {
+        for (int x = x0; x <= x1; x++)
+        {
+            const uint32_t tile = static_cast<uint32_t>(y * m_tilesX + x);
+            if (m_tileDirty[tile]) continue;
+            m_tileDirty[tile] = 1;
+            m_dirtyTiles.push_back(tile);
+        }
+    }
+}
+
+int PackAtlas(const std::vector<int>& sizes, int width, std::vector<AtlasCell>& cells)
+{
+    cells.assign(sizes.size(), AtlasCell());
+
+    std::vector<uint32_t> order(sizes.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sizes[a] > sizes[b]; });
+
+    int x = 0;
+    int y = 0;
+    int shelfHeight = 0;
+    for (uint32_t index : order)
+    {
+        const int size = sizes[index];
+        if (size > width) return 0;
+        if (x + size > width)
+        {
+            y += shelfHeight;
+            x = 0;
+            shelfHeight = 0;
+        }
+        cells[index] = {x, y, size};
+        x += size;
+        shelfHeight = std::max(shelfHeight, size);
+    }
+    return y + shelfHeight;
+}
+
+void GetCellUVs(const AtlasCell& cell, int atlasWidth, int atlasHeight, glm::vec2 uvs[3])
+{
+    const glm::vec2 atlasSize(static_cast<float>(atlasWidth), static_cast<float>(atlasHeight));
+    const glm::vec2 corner(static_cast<float>(cell.x) + 0.5f, static_cast<float>(cell.y) + 0.5f);
+    const float side = static_cast<float>(cell.size - 1);
+    uvs[0] = corner / atlasSize;
+    uvs[1] = (corner + glm::vec2(side, 0.0f)) / atlasSize;
+    uvs[2] = (corner + glm::vec2(0.0f, side)) / atlasSize;
+}
+
+namespace
+{
+// Walks the texels of the triangle in the cell, fn(x, y, s, t) gets the position on the triangle as the weights of the
+// second and third corner. One row of texels past the diagonal is included, nearest sampling along that edge reads it.
+template <typename Fn>
+void ForEachCellTexel(const AtlasCell& cell, int xMin, int xMax, int yMin, int yMax, Fn&& fn)
+{
+    const float step = 1.0f / static_cast<float>(cell.size - 1);
+    for (int y = yMin; y <= yMax; y++)
+    {
+        const float t = static_cast<float>(y) * step;
+        for (int x = xMin; x <= xMax; x++)
+        {
+            float s = static_cast<float>(x) * step;
+            if (s + t > 1.0f + step * 1.01f) break;
+
+            float clampedT = t;
+            if (s + t > 1.0f)
+            {
+                const float scale = 1.0f / (s + t);
+                s *= scale;
+                clampedT *= scale;
+            }
+            fn(cell.x + x, cell.y + y, s, clampedT);
+        }
+    }
+}
+}  // namespace
+
+int SplatTriangle(PaintCanvas& canvas,
+                  const AtlasCell& cell,
+                  const glm::vec3& a,
+                  const glm::vec3& b,
+                  const glm::vec3& c,
+                  const PaintBrush& brush)
+{
+    if (cell.size < 2) return 0;
+
+    const glm::vec3 edge1 = b - a;
+    const glm::vec3 edge2 = c - a;
+    if (glm::dot(glm::cross(edge1, edge2), brush.normal) <= 0.0f) return 0;
+
+    // weights of the brush center on the triangle plane, and how far the weights change over the radius,
+    // this limits the loop to the texels the brush can reach
+    const float e11 = glm::dot(edge1, edge1);
+    const float e12 = glm::dot(edge1, edge2);
+    const float e22 = glm::dot(edge2, edge2);
+    const float determinant = e11 * e22 - e12 * e12;
+    if (determinant <= 1e-12f) return 0;
+
+    const glm::vec3 toCenter = brush.center - a;
+    const float d1 = glm::dot(toCenter, edge1);
+    const float d2 = glm::dot(toCenter, edge2);
+    const float centerS = (e22 * d1 - e12 * d2) / determinant;
+    const float centerT = (e11 * d2 - e12 * d1) / determinant;
+    const float rangeS = brush.radius * glm::length(e22 * edge1 - e12 * edge2) / determinant;
+    const float rangeT = brush.radius * glm::length(e11 * edge2 - e12 * edge1) / determinant;
+
+    const float side = static_cast<float>(cell.size - 1);
+    const int xMin = std::max(0, static_cast<int>(std::floor((centerS - rangeS) * side)));
+    const int xMax = std::min(cell.size - 1, static_cast<int>(std::ceil((centerS + rangeS) * side)));
+    const int yMin = std::max(0, static_cast<int>(std::floor((centerT - rangeT) * side)));
+    const int yMax = std::min(cell.size - 1, static_cast<int>(std::ceil((centerT + rangeT) * side)));
+    if (xMin > xMax || yMin > yMax) return 0;
+
+    const glm::vec3 bitangent = glm::cross(brush.normal, brush.tangent);
+    const float inverseRadius = 1.0f / brush.radius;
+    const glm::vec3 color = glm::vec3(brush.color) * 255.0f;
+
+    int changed = 0;
+    glm::ivec2 changedMin(std::numeric_limits<int>::max());
+    glm::ivec2 changedMax(std::numeric_limits<int>::min());
+    ForEachCellTexel(cell,
+                     xMin,
+                     xMax,
+                     yMin,
+                     yMax,
+                     [&](int x, int y, float s, float t)
+                     {
+                         const glm::vec3 offset = a + edge1 * s + edge2 * t - brush.center;
+                         const float height = glm::dot(offset, brush.normal);
+                         if (std::abs(height) > brush.radius) return;
+
+                         const glm::vec3 planar = offset - brush.normal * height;
+                         const float u = glm::dot(planar, brush.tangent) * inverseRadius;
+                         const float v = glm::dot(planar, bitangent) * inverseRadius;
+
+                         float coverage;
+                         if (brush.mask)
+                         {
+                             if (std::abs(u) >= 1.0f || std::abs(v) >= 1.0f) return;
+                             const int maskX = static_cast<int>((u * 0.5f + 0.5f) * static_cast<float>(brush.maskWidth));
+                             const int maskY = static_cast<int>((v * 0.5f + 0.5f) * static_cast<float>(brush.maskHeight));
+                             coverage = static_cast<float>(brush.mask[maskY * brush.maskWidth + maskX]) / 255.0f;
+                         }
+                         else
+                         {
+                             const float distance = std::sqrt(u * u + v * v);
+                             coverage = std::clamp((1.0f - distance) * 4.0f, 0.0f, 1.0f);
+                         }
+
+                         const float weight = coverage * brush.color.a;
+                         if (weight <= 0.0f) return;
+
+                         glm::u8vec4& texel = canvas.At(x, y);
+                         const glm::vec3 blended = glm::mix(glm::vec3(texel), color, weight);
+                         texel = glm::u8vec4(glm::u8vec3(blended + 0.5f), texel.a);
+                         changed++;
+                         changedMin = glm::min(changedMin, glm::ivec2(x, y));
+                         changedMax = glm::max(changedMax, glm::ivec2(x, y));
+                     });
+
+    if (changed > 0) canvas.MarkDirty(changedMin.x, changedMin.y, changedMax.x, changedMax.y);
+    return changed;
+}
+
+void BakeTriangle(PaintCanvas& canvas,
+                  const AtlasCell& cell,
+                  const glm::vec2 uvs[3],
+                  const glm::u8vec4* texture,
+                  int textureWidth,
+                  int textureHeight)
+{
+    if (cell.size < 2) return;
+
+    const glm::vec2 edge1 = uvs[1] - uvs[0];
+    const glm::vec2 edge2 = uvs[2] - uvs[0];
+    ForEachCellTexel(cell,
+                     0,
+                     cell.size - 1,
+                     0,
+                     cell.size - 1,
+                     [&](int x, int y, float s, float t)
+                     {
+                         if (!texture)
+                         {
+                             canvas.At(x, y) = glm::u8vec4(255);
+                             return;
+                         }
+
+                         const glm::vec2 uv = uvs[0] + edge1 * s + edge2 * t;
+                         int textureX = static_cast<int>(std::floor(uv.x * static_cast<float>(textureWidth))) % textureWidth;
+                         int textureY = static_cast<int>(std::floor(uv.y * static_cast<float>(textureHeight))) % textureHeight;
+                         if (textureX < 0) textureX += textureWidth;
+                         if (textureY < 0) textureY += textureHeight;
+                         canvas.At(x, y) = texture[textureY * textureWidth + textureX];
+                     });
+    canvas.MarkDirty(cell.x, cell.y, cell.x + cell.size - 1, cell.y + cell.size - 1);
+}
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
@@ -0,0 +1,435 @@
+#include "PaintSystem.hpp"
+
+namespace
+{
+int RoundUpToTile(int value) { return (value + PaintCanvas::tileSize - 1) / PaintCanvas::tileSize * PaintCanvas::tileSize; }
+}  // namespace
+
+void PaintSystem::Prepare(entt::registry& registry)
+{
+    PROFILE_FUNCTION();
+    Clear(registry);
+
+    auto settings = registry.view<PaintSettings>();
+    m_settings = settings.empty() ? PaintSettings() : registry.get<PaintSettings>(settings.front());
+
+    // bullets only hit static colliders, the meshes of those and their children are what gets painted
+    std::vector<entt::entity> stack;
+    for (auto entity : registry.view<BoxCollider>(entt::exclude<Rigidbody>)) stack.push_back(entity);
+    size_t skipped = 0;
+    while (!stack.empty())
+    {
+        entt::entity entity = stack.back();
+        stack.pop_back();
+        if (const auto* node = registry.try_get<bee::HierarchyNode>(entity))
+            stack.insert(stack.end(), node->children.begin(), node->children.end());
+
+        // colliders can be children of other colliders
+        if (m_surfaces.find(entity) != m_surfaces.end()) continue;
+        const auto* renderable = registry.try_get<bee::Renderable>(entity);
+        if (!renderable || !renderable->visible || !renderable->mesh || !renderable->mesh->HasGeometry()) continue;
+
+        Surface surface;
+        if (CreateSurface(registry, entity, surface))
+            m_surfaces.emplace(entity, std::move(surface));
+        else
+            skipped++;
+    }
+
+    if (skipped > 0) bee::Log::Warn("{} meshes don't fit in the paint budget of the level", skipped);
+}
+
+bool PaintSystem::Paint(entt::registry& registry,
+                        entt::entity root,
+                        const glm::vec3& position,
+                        const glm::vec3& normal,
+                        const glm::vec3& color,
+                        float radius,
+                        float angle)
+{
+    PROFILE_FUNCTION();
+
+    PaintBrush brush;
+    brush.center = position;
+    brush.normal = glm::normalize(normal);
+    brush.radius = radius;
+    brush.color = glm::vec4(color, 1.0f);
+    if (!m_mask.empty())
+    {
+        brush.mask = m_mask.data();
+        brush.maskWidth = m_maskWidth;
+        brush.maskHeight = m_maskHeight;
+    }
+    const glm::vec3 reference = std::abs(brush.normal.y) < 0.99f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+    const glm::vec3 tangent = glm::normalize(glm::cross(reference, brush.normal));
+    brush.tangent = tangent * std::cos(angle) + glm::cross(brush.normal, tangent) * std::sin(angle);
+
+    bool painted = false;
+    std::vector<entt::entity> stack = {root};
+    while (!stack.empty())
+    {
+        entt::entity entity = stack.back();
+        stack.pop_back();
+        if (const auto* node = registry.try_get<bee::HierarchyNode>(entity))
+            stack.insert(stack.end(), node->children.begin(), node->children.end());
+
+        Surface* surface = GetSurface(registry, entity);
+        if (!surface) continue;
+
+        // bounds of the brush sphere in the space of the mesh, the triangles are splatted in world space
+        const glm::mat4 model = bee::GetWorldModel(entity, registry);
+        const glm::mat4 inverse = glm::inverse(model);
+        const glm::vec3 localCenter(inverse * glm::vec4(position, 1.0f));
+        const glm::mat3 rows = glm::transpose(glm::mat3(inverse));
+        const glm::vec3 localExtent = radius * glm::vec3(glm::length(rows[0]), glm::length(rows[1]), glm::length(rows[2]));
+
+        int changed = 0;
+        const bee::TriangleBVH* bvh = surface->originalMesh->GetTriangleBVH();
+        bvh->Query(bee::AABB(localCenter - localExtent, localCenter + localExtent),
+                   [&](uint32_t triangle)
+                   {
+                       glm::vec3 a, b, c;
+                       bvh->GetTriangle(triangle, a, b, c);
+                       changed += SplatTriangle(surface->canvas,
+                                                surface->cells[triangle],
+                                                glm::vec3(model * glm::vec4(a, 1.0f)),
+                                                glm::vec3(model * glm::vec4(b, 1.0f)),
+                                                glm::vec3(model * glm::vec4(c, 1.0f)),
+                                                brush);
+                   });
+
+        if (changed > 0)
+        {
+            surface->lastPainted = ++m_paintCount;
+            painted = true;
+        }
+    }
+    return painted;
+}
+
+void PaintSystem::SetBrushMask(const bee::resource::Texture& texture)
+{
+    std::vector<unsigned char> pixels;
+    if (!xsr::read_texture(texture.GetHandle(), pixels, m_maskWidth, m_maskHeight))
+    {
+        m_mask.clear();
+        return;
+    }
+
+    m_mask.resize(static_cast<size_t>(m_maskWidth) * m_maskHeight);
+    for (size_t i = 0; i < m_mask.size(); i++) m_mask[i] = pixels[i * 4 + 3];
+}
+
+void PaintSystem::Upload(entt::registry& registry)
+{
+    PROFILE_FUNCTION();
+    m_uploadedTiles = 0;
+    for (auto it = m_surfaces.begin(); it != m_surfaces.end();)
+    {
+        if (!registry.valid(it->first))
+        {
+            m_usedBytes -= it->second.bytes;
+            it = m_surfaces.erase(it);
+            continue;
+        }
+
+        Surface& surface = it->second;
+        const xsr::texture_handle handle = surface.paintTexture->GetHandle();
+        surface.canvas.FlushDirtyTiles(
+            [&](int x, int y, int width, int height)
+            {
+                xsr::update_texture(handle, x, y, width, height, &surface.canvas.At(x, y), surface.canvas.Width());
+                m_uploadedTiles++;
+            });
+        ++it;
+    }
+    bee::profiler::SetCounter("Paint tiles uploaded", static_cast<float>(m_uploadedTiles));
+}
+
+void PaintSystem::Clear(entt::registry& registry)
+{
+    for (auto& [entity, surface] : m_surfaces) RestoreSurface(registry, entity, surface);
+    m_surfaces.clear();
+    m_texturePixels.clear();
+    m_usedBytes = 0;
+}
+
+void PaintSystem::OnImGuiRender(entt::registry& registry)
+{
+    constexpr float megabyte = 1024.0f * 1024.0f;
+    ImGui::Text("Painted Meshes: %d", static_cast<int>(m_surfaces.size()));
+    ImGui::Text("Paint Memory: %.1f / %.1f MB",
+                static_cast<float>(m_usedBytes) / megabyte,
+                static_cast<float>(Budget()) / megabyte);
+    ImGui::Text("Paint Tiles Uploaded: %d", static_cast<int>(m_uploadedTiles));
+    ImGui::Text("Paint Atlases Evicted: %d", static_cast<int>(m_evictions));
+
+    // lowering the budget of the running level gives the least recently painted meshes their original look back
+    if (ImGui::SliderInt("Paint Budget (MB)", &m_settings.budgetMegabytes, 8, 512))
+    {
+        while (m_usedBytes > Budget() && EvictLeastRecentlyPainted(registry))
+        {
+        }
+    }
+}
+
+PaintSystem::Surface* PaintSystem::GetSurface(entt::registry& registry, entt::entity entity)
+{
+    const auto* renderable = registry.try_get<bee::Renderable>(entity);
+    if (!renderable || !renderable->visible || !renderable->mesh) return nullptr;
+
+    auto it = m_surfaces.find(entity);
+    if (it == m_surfaces.end()) return nullptr;
+    if (renderable->mesh == it->second.paintMesh) return &it->second;
+
+    // the mesh was replaced since the level was prepared
+    m_usedBytes -= it->second.bytes;
+    m_surfaces.erase(it);
+    return nullptr;
+}
+
+bool PaintSystem::CreateSurface(entt::registry& registry, entt::entity entity, Surface& surface)
+{
+    PROFILE_FUNCTION();
+    auto& renderable = registry.get<bee::Renderable>(entity);
+    const bee::TriangleBVH* bvh = renderable.mesh->GetTriangleBVH();
+    if (!bvh || bvh->Empty()) return false;
+
+    // the cell maps the two edges from the first corner onto its sides, the longest one decides the size
+    const glm::mat4 model = bee::GetWorldModel(entity, registry);
+    const uint32_t triangleCount = static_cast<uint32_t>(bvh->TriangleCount());
+    std::vector<float> edgeLengths(triangleCount);
+    for (uint32_t i = 0; i < triangleCount; i++)
+    {
+        glm::vec3 a, b, c;
+        bvh->GetTriangle(i, a, b, c);
+        const glm::vec3 worldA(model * glm::vec4(a, 1.0f));
+        edgeLengths[i] = std::max(glm::length(glm::vec3(model * glm::vec4(b, 1.0f)) - worldA),
+                                  glm::length(glm::vec3(model * glm::vec4(c, 1.0f)) - worldA));
+    }
+
+    // lower the density until the atlas fits in what is left of the budget
+    const size_t available = Budget() > m_usedBytes ? Budget() - m_usedBytes : 0;
+    float density = m_settings.texelsPerUnit;
+    std::vector<int> sizes(triangleCount);
+    int width = 0;
+    int height = 0;
+    while (true)
+    {
+        size_t area = 0;
+        int largest = 2;
+        for (uint32_t i = 0; i < triangleCount; i++)
+        {
+            sizes[i] = std::clamp(static_cast<int>(std::ceil(edgeLengths[i] * density)) + 1, 2, maxCellSize);
+            area += static_cast<size_t>(sizes[i]) * static_cast<size_t>(sizes[i]);
+            largest = std::max(largest, sizes[i]);
+        }
+
+        width = RoundUpToTile(std::max(largest, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(area) * 1.1)))));
+        height = RoundUpToTile(PackAtlas(sizes, width, surface.cells));
+        surface.bytes = static_cast<size_t>(width) * static_cast<size_t>(height) * sizeof(glm::u8vec4) * 2;
+        if (width <= maxAtlasSize && height <= maxAtlasSize && surface.bytes <= available) break;
+
+        density *= 0.75f;
+        if (density < minTexelsPerUnit) return false;
+    }
+
+    // unwelded copy of the mesh with the atlas as texture coordinates, baked from the original texture
+    const TexturePixels* source = nullptr;
+    if (renderable.texture && renderable.texture->IsValid()) source = &GetTexturePixels(*renderable.texture);
+
+    surface.canvas = PaintCanvas(width, height, glm::u8vec4(255));
+    std::vector<glm::vec3> positions(triangleCount * 3);
+    std::vector<glm::vec3> normals(triangleCount * 3);
+    std::vector<glm::vec2> uvs(triangleCount * 3);
+    std::vector<uint32_t> indices(triangleCount * 3);
+    for (uint32_t i = 0; i < triangleCount; i++)
+    {
+        bvh->GetTriangle(i, positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]);
+        std::copy_n(bvh->GetNormals(i), 3, &normals[i * 3]);
+        GetCellUVs(surface.cells[i], width, height, &uvs[i * 3]);
+        for (uint32_t corner = 0; corner < 3; corner++) indices[i * 3 + corner] = i * 3 + corner;
+
+        if (source && !source->pixels.empty())
+            BakeTriangle(surface.canvas,
+                         surface.cells[i],
+                         bvh->GetUVs(i),
+                         reinterpret_cast<const glm::u8vec4*>(source->pixels.data()),
+                         source->width,
+                         source->height);
+    }
+    // the whole atlas is uploaded when the texture is created
+    surface.canvas.FlushDirtyTiles([](int, int, int, int) {});
+
+    surface.paintTexture = std::make_shared<bee::resource::Texture>();
+    surface.paintTexture->GetHandle() = xsr::create_texture(width, height, surface.canvas.Pixels());
+    surface.paintTexture->GetHandle().width = width;
+    surface.paintTexture->GetHandle().height = height;
+
+    surface.paintMesh = std::make_shared<bee::resource::Mesh>();
+    surface.paintMesh->GetHandle() = xsr::create_mesh(indices.data(),
+                                                      static_cast<unsigned int>(indices.size()),
+                                                      glm::value_ptr(positions[0]),
+                                                      glm::value_ptr(normals[0]),
+                                                      glm::value_ptr(uvs[0]),
+                                                      nullptr,
+                                                      static_cast<unsigned int>(positions.size()));
+    // keeps bullets hitting the real surface once the mesh is painted
+    surface.paintMesh->SetGeometry(std::move(positions), std::move(normals), std::move(uvs), std::move(indices));
+
+    surface.originalMesh = renderable.mesh;
+    surface.originalTexture = renderable.texture;
+    renderable.mesh = surface.paintMesh;
+    renderable.texture = surface.paintTexture;
+    m_usedBytes += surface.bytes;
+    return true;
+}
+
+void PaintSystem::RestoreSurface(entt::registry& registry, entt::entity entity, Surface& surface)
+{
+    if (!registry.valid(entity)) return;
+
+    auto* renderable = registry.try_get<bee::Renderable>(entity);
+    if (!renderable || renderable->mesh != surface.paintMesh) return;
+    renderable->mesh = surface.originalMesh;
+    renderable->texture = surface.originalTexture;
+}
+
+bool PaintSystem::EvictLeastRecentlyPainted(entt::registry& registry)
+{
+    if (m_surfaces.empty()) return false;
+
+    auto oldest = std::min_element(m_surfaces.begin(),
+                                   m_surfaces.end(),
+                                   [](const auto& a, const auto& b) { return a.second.lastPainted < b.second.lastPainted; });
+    RestoreSurface(registry, oldest->first, oldest->second);
+    m_usedBytes -= oldest->second.bytes;
+    m_surfaces.erase(oldest);
+    m_evictions++;
+    return true;
+}
+
+const PaintSystem::TexturePixels& PaintSystem::GetTexturePixels(const bee::resource::Texture& texture)
+{
+    auto [it, inserted] = m_texturePixels.try_emplace(texture.GetHandle().id);
+    if (inserted) xsr::read_texture(texture.GetHandle(), it->second.pixels, it->second.width, it->second.height);
+    return it->second;
+}
+
+std::vector<bee::benchmark::Result> BenchmarkPaintCanvas()
+{
+    const glm::u8vec4 white(255);
+    size_t wrong = 0;
+
+    // Bake a 4x4 texture into a 9 texel cell with uvs over the whole texture. Texel (x, y) of the cell lies at
+    // (x / 8, y / 8) on the triangle, the row past the diagonal is pulled back onto it. Everything else stays white.
+    {
+        glm::u8vec4 texture[16];
+        for (int i = 0; i < 16; i++) texture[i] = glm::u8vec4(i % 4 * 60, i / 4 * 60, 7, 255);
+        const glm::vec2 uvs[3] = {glm::vec2(0.0f), glm::vec2(1.0f, 0.0f), glm::vec2(0.0f, 1.0f)};
+        const AtlasCell cell = {2, 3, 9};
+
+        PaintCanvas canvas(16, 16, white);
+        BakeTriangle(canvas, cell, uvs, texture, 4, 4);
+        for (int y = 0; y < canvas.Height(); y++)
+        {
+            for (int x = 0; x < canvas.Width(); x++)
+            {
+                const int cellX = x - cell.x;
+                const int cellY = y - cell.y;
+                glm::u8vec4 expected = white;
+                if (cellX >= 0 && cellY >= 0 && cellX < cell.size && cellY < cell.size && cellX + cellY <= 9)
+                {
+                    const int scale = std::max(8, cellX + cellY);
+                    expected = texture[(4 * cellY / scale % 4) * 4 + 4 * cellX / scale % 4];
+                }
+                if (canvas.At(x, y) != expected) wrong++;
+            }
+        }
+        if (canvas.DirtyTileCount() != 1) wrong++;
+    }
+
+    // Splat a red disc on the corner of a unit triangle. Texels within three quarters of the radius are fully red,
+    // the edge fades out over the last quarter and texels past the radius keep their color.
+    {
+        PaintBrush brush;
+        brush.center = glm::vec3(0.0f);
+        brush.normal = glm::vec3(0.0f, 0.0f, 1.0f);
+        brush.radius = 0.5f;
+        brush.color = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+        const AtlasCell cell = {0, 0, 17};
+        const glm::vec3 a(0.0f), b(1.0f, 0.0f, 0.0f), c(0.0f, 1.0f, 0.0f);
+
+        PaintCanvas canvas(32, 32, white);
+        const int changed = SplatTriangle(canvas, cell, a, b, c, brush);
+        int expectedChanged = 0;
+        for (int y = 0; y < canvas.Height(); y++)
+        {
+            for (int x = 0; x < canvas.Width(); x++)
+            {
+                const float distance = std::sqrt(static_cast<float>(x * x + y * y)) / 16.0f / brush.radius;
+                const glm::u8vec4& texel = canvas.At(x, y);
+                if (x + y > 17 || distance >= 1.0f)
+                {
+                    if (texel != white) wrong++;
+                    continue;
+                }
+
+                expectedChanged++;
+                const int green = static_cast<int>(255.0f * (1.0f - std::clamp((1.0f - distance) * 4.0f, 0.0f, 1.0f)) + 0.5f);
+                if (texel.r != 255 || std::abs(texel.g - green) > 1 || texel.b != texel.g || texel.a != 255) wrong++;
+            }
+        }
+        if (std::abs(changed - expectedChanged) > 2) wrong++;
+
+        // the back of the triangle doesn't get paint
+        brush.normal = -brush.normal;
+        if (SplatTriangle(canvas, cell, a, b, c, brush) != 0) wrong++;
+    }
+
+    if (wrong > 0)
+        bee::benchmark::Fail("Paint rasterizer gives {} wrong texels", wrong);
+    else
+        bee::Log::Info("Paint rasterizer matches the known triangles");
+
+    // one large cell, the brush covers about a quarter of the triangle
+    std::vector<bee::benchmark::Result> results;
+    constexpr int iterations = 1000;
+    const AtlasCell cell = {0, 0, 128};
+    const glm::vec3 a(0.0f), b(4.0f, 0.0f, 0.0f), c(0.0f, 4.0f, 0.0f);
+    PaintCanvas canvas(128, 128, white);
+
+    PaintBrush brush;
+    brush.center = glm::vec3(1.0f, 1.0f, 0.0f);
+    brush.normal = glm::vec3(0.0f, 0.0f, 1.0f);
+    brush.radius = 1.0f;
+    brush.color = glm::vec4(0.2f, 0.6f, 1.0f, 0.5f);
+    results.push_back(bee::benchmark::Measure("SplatTriangle, 128 texel cell",
+                                              iterations,
+                                              [&]()
+                                              {
+                                                  for (int i = 0; i < iterations; i++)
+                                                      SplatTriangle(canvas, cell, a, b, c, brush);
+                                                  canvas.FlushDirtyTiles([](int, int, int, int) {});
+                                              }));
+
+    std::vector<glm::u8vec4> texture(256 * 256);
+    for (size_t i = 0; i < texture.size(); i++) texture[i] = glm::u8vec4(i % 256, i / 256, 0, 255);
+    const glm::vec2 uvs[3] = {glm::vec2(0.0f), glm::vec2(2.0f, 0.0f), glm::vec2(0.0f, 2.0f)};
+    results.push_back(bee::benchmark::Measure("BakeTriangle, 128 texel cell",
+                                              iterations,
+                                              [&]()
+                                              {
+                                                  for (int i = 0; i < iterations; i++)
+                                                      BakeTriangle(canvas, cell, uvs, texture.data(), 256, 256);
+                                                  canvas.FlushDirtyTiles([](int, int, int, int) {});
+                                              }));
+    bee::benchmark::DoNotOptimize(canvas.Pixels());
+    return results;
+}
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
@@ -1,12 +1,28 @@
 #include "Physics.hpp"
 #include "Components.hpp"
+#include <cstring>
 
 // 95% of this code has been written by ChatGPT.
 // Full conversation can be found: https://chatgpt.com/share/6712479f-b758-8011-98fe-bb8753649053
 
 void Physics::OnAttach() {}
 
-void Physics::OnDetach() {}
+void Physics::OnDetach() { Reset(); }
+
+void Physics::Reset()
+{
+    m_staticTree.Clear();
+    m_dynamicTree.Clear();
+    m_proxies.clear();
+    entityOBBs.clear();
+    m_islandBodies.clear();
+    m_islandOffsets.clear();
+    m_contacts.clear();
+    m_previousContacts.clear();
+    m_contactEvents.clear();
+    m_restingContacts.clear();
+    m_entityContacts.clear();
+}
 
 void Physics::OnRender()
 {
@@ -20,7 +36,7 @@ void Physics::OnRender()
     // Loop through all OBBs and draw them
     for (const auto& pair : entityOBBs)
     {
-        const OBB& obb = pair.second;
+        const OBB& obb = pair.second.obb;
 
         // Compute the 8 corners of the OBB
         glm::vec3 corners[8];
@@ -67,11 +83,46 @@ void Physics::OnRender()
             bee::DebugRenderer::DrawLine(start, end, color);
         }
     }
+
+    if (m_drawBroadphase)
+    {
+        auto DrawTree = [](const bee::AABBTree& tree, const glm::vec4& color)
+        {
+            tree.ForEachNode(
+                [&](int node)
+                {
+                    const bee::AABB& aabb = tree.GetFatAABB(node);
+                    bee::DebugRenderer::DrawBox(aabb.Center(), aabb.max - aabb.min, color);
+                });
+        };
+        DrawTree(m_staticTree, glm::vec4(0.2f, 0.4f, 1.0f, 1.0f));
+        DrawTree(m_dynamicTree, glm::vec4(1.0f, 0.5f, 0.0f, 1.0f));
+    }
 }
 
 void Physics::OnEngineInit() {
     bee::ComponentManager::RegisterComponentNoDraw<Rigidbody>("Rigidbody", true, true);
     bee::ComponentManager::RegisterComponent<BoxCollider, DrawBoxCollider>("BoxCollider", true, true);
+    bee::benchmark::Register("Physics", [this]() { return BenchmarkStep(); });
+    bee::ecs::RegisterStressSceneDecorator(&Physics::DecorateStressScene, this);
+}
+
+void Physics::DecorateStressScene(entt::registry& registry, entt::entity entity, bee::Random& random, void* context)
+{
+    const Physics& physics = *static_cast<const Physics*>(context);
+    // both drawn for every entity, so the fractions don't change the rest of the scene
+    const float collider = random.Float();
+    const float rigidbody = random.Float();
+    if (!registry.all_of<bee::Renderable>(entity) || collider >= physics.m_stressColliderFraction) return;
+
+    registry.emplace<BoxCollider>(entity);
+    if (registry.get<bee::HierarchyNode>(entity).parent != entt::null || rigidbody >= physics.m_stressRigidbodyFraction)
+        return;
+
+    auto& rb = registry.emplace<Rigidbody>(entity);
+    rb.velocity = glm::vec3(0.0f);
+    rb.acceleration = glm::vec3(0.0f);
+    rb.previousPosition = registry.get<bee::Transform>(entity).GetPosition();
 }
 
 void Physics::OnImGuiRender()
@@ -79,6 +130,35 @@ void Physics::OnImGuiRender()
     ImGui::Begin("Physics");
     ImGui::SliderFloat("Gravity", &m_gravity, -20.0f, 20.0f);
     ImGui::SliderFloat("Reflection Coefficient", &m_reflectionCoefficient, 0.0f, 1.0f);
+
+    ImGui::Separator();
+    ImGui::Text("Broadphase");
+    ImGui::Checkbox("Draw Broadphase", &m_drawBroadphase);
+    ImGui::Text("Static: %zu proxies, height %d", m_staticTree.ProxyCount(), m_staticTree.Height());
+    ImGui::Text("Dynamic: %zu proxies, height %d", m_dynamicTree.ProxyCount(), m_dynamicTree.Height());
+    ImGui::Text("Candidate pairs: %zu, sweep candidates: %zu", m_candidatePairs.size(), m_sweepCandidates);
+    ImGui::Text("Reinserts: %zu static, %zu dynamic", m_staticTree.ReinsertCount(), m_dynamicTree.ReinsertCount());
+    ImGui::Text("Contact events: %zu", m_contactEvents.size());
+    ImGui::Text("Threads: %d of %d", bee::Engine.Jobs().GetMaxThreads(), bee::Engine.Jobs().ThreadCount());
+    ImGui::Text("OBB cache: %zu hits, %zu rebuilt", m_obbCacheHits, m_obbCacheMisses);
+
+    ImGui::Separator();
+    ImGui::Text("Sleeping");
+    ImGui::Checkbox("Allow Sleeping", &m_allowSleeping);
+    ImGui::SliderFloat("Sleep Velocity", &m_sleepVelocity, 0.0f, 2.0f);
+    ImGui::SliderInt("Sleep Steps", &m_sleepSteps, 1, 240);
+    const size_t islands = m_islandOffsets.empty() ? 0 : m_islandOffsets.size() - 1;
+    ImGui::Text("Bodies: %zu awake, %zu sleeping, %zu islands",
+                m_islandBodies.size() - m_sleepingBodies,
+                m_sleepingBodies,
+                islands);
+    ImGui::Text("Last step: %zu fell asleep, %zu woke up", m_fellAsleep, m_wokeUp);
+    ImGui::Text("Total: %zu fell asleep, %zu woke up", m_totalSleeps, m_totalWakes);
+
+    ImGui::Separator();
+    ImGui::Text("Stress Scene");
+    ImGui::SliderFloat("Box Colliders", &m_stressColliderFraction, 0.0f, 1.0f, "%.3f");
+    ImGui::SliderFloat("Rigidbodies", &m_stressRigidbodyFraction, 0.0f, 1.0f, "%.3f");
     ImGui::End();
 }
 
@@ -86,23 +166,60 @@ void Physics::OnUpdate(float) {}
 
 void Physics::OnFixedUpdate(float deltaTime)
 {
-    m_collisions.clear();
+    m_contacts.clear();
+    m_fellAsleep = 0;
+    m_wokeUp = 0;
+    GatherBodies();
+    WakeSleepingBodies();
     UpdatePositions(deltaTime);
     CheckCollisions();
+    UpdateIslands();
+    PublishContactEvents();
 }
 
-bool Physics::HasCollided(entt::entity entityA, entt::entity entityB, CollisionInfo& info) const
+void Physics::GatherBodies()
 {
-    auto it = m_collisions.find(std::make_pair(entityA, entityB));
-    if (it != m_collisions.end())
+    auto view = bee::ecs::GetView<Rigidbody, bee::Transform>(bee::Engine.Registry());
+    m_bodies.clear();
+    for (auto entity : view) m_bodies.push_back(entity);
+}
+
+void Physics::PrepareChunks(size_t count)
+{
+    if (m_chunks.size() < count) m_chunks.resize(count);
+    for (size_t i = 0; i < count; i++)
     {
-        info = it->second;
-        return true;
+        m_chunks[i].pairs.clear();
+        m_chunks[i].contacts.clear();
+        m_chunks[i].sweepCandidates = 0;
     }
-    return false;
 }
 
-void Physics::UpdatePositions(float deltaTime)
+void Physics::WakeUp(entt::entity entity)
+{
+    if (auto* rigidbody = bee::Engine.Registry().try_get<Rigidbody>(entity); rigidbody && rigidbody->sleeping)
+        WakeIsland(rigidbody->island);
+}
+
+void Physics::WakeIsland(uint32_t island)
+{
+    if (island + 1 >= m_islandOffsets.size()) return;
+
+    auto& registry = bee::Engine.Registry();
+    for (uint32_t i = m_islandOffsets[island]; i < m_islandOffsets[island + 1]; i++)
+    {
+        if (!registry.valid(m_islandBodies[i])) continue;
+        auto* rigidbody = registry.try_get<Rigidbody>(m_islandBodies[i]);
+        if (!rigidbody || !rigidbody->sleeping) continue;
+
+        rigidbody->sleeping = false;
+        rigidbody->lowVelocitySteps = 0;
+        m_wokeUp++;
+        m_totalWakes++;
+    }
+}
+
+void Physics::WakeSleepingBodies()
 {
     auto& registry = bee::Engine.Registry();
 
@@ -110,13 +227,257 @@ void Physics::UpdatePositions(float deltaTime)
     for (auto entity : view)
     {
         auto& rb = view.get<Rigidbody>(entity);
-        auto& transform = view.get<bee::Transform>(entity);
+        if (!rb.sleeping) continue;
+
+        // moved or pushed from outside the physics step
+        bool wake = glm::length2(rb.velocity) > m_sleepVelocity * m_sleepVelocity ||
+                    view.get<bee::Transform>(entity).GetVersion() != rb.sleepVersion;
+
+        // the collider it rests on moved or got destroyed
+        ForEachRestingContact(entity,
+                              [&](const ContactEvent& contact)
+                              {
+                                  if (wake) return;
+                                  const entt::entity other = contact.entityB;
+                                  if (!registry.valid(other))
+                                  {
+                                      wake = true;
+                                      return;
+                                  }
+                                  auto it = entityOBBs.find(other);
+                                  if (it != entityOBBs.end() &&
+                                      bee::GetWorldVersion(other, registry) != it->second.worldVersion)
+                                      wake = true;
+                              });
+
+        if (wake) WakeIsland(rb.island);
+    }
+}
+
+void Physics::UpdateIslands()
+{
+    auto& registry = bee::Engine.Registry();
+
+    auto view = bee::ecs::GetView<Rigidbody, bee::Transform>(registry);
+    m_bodyIndices.clear();
+    for (uint32_t i = 0; i < static_cast<uint32_t>(m_bodies.size()); i++) m_bodyIndices[m_bodies[i]] = i;
 
-        rb.previousPosition = transform.GetPosition();
-        rb.acceleration.y = m_gravity;
-        rb.velocity += rb.acceleration * deltaTime;
-        transform.SetPosition(transform.GetPosition() + rb.velocity * deltaTime);
+    // bodies that touch end up in the same island
+    m_bodyParents.resize(m_bodies.size());
+    std::iota(m_bodyParents.begin(), m_bodyParents.end(), 0u);
+    auto Find = [&](uint32_t body)
+    {
+        while (m_bodyParents[body] != body)
+        {
+            m_bodyParents[body] = m_bodyParents[m_bodyParents[body]];
+            body = m_bodyParents[body];
+        }
+        return body;
+    };
+
+    // contacts from the sweep are always with a static collider, bodies only touch each other in the dynamic tree
+    const size_t bodyChunks = bee::JobSystem::ChunkCount(m_bodies.size(), bodiesPerChunk);
+    PrepareChunks(bodyChunks);
+    bee::Engine.Jobs().ParallelFor(m_bodies.size(),
+                                   bodiesPerChunk,
+                                   [&](size_t begin, size_t end, size_t chunk)
+                                   {
+                                       for (size_t body = begin; body < end; body++)
+                                           QueryBodyTouches(body, m_chunks[chunk]);
+                                   });
+
+    for (size_t chunk = 0; chunk < bodyChunks; chunk++)
+    {
+        for (const auto& [entityA, entityB] : m_chunks[chunk].pairs)
+        {
+            // the smaller index becomes the root so the islands don't depend on the pair order
+            const uint32_t rootA = Find(m_bodyIndices.find(entityA)->second);
+            const uint32_t rootB = Find(m_bodyIndices.find(entityB)->second);
+            if (rootA != rootB) m_bodyParents[std::max(rootA, rootB)] = std::min(rootA, rootB);
+        }
+    }
+
+    // island numbers follow the view order of the first body in each island
+    constexpr uint32_t noIsland = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> rootIslands(m_bodies.size(), noIsland);
+    std::vector<uint32_t> bodyIslands(m_bodies.size());
+    uint32_t islandCount = 0;
+    for (uint32_t i = 0; i < static_cast<uint32_t>(m_bodies.size()); i++)
+    {
+        const uint32_t root = Find(i);
+        if (rootIslands[root] == noIsland) rootIslands[root] = islandCount++;
+        bodyIslands[i] = rootIslands[root];
+    }
+
+    m_islandOffsets.assign(islandCount + 1, 0);
+    for (uint32_t island : bodyIslands) m_islandOffsets[island + 1]++;
+    for (uint32_t island = 0; island < islandCount; island++) m_islandOffsets[island + 1] += m_islandOffsets[island];
+
+    struct IslandState
+    {
+        bool canSleep = true;
+        bool hasSleeping = false;
+        bool hasAwake = false;
+    };
+    std::vector<IslandState> islands(islandCount);
+    std::vector<uint32_t> fill(m_islandOffsets.begin(), m_islandOffsets.end() - 1);
+    m_islandBodies.resize(m_bodies.size());
+
+    const float sleepVelocity2 = m_sleepVelocity * m_sleepVelocity;
+    const uint32_t sleepSteps = static_cast<uint32_t>(m_sleepSteps);
+    for (uint32_t i = 0; i < static_cast<uint32_t>(m_bodies.size()); i++)
+    {
+        auto& rb = view.get<Rigidbody>(m_bodies[i]);
+        const uint32_t island = bodyIslands[i];
+        rb.island = island;
+        m_islandBodies[fill[island]++] = m_bodies[i];
+
+        IslandState& state = islands[island];
+        if (rb.sleeping)
+        {
+            state.hasSleeping = true;
+            continue;
+        }
+
+        state.hasAwake = true;
+        if (glm::length2(rb.velocity) < sleepVelocity2)
+            rb.lowVelocitySteps = std::min(rb.lowVelocitySteps + 1, sleepSteps);
+        else
+            rb.lowVelocitySteps = 0;
+        if (rb.lowVelocitySteps < sleepSteps) state.canSleep = false;
+    }
+
+    // an island sleeps as a whole, one body that is still moving keeps the bodies it touches awake
+    for (uint32_t island = 0; island < islandCount; island++)
+    {
+        const IslandState& state = islands[island];
+        if (!m_allowSleeping || !state.canSleep)
+        {
+            if (state.hasSleeping) WakeIsland(island);
+            continue;
+        }
+        if (!state.hasAwake) continue;
+
+        for (uint32_t i = m_islandOffsets[island]; i < m_islandOffsets[island + 1]; i++)
+        {
+            auto& rb = view.get<Rigidbody>(m_islandBodies[i]);
+            if (rb.sleeping) continue;
+
+            auto& transform = view.get<bee::Transform>(m_islandBodies[i]);
+            rb.sleeping = true;
+            rb.velocity = glm::vec3(0.0f);
+            rb.previousPosition = transform.GetPosition();
+            rb.sleepVersion = transform.GetVersion();
+            m_fellAsleep++;
+            m_totalSleeps++;
+        }
+    }
+
+    m_sleepingBodies = 0;
+    for (auto entity : m_islandBodies)
+    {
+        if (view.get<Rigidbody>(entity).sleeping) m_sleepingBodies++;
     }
+    bee::profiler::SetCounter("Physics sleeping bodies", static_cast<float>(m_sleepingBodies));
+    bee::profiler::SetCounter("Physics awake bodies", static_cast<float>(m_islandBodies.size() - m_sleepingBodies));
+    bee::profiler::SetCounter("Physics islands", static_cast<float>(islandCount));
+}
+
+void Physics::PublishContactEvents()
+{
+    auto PairKey = [](const ContactEvent& contact)
+    { return (static_cast<uint64_t>(contact.entityA) << 32) | static_cast<uint64_t>(contact.entityB); };
+    auto ByPair = [&](const ContactEvent& a, const ContactEvent& b) { return PairKey(a) < PairKey(b); };
+
+    // a pair can be hit more than once in a step, the last hit wins
+    std::stable_sort(m_contacts.begin(), m_contacts.end(), ByPair);
+    size_t unique = 0;
+    for (size_t i = 0; i < m_contacts.size(); i++)
+    {
+        if (unique > 0 && PairKey(m_contacts[unique - 1]) == PairKey(m_contacts[i]))
+            m_contacts[unique - 1] = m_contacts[i];
+        else
+            m_contacts[unique++] = m_contacts[i];
+    }
+    m_contacts.resize(unique);
+
+    // merge with last step to find out which contacts began, stayed or ended
+    m_contactEvents.clear();
+    m_restingContacts.clear();
+    auto& registry = bee::Engine.Registry();
+    size_t current = 0;
+    size_t previous = 0;
+    while (current < m_contacts.size() || previous < m_previousContacts.size())
+    {
+        if (previous == m_previousContacts.size() ||
+            (current < m_contacts.size() && ByPair(m_contacts[current], m_previousContacts[previous])))
+        {
+            m_contactEvents.push_back(m_contacts[current++]);
+            m_contactEvents.back().state = ContactState::Begin;
+        }
+        else if (current == m_contacts.size() || ByPair(m_previousContacts[previous], m_contacts[current]))
+        {
+            m_contactEvents.push_back(m_previousContacts[previous++]);
+            m_contactEvents.back().state = ContactState::End;
+        }
+        else
+        {
+            // a body that sleeps keeps its contacts without reporting them again every step
+            const auto* rigidbody = registry.try_get<Rigidbody>(m_contacts[current].entityA);
+            auto& events = rigidbody && rigidbody->sleeping ? m_restingContacts : m_contactEvents;
+            events.push_back(m_contacts[current++]);
+            events.back().state = ContactState::Stay;
+            previous++;
+        }
+    }
+    std::swap(m_previousContacts, m_contacts);
+
+    // per entity contact lists, counted first so they can share one index buffer
+    m_entityContacts.clear();
+    for (const auto& contact : m_contactEvents)
+    {
+        m_entityContacts[contact.entityA].second++;
+        m_entityContacts[contact.entityB].second++;
+    }
+
+    uint32_t offset = 0;
+    for (auto& [entity, range] : m_entityContacts)
+    {
+        range.first = offset;
+        offset += range.second;
+        range.second = 0;
+    }
+
+    m_contactIndices.resize(offset);
+    for (uint32_t i = 0; i < static_cast<uint32_t>(m_contactEvents.size()); i++)
+    {
+        for (entt::entity entity : {m_contactEvents[i].entityA, m_contactEvents[i].entityB})
+        {
+            auto& range = m_entityContacts[entity];
+            m_contactIndices[range.first + range.second++] = i;
+        }
+    }
+}
+
+void Physics::UpdatePositions(float deltaTime)
+{
+    auto view = bee::ecs::GetView<Rigidbody, bee::Transform>(bee::Engine.Registry());
+    bee::Engine.Jobs().ParallelFor(m_bodies.size(),
+                                   bodiesPerChunk,
+                                   [&](size_t begin, size_t end, size_t)
+                                   {
+                                       for (size_t i = begin; i < end; i++)
+                                       {
+                                           auto& rb = view.get<Rigidbody>(m_bodies[i]);
+                                           auto& transform = view.get<bee::Transform>(m_bodies[i]);
+                                           if (rb.sleeping) continue;
+
+                                           rb.previousPosition = transform.GetPosition();
+                                           rb.acceleration.y = m_gravity;
+                                           rb.velocity += rb.acceleration * deltaTime;
+                                           transform.SetPosition(transform.GetPosition() + rb.velocity * deltaTime);
+                                       }
+                                   });
 }
 
 // Function written by ChatGPT
@@ -139,412 +500,655 @@ void Physics::CheckCollisions()
 
     // Get all entities with box colliders and transforms
     auto view = bee::ecs::GetView<BoxCollider, bee::Transform>(bee::Engine.Registry());
-    // Clear and populate the entityOBBs map
-    entityOBBs.clear();
 
-    // Extract OBB data for all entities
+    m_stamp++;
+    m_obbCacheHits = 0;
+    m_obbCacheMisses = 0;
+    uint32_t order = 0;
+
+    // Extract OBB data for all entities, colliders that didn't move keep their box from the last step.
+    // This stays on one thread, it updates cached model matrices and the static tree.
+    m_staticColliders.clear();
     for (auto entity : view)
     {
-        //if (bee::Engine.Registry().all_of<Rigidbody>(entity)) continue;
-        auto& boxCollider = view.get<BoxCollider>(entity);
-        auto& transform = view.get<bee::Transform>(entity);
+        const OBB& obb = UpdateOBB(entity, view.get<BoxCollider>(entity).size, view.get<bee::Transform>(entity));
 
-        glm::mat4 model = bee::GetWorldModel(entity, bee::Engine.Registry());
+        // rigidbodies are added to the broadphase after they are moved
+        if (!bee::Engine.Registry().all_of<Rigidbody>(entity))
+        {
+            UpdateBroadphase(entity, obb, false, order, glm::vec3(0.0f));
+            m_staticColliders.push_back(entity);
+        }
+        order++;
+    }
+    for (auto entity : m_bodies)
+    {
+        // the sweep writes to the box of every body, so they have to exist before it runs
+        auto& cached = entityOBBs.try_emplace(entity).first->second;
 
-        OBB obb;
-        obb.center = glm::vec3(model[3]);  // Extract translation
+        // a collider that just got a rigidbody leaves the static tree before the sweep, the sweep only reads static boxes
+        auto it = m_proxies.find(entity);
+        if (it != m_proxies.end() && !it->second.dynamic) UpdateBroadphase(entity, cached.obb, true, 0, glm::vec3(0.0f));
+    }
 
-        // Extract axes and scaling factors
-        glm::vec3 right = glm::vec3(model[0]);
-        glm::vec3 up = glm::vec3(model[1]);
-        glm::vec3 forward = glm::vec3(model[2]);
+    // colliders destroyed since the last step are still in the static tree, they must not be found by the queries
+    RemoveStaleProxies(false);
 
-        glm::vec3 scale = transform.GetScale();
+    auto& jobs = bee::Engine.Jobs();
 
-        // Normalize the axes to get rotation
-        obb.axes[0] = glm::normalize(right);
-        obb.axes[1] = glm::normalize(up);
-        obb.axes[2] = glm::normalize(forward);
+    // Broadphase, only static pairs whose bounds overlap get tested, every pair once in the same order as the view
+    const size_t colliderChunks = bee::JobSystem::ChunkCount(m_staticColliders.size(), collidersPerChunk);
+    PrepareChunks(colliderChunks);
+    jobs.ParallelFor(m_staticColliders.size(),
+                     collidersPerChunk,
+                     [&](size_t begin, size_t end, size_t chunk)
+                     {
+                         for (size_t collider = begin; collider < end; collider++) QueryStaticPairs(collider, m_chunks[chunk]);
+                     });
 
-        // Multiply half-sizes by the scaling factors
-        // Since boxCollider.size is now in local space, scaling factors are applied here
-        obb.halfSizes = (boxCollider.size * 0.5f) * scale;
+    m_candidatePairs.clear();
+    m_pairGroups.clear();
+    for (size_t chunk = 0; chunk < colliderChunks; chunk++)
+    {
+        m_candidatePairs.insert(m_candidatePairs.end(), m_chunks[chunk].pairs.begin(), m_chunks[chunk].pairs.end());
+    }
+    for (size_t i = 0; i < m_candidatePairs.size(); i++)
+    {
+        if (i == 0 || m_candidatePairs[i].first != m_candidatePairs[i - 1].first) m_pairGroups.push_back(i);
+    }
+    m_pairGroups.push_back(m_candidatePairs.size());
+
+    // Check collisions between the candidate pairs, the candidates of a collider are tested four at a time
+    const size_t groupCount = m_pairGroups.size() - 1;
+    const size_t groupChunks = bee::JobSystem::ChunkCount(groupCount, pairGroupsPerChunk);
+    PrepareChunks(groupChunks);
+    jobs.ParallelFor(groupCount,
+                     pairGroupsPerChunk,
+                     [&](size_t begin, size_t end, size_t chunk)
+                     {
+                         for (size_t group = begin; group < end; group++) TestPairGroup(group, m_chunks[chunk]);
+                     });
+
+    for (size_t chunk = 0; chunk < groupChunks; chunk++)
+    {
+        m_contacts.insert(m_contacts.end(), m_chunks[chunk].contacts.begin(), m_chunks[chunk].contacts.end());
+    }
 
-        entityOBBs[entity] = obb;
+    // Move every rigidbody against the static colliders
+    m_bodyDisplacements.assign(m_bodies.size(), glm::vec3(0.0f));
+    const size_t bodyChunks = bee::JobSystem::ChunkCount(m_bodies.size(), bodiesPerChunk);
+    PrepareChunks(bodyChunks);
+    jobs.ParallelFor(m_bodies.size(),
+                     bodiesPerChunk,
+                     [&](size_t begin, size_t end, size_t chunk)
+                     {
+                         for (size_t body = begin; body < end; body++) SweepBody(body, m_chunks[chunk]);
+                     });
+
+    // merge the results and update the dynamic tree in body order
+    auto& registry = bee::Engine.Registry();
+    m_sweepCandidates = 0;
+    for (size_t chunk = 0; chunk < bodyChunks; chunk++)
+    {
+        const StepChunk& output = m_chunks[chunk];
+        m_contacts.insert(m_contacts.end(), output.contacts.begin(), output.contacts.end());
+        m_sweepCandidates += output.sweepCandidates;
     }
 
-    // Structure to hold collision data
-    struct CollisionResult
+    for (size_t body = 0; body < m_bodies.size(); body++)
     {
-        bool isColliding;
-        float penetrationDepth;
-        glm::vec3 collisionNormal;
-    };
+        const entt::entity entity = m_bodies[body];
+        if (!registry.all_of<BoxCollider>(entity)) continue;
+        UpdateBroadphase(entity, entityOBBs[entity].obb, true, 0, m_bodyDisplacements[body]);
+    }
 
-    // Collision detection function using normalized axes
-    auto OBBOverlap = [](const OBB& A, const OBB& B, CollisionResult& result) -> bool
+    RemoveStaleProxies(true);
+
+    const size_t lookups = m_obbCacheHits + m_obbCacheMisses;
+    if (lookups > 0)
     {
-        float EPSILON = 1e-6f;
-        float ra, rb;
-        glm::mat3 R, AbsR;
+        const float hitRate = static_cast<float>(m_obbCacheHits) / static_cast<float>(lookups);
+        bee::profiler::SetCounter("Physics OBB cache hit rate (%)", hitRate * 100.0f);
+    }
+}
 
-        float minPenetration = FLT_MAX;
-        glm::vec3 axis;
-        bool invertNormal = false;
+// Runs on worker threads, finds the static colliders after this one in view order that it might touch
+void Physics::QueryStaticPairs(size_t collider, StepChunk& chunk) const
+{
+    const entt::entity entityA = m_staticColliders[collider];
+    const uint32_t orderA = m_proxies.find(entityA)->second.order;
+    const OBB& obbA = entityOBBs.find(entityA)->second.obb;
+
+    m_staticTree.Query(bee::AABB::FromOBB(obbA.center, obbA.axes, obbA.halfSizes),
+                       [&](int proxy)
+                       {
+                           entt::entity entityB = m_staticTree.GetEntity(proxy);
+                           if (m_proxies.find(entityB)->second.order > orderA) chunk.pairs.emplace_back(entityA, entityB);
+                           return true;
+                       });
+}
 
-        // Compute rotation matrix expressing B in A's coordinate frame
-        for (int i = 0; i < 3; ++i)
-        {
-            for (int j = 0; j < 3; ++j)
-            {
-                R[i][j] = glm::dot(A.axes[i], B.axes[j]);
-            }
-        }
+// Runs on worker threads, tests a collider against all its candidates four at a time
+void Physics::TestPairGroup(size_t group, StepChunk& chunk) const
+{
+    const size_t first = m_pairGroups[group];
+    const size_t last = m_pairGroups[group + 1];
+    const entt::entity entityA = m_candidatePairs[first].first;
 
-        // Compute translation vector T
-        glm::vec3 t = B.center - A.center;
-        // Bring translation into A's coordinate frame
-        t = glm::vec3(glm::dot(t, A.axes[0]), glm::dot(t, A.axes[1]), glm::dot(t, A.axes[2]));
+    chunk.candidateOBBs.clear();
+    for (size_t pair = first; pair < last; pair++)
+    {
+        chunk.candidateOBBs.push_back(entityOBBs.find(m_candidatePairs[pair].second)->second.obb);
+    }
+    bee::PackOBBs(chunk.candidateOBBs.data(), chunk.candidateOBBs.size(), chunk.candidateBlocks);
 
-        // Compute common subexpressions and add in an epsilon term
-        for (int i = 0; i < 3; ++i)
+    const OBB& obbA = entityOBBs.find(entityA)->second.obb;
+    for (size_t block = 0; block < chunk.candidateBlocks.size(); block++)
+    {
+        float penetrations[4];
+        glm::vec3 normals[4];
+        const int mask = bee::OBBOverlap4(obbA, chunk.candidateBlocks[block], penetrations, normals);
+        for (int lane = 0; lane < 4; lane++)
         {
-            for (int j = 0; j < 3; ++j)
-            {
-                AbsR[i][j] = std::abs(R[i][j]) + EPSILON;
-            }
+            if (!(mask & (1 << lane))) continue;
+            const entt::entity entityB = m_candidatePairs[first + block * 4 + lane].second;
+            const CollisionInfo info = GetStaticContactInfo(entityA, entityB, penetrations[lane], normals[lane]);
+            chunk.contacts.push_back({entityA, entityB, ContactState::Begin, info});
         }
+    }
+}
 
-        float penetration;
-        glm::vec3 currentAxis;
+// Runs on worker threads, only writes to the body itself and the chunk
+void Physics::SweepBody(size_t body, StepChunk& chunk)
+{
+    auto& registry = bee::Engine.Registry();
+    const entt::entity entityA = m_bodies[body];
+    Rigidbody& rigidbody = registry.get<Rigidbody>(entityA);
+    bee::Transform& transform = registry.get<bee::Transform>(entityA);
+    OBB& obbA = entityOBBs.find(entityA)->second.obb;
 
-        // Test axes L = A0, A1, A2
-        for (int i = 0; i < 3; ++i)
+    if (rigidbody.sleeping)
+    {
+        // keep the contacts it fell asleep with, they come back as Stay once it wakes up instead of as new hits
+        ForEachRestingContact(entityA,
+                              [&](const ContactEvent& contact)
+                              {
+                                  chunk.contacts.push_back(
+                                      {contact.entityA, contact.entityB, ContactState::Begin, contact.info});
+                              });
+        return;
+    }
+
+    // Initialize remaining movement
+    glm::vec3 start = rigidbody.previousPosition;
+    glm::vec3 end = transform.GetPosition();
+    glm::vec3 remainingMovement = end - start;
+
+    // Maximum number of iterations to prevent infinite loops
+    const int maxIterations = 5;
+    int iterations = 0;
+
+    while (glm::length2(remainingMovement) > 1e-6f && iterations < maxIterations)
+    {
+        iterations++;
+
+        // Update OBB position for current movement
+        obbA.center = start;
+
+        float nearestT = 1.0f;
+        auto collisionNormal = glm::vec3(0.0f);
+        entt::entity collidedEntity = entt::null;
+
+        // Gather the static colliders the movement passes through, then test them four at a time
+        const glm::vec3 segmentEnd = start + remainingMovement;
+        chunk.sweepEntities.clear();
+        chunk.candidateOBBs.clear();
+        m_staticTree.QuerySegment(start,
+                                  segmentEnd,
+                                  [&](int proxy)
+                                  {
+                                      entt::entity entityB = m_staticTree.GetEntity(proxy);
+                                      if (entityB == entityA) return true;  // Skip self
+                                      chunk.sweepEntities.push_back(entityB);
+                                      chunk.candidateOBBs.push_back(entityOBBs.find(entityB)->second.obb);
+                                      return true;
+                                  });
+        chunk.sweepCandidates += chunk.sweepEntities.size();
+        bee::PackOBBs(chunk.candidateOBBs.data(), chunk.candidateOBBs.size(), chunk.candidateBlocks);
+
+        for (size_t block = 0; block < chunk.candidateBlocks.size(); block++)
         {
-            ra = A.halfSizes[i];
-            rb = B.halfSizes[0] * AbsR[i][0] + B.halfSizes[1] * AbsR[i][1] + B.halfSizes[2] * AbsR[i][2];
-            penetration = (ra + rb) - std::abs(t[i]);
-            if (penetration < 0)
-                return false;  // No collision
-            else if (penetration < minPenetration)
+            float t[4];
+            glm::vec3 normals[4];
+            const int mask = bee::SegmentOBBIntersection4(start, segmentEnd, chunk.candidateBlocks[block], t, normals);
+            for (int lane = 0; lane < 4; lane++)
             {
-                minPenetration = penetration;
-                axis = A.axes[i];
-                invertNormal = t[i] < 0;
+                if ((mask & (1 << lane)) && t[lane] < nearestT)
+                {
+                    nearestT = t[lane];
+                    collisionNormal = normals[lane];
+                    collidedEntity = chunk.sweepEntities[block * 4 + lane];
+                }
             }
         }
 
-        // Now test the 9 cross products of the axes
-        auto TestCrossAxis = [&](int i, int j)
+        if (collidedEntity != entt::null)
         {
-            currentAxis = glm::cross(A.axes[i], B.axes[j]);
-            float len2 = glm::length2(currentAxis);
-            if (len2 < EPSILON) return true;  // Skip near-zero axes
-
-            currentAxis = glm::normalize(currentAxis);
-
-            ra = A.halfSizes[(i + 1) % 3] * glm::length(A.axes[(i + 2) % 3]) * AbsR[(i + 2) % 3][j] +
-                 A.halfSizes[(i + 2) % 3] * glm::length(A.axes[(i + 1) % 3]) * AbsR[(i + 1) % 3][j];
-            rb = B.halfSizes[(j + 1) % 3] * glm::length(B.axes[(j + 2) % 3]) * AbsR[i][(j + 2) % 3] +
-                 B.halfSizes[(j + 2) % 3] * glm::length(B.axes[(j + 1) % 3]) * AbsR[i][(j + 1) % 3];
-            float tValue = t[(i + 2) % 3] * R[(i + 1) % 3][j] - t[(i + 1) % 3] * R[(i + 2) % 3][j];
-            penetration = (ra + rb) - std::abs(tValue);
-            if (penetration < 0)
-                return false;  // No collision
-            else if (penetration < minPenetration)
-            {
-                minPenetration = penetration;
-                axis = currentAxis;
-                invertNormal = tValue < 0;
-            }
-            return true;
-        };
+            // Collision detected at time t = nearestT
+            // Update position to collision point
+            glm::vec3 movementToCollision = remainingMovement * nearestT;
+            start += movementToCollision;
+            obbA.center = start;
 
-        // Loop over all cross products of A's and B's axes
-        for (int i = 0; i < 3; ++i)
+            // Store collision info
+            CollisionInfo info;
+            info.worldPosition = start;
+            info.normal = collisionNormal;
+            // set the impact velocity to the velocity of the rigidbody in the inverse direction of the collision normal
+            info.impactVelocity = glm::dot(rigidbody.velocity, -collisionNormal);
+            chunk.contacts.push_back({entityA, collidedEntity, ContactState::Begin, info});
+
+            // Adjust velocity (simple reflection)
+            glm::vec3 velocity = rigidbody.velocity;
+            rigidbody.velocity =
+                velocity - 2.0f * glm::dot(velocity, collisionNormal) * collisionNormal * m_reflectionCoefficient;
+
+            // place them back to the point of collision plus the size of the bounding box
+            glm::vec3 boundingVolume = obbA.halfSizes;
+            start += boundingVolume * collisionNormal;
+
+            // Update remaining movement
+            remainingMovement = remainingMovement * (1.0f - nearestT);
+
+            // Adjust remaining movement based on new velocity
+            remainingMovement = rigidbody.velocity * (glm::length(remainingMovement) / glm::length(velocity));
+        }
+        else
         {
-            for (int j = 0; j < 3; ++j)
-            {
-                if (!TestCrossAxis(i, j)) return false;
-            }
+            // No collision, move to end position
+            start += remainingMovement;
+            remainingMovement = glm::vec3(0.0f);
         }
+    }
 
-        // If no separating axis is found, the OBBs must be intersecting
-        result.isColliding = true;
-        result.penetrationDepth = minPenetration;
-        result.collisionNormal = invertNormal ? -axis : axis;
+    // Update transform component
+    transform.SetPosition(start);
+    obbA.center = start;
+    m_bodyDisplacements[body] = start - rigidbody.previousPosition;
+}
 
-        return true;
-    };
+// Runs on worker threads, finds the bodies after this one in m_bodies whose boxes overlap it
+void Physics::QueryBodyTouches(size_t body, StepChunk& chunk) const
+{
+    auto& registry = bee::Engine.Registry();
+    const entt::entity entityA = m_bodies[body];
+    if (!registry.all_of<BoxCollider>(entityA)) return;
+
+    const OBB& obbA = entityOBBs.find(entityA)->second.obb;
+    m_dynamicTree.Query(bee::AABB::FromOBB(obbA.center, obbA.axes, obbA.halfSizes),
+                        [&](int proxy)
+                        {
+                            const entt::entity entityB = m_dynamicTree.GetEntity(proxy);
+                            auto it = m_bodyIndices.find(entityB);
+                            if (it == m_bodyIndices.end() || it->second <= body) return true;
+
+                            float penetration = 0.0f;
+                            glm::vec3 normal(0.0f);
+                            if (bee::OBBOverlap(obbA, entityOBBs.find(entityB)->second.obb, penetration, normal))
+                                chunk.pairs.emplace_back(entityA, entityB);
+                            return true;
+                        });
+}
 
-    auto HalfSizeAlongNormal = [](const OBB& obb, const glm::vec3& normal) -> float
+std::vector<bee::benchmark::Result> Physics::BenchmarkStep()
+{
+    auto& registry = bee::Engine.Registry();
+    auto& jobs = bee::Engine.Jobs();
+    constexpr int steps = 60;
+    constexpr float deltaTime = 1.0f / 60.0f;
+
+    // The test scene gets its own registry, swapped with the one of the engine since the step reads that. The scene and
+    // the physics state are put back when done, so running this during play doesn't change the game.
+    entt::registry scene;
+    registry.swap(scene);
+    const Physics sceneState = *this;
+    const int savedMaxThreads = jobs.GetMaxThreads();
+
+    // a floor, a row of overlapping static boxes and a grid of falling bodies
+    std::vector<entt::entity> created;
+    auto CreateBox = [&](const glm::vec3& position, const glm::vec3& scale, const glm::vec3* velocity)
     {
-        return obb.halfSizes.x * std::abs(glm::dot(normal, obb.axes[0])) +
-               obb.halfSizes.y * std::abs(glm::dot(normal, obb.axes[1])) +
-               obb.halfSizes.z * std::abs(glm::dot(normal, obb.axes[2]));
+        const entt::entity entity = registry.create();
+        registry.emplace<bee::Transform>(entity, position, glm::quat(1.0f, 0.0f, 0.0f, 0.0f), scale);
+        registry.emplace<BoxCollider>(entity);
+        if (velocity)
+        {
+            auto& rb = registry.emplace<Rigidbody>(entity);
+            rb.velocity = *velocity;
+            rb.acceleration = glm::vec3(0.0f);
+            rb.previousPosition = position;
+        }
+        created.push_back(entity);
     };
 
-    // Check collisions between all pairs
-    for (auto it = view.begin(); it != view.end(); ++it)
+    CreateBox(glm::vec3(0.0f), glm::vec3(64.0f, 1.0f, 64.0f), nullptr);
+    for (int i = 0; i < 64; i++)
     {
-        entt::entity entityA = *it;
-        if (bee::Engine.Registry().all_of<Rigidbody>(entityA)) continue;
-        OBB& obbA = entityOBBs[entityA];
+        CreateBox(glm::vec3(static_cast<float>(i - 32), 2.0f, -20.0f), glm::vec3(1.5f, 1.0f, 1.0f), nullptr);
+    }
+    const size_t staticCount = created.size();
 
-        for (auto otherIt = std::next(it); otherIt != view.end(); ++otherIt)
+    // side by side bodies above the floor, replaces the grid created before
+    auto CreateGrid = [&](int side)
+    {
+        registry.destroy(created.begin() + static_cast<std::ptrdiff_t>(staticCount), created.end());
+        created.resize(staticCount);
+        const int half = side / 2;
+        for (int x = 0; x < side; x++)
         {
-            entt::entity entityB = *otherIt;
-            if (bee::Engine.Registry().all_of<Rigidbody>(entityB)) continue;
-            OBB& obbB = entityOBBs[entityB];
-
-            // Collision result
-            CollisionResult collisionResult;
-            collisionResult.isColliding = false;
-
-            // Check for collision
-            if (OBBOverlap(obbA, obbB, collisionResult))
+            for (int z = 0; z < side; z++)
             {
-                // Collision normal from SAT
-                // After collision detection and determining collision normal
-                glm::vec3 collisionNormal = collisionResult.collisionNormal;
+                const glm::vec3 velocity(static_cast<float>(x % 5 - 2), 0.0f, static_cast<float>(z % 3 - 1));
+                const glm::vec3 position(static_cast<float>(x - half),
+                                         static_cast<float>(5 + (x + z) % 7),
+                                         static_cast<float>(z - half));
+                CreateBox(position, glm::vec3(0.5f), &velocity);
+            }
+        }
+    };
+    CreateGrid(32);
 
-                // Calculate half-size projections along the collision normal
-                float distanceA = HalfSizeAlongNormal(obbA, collisionNormal);
-                float distanceB = HalfSizeAlongNormal(obbB, collisionNormal);
+    std::vector<std::tuple<entt::entity, Rigidbody, bee::Transform>> startBodies;
+    for (auto [entity, rb, transform] : registry.view<Rigidbody, bee::Transform>().each())
+    {
+        startBodies.emplace_back(entity, rb, transform);
+    }
+    auto Restore = [&](const std::vector<std::tuple<entt::entity, Rigidbody, bee::Transform>>& bodies)
+    {
+        Reset();
+        for (const auto& [entity, rb, transform] : bodies)
+        {
+            registry.get<Rigidbody>(entity) = rb;
+            registry.get<bee::Transform>(entity) = transform;
+        }
+    };
 
-                // Calculate the contact points on both OBBs
-                glm::vec3 contactPointA = obbA.center + collisionNormal * (distanceA - collisionResult.penetrationDepth * 0.5f);
-                glm::vec3 contactPointB = obbB.center - collisionNormal * (distanceB - collisionResult.penetrationDepth * 0.5f);
+    // the bits of every body and contact, padding is skipped so only real values are compared
+    auto Capture = [&]()
+    {
+        std::vector<uint32_t> bits;
+        auto Push = [&](const auto& value)
+        {
+            static_assert(sizeof(value) % sizeof(uint32_t) == 0);
+            const size_t offset = bits.size();
+            bits.resize(offset + sizeof(value) / sizeof(uint32_t));
+            std::memcpy(&bits[offset], &value, sizeof(value));
+        };
+        for (auto entity : m_bodies)
+        {
+            const auto& rb = registry.get<Rigidbody>(entity);
+            Push(registry.get<bee::Transform>(entity).GetPosition());
+            Push(rb.velocity);
+            Push(static_cast<uint32_t>(rb.sleeping));
+        }
+        for (const auto& contact : m_contactEvents)
+        {
+            Push(contact.entityA);
+            Push(contact.entityB);
+            Push(static_cast<uint32_t>(contact.state));
+            Push(contact.info.worldPosition);
+            Push(contact.info.normal);
+            Push(contact.info.impactVelocity);
+        }
+        return bits;
+    };
 
-                // Decide which object is smaller
-                float sizeA = obbA.halfSizes.x * obbA.halfSizes.y * obbA.halfSizes.z;
-                float sizeB = obbB.halfSizes.x * obbB.halfSizes.y * obbB.halfSizes.z;
+    std::vector<bee::benchmark::Result> results;
+    std::vector<uint32_t> reference;
+    bool deterministic = true;
+    for (int threads = 1; threads <= jobs.ThreadCount(); threads++)
+    {
+        jobs.SetMaxThreads(threads);
+        auto result = bee::benchmark::Measure(fmt::format("Physics step, {} threads", threads),
+                                              steps,
+                                              [&]()
+                                              {
+                                                  Restore(startBodies);
+                                                  for (int step = 0; step < steps; step++) OnFixedUpdate(deltaTime);
+                                              },
+                                              3);
+
+        const std::vector<uint32_t> bits = Capture();
+        if (threads == 1)
+        {
+            reference = bits;
+        }
+        else if (bits != reference)
+        {
+            result.name += " (MISMATCH)";
+            deterministic = false;
+        }
+        results.push_back(result);
+    }
 
-                glm::vec3 hitPosition;
-                auto adjustedNormal = collisionNormal;
+    if (deterministic)
+        bee::Log::Info("Physics step is bitwise the same for 1 to {} threads", jobs.ThreadCount());
+    else
+        bee::benchmark::Fail("Physics step gives different results depending on the thread count");
 
-                if (sizeA < sizeB)
-                {
-                    // Object A is smaller
-                    hitPosition = contactPointA;
+    jobs.SetMaxThreads(savedMaxThreads);
 
-                    // Adjust the collision normal to be the surface normal of object A at the contact point
-                    // Find the axis of obbA that is most aligned with the collision normal
-                    float maxDot = -FLT_MAX;
-                    for (int i = 0; i < 3; ++i)
-                    {
-                        float dotProduct = glm::dot(collisionNormal, obbA.axes[i]);
-                        if (std::abs(dotProduct) > maxDot)
-                        {
-                            maxDot = std::abs(dotProduct);
-                            adjustedNormal = dotProduct > 0 ? obbA.axes[i] : -obbA.axes[i];
-                        }
-                    }
-                }
-                else
-                {
-                    // Object B is smaller
-                    hitPosition = contactPointB;
-
-                    // Adjust the collision normal to be the surface normal of object B at the contact point
-                    float maxDot = -FLT_MAX;
-                    for (int i = 0; i < 3; ++i)
-                    {
-                        float dotProduct = glm::dot(collisionNormal, obbB.axes[i]);
-                        if (std::abs(dotProduct) > maxDot)
-                        {
-                            maxDot = std::abs(dotProduct);
-                            adjustedNormal = dotProduct > 0 ? obbB.axes[i] : -obbB.axes[i];
-                        }
-                    }
-                }
-
-                // convert adjustedNormal from localspace to worldspace
-                adjustedNormal = glm::normalize(obbA.axes[0] * adjustedNormal.x + obbA.axes[1] * adjustedNormal.y +
-                                                obbA.axes[2] * adjustedNormal.z);
+    // the narrow phase alone at several grid sizes, every run starts from the bodies moved by one step
+    for (const int side : {8, 16, 32})
+    {
+        CreateGrid(side);
+        std::vector<std::tuple<entt::entity, Rigidbody, bee::Transform>> gridBodies;
+        for (auto [entity, rb, transform] : registry.view<Rigidbody, bee::Transform>().each())
+        {
+            gridBodies.emplace_back(entity, rb, transform);
+        }
+        Restore(gridBodies);
+        GatherBodies();
+        UpdatePositions(deltaTime);
 
-                // Store collision info with the adjusted normal
-                CollisionInfo info;
-                info.worldPosition = hitPosition;
-                info.normal = adjustedNormal;  // Use the adjusted normal
-                info.impactVelocity = 0.0f;    // Initialize impact velocity to 0
-                m_collisions[std::make_pair(entityA, entityB)] = info;
-            }
+        std::vector<std::tuple<entt::entity, Rigidbody, bee::Transform>> movedBodies;
+        for (auto entity : m_bodies)
+        {
+            movedBodies.emplace_back(entity, registry.get<Rigidbody>(entity), registry.get<bee::Transform>(entity));
         }
+        const size_t bodies = m_bodies.size();
+        results.push_back(bee::benchmark::MeasureSize("Physics::CheckCollisions",
+                                                      bodies,
+                                                      bodies,
+                                                      [&]()
+                                                      {
+                                                          for (const auto& [entity, rb, transform] : movedBodies)
+                                                          {
+                                                              registry.get<Rigidbody>(entity) = rb;
+                                                              registry.get<bee::Transform>(entity) = transform;
+                                                          }
+                                                          m_contacts.clear();
+                                                          CheckCollisions();
+                                                      },
+                                                      3));
     }
 
-    // For each entity with a rigidbody
-    auto rigidbodyView = bee::ecs::GetView<Rigidbody, bee::Transform>(bee::Engine.Registry());
-
-    for (auto entityA : rigidbodyView)
-    {
-        Rigidbody& rigidbody = rigidbodyView.get<Rigidbody>(entityA);
-        bee::Transform& transform = rigidbodyView.get<bee::Transform>(entityA);
-        OBB& obbA = entityOBBs[entityA];
+    // the test scene is left in the local registry and goes with it
+    registry.swap(scene);
+    *this = sceneState;
+    return results;
+}
 
-        // Initialize remaining movement
-        glm::vec3 start = rigidbody.previousPosition;
-        glm::vec3 end = transform.GetPosition();
-        glm::vec3 remainingMovement = end - start;
+const Physics::OBB& Physics::UpdateOBB(entt::entity entity, const glm::vec3& size, const bee::Transform& transform)
+{
+    auto& registry = bee::Engine.Registry();
+    CachedOBB& cached = entityOBBs[entity];
+    cached.stamp = m_stamp;
 
-        // Maximum number of iterations to prevent infinite loops
-        const int maxIterations = 5;
-        int iterations = 0;
+    const uint64_t worldVersion = bee::GetWorldVersion(entity, registry);
+    if (cached.worldVersion == worldVersion && cached.size == size)
+    {
+        m_obbCacheHits++;
+        return cached.obb;
+    }
+    m_obbCacheMisses++;
+    cached.worldVersion = worldVersion;
+    cached.size = size;
 
-        while (glm::length2(remainingMovement) > 1e-6f && iterations < maxIterations)
-        {
-            iterations++;
+    glm::mat4 model = bee::GetWorldModel(entity, registry);
 
-            // Update OBB position for current movement
-            obbA.center = start;
+    OBB& obb = cached.obb;
+    obb.center = glm::vec3(model[3]);  // Extract translation
 
-            float nearestT = 1.0f;
-            auto collisionNormal = glm::vec3(0.0f);
-            entt::entity collidedEntity = entt::null;
+    // Extract axes and scaling factors
+    glm::vec3 right = glm::vec3(model[0]);
+    glm::vec3 up = glm::vec3(model[1]);
+    glm::vec3 forward = glm::vec3(model[2]);
 
-            // Check collisions with other entities
-            for (auto& entityB : entityOBBs)
-            {
-                if (entityB.first == entityA) continue;  // Skip self
+    glm::vec3 scale = transform.GetScale();
 
-                OBB& obbB = entityB.second;
+    // Normalize the axes to get rotation
+    obb.axes[0] = glm::normalize(right);
+    obb.axes[1] = glm::normalize(up);
+    obb.axes[2] = glm::normalize(forward);
 
-                if (bee::Engine.Registry().all_of<Rigidbody>(entityB.first)) continue;
+    // Multiply half-sizes by the scaling factors
+    // Since boxCollider.size is now in local space, scaling factors are applied here
+    obb.halfSizes = (size * 0.5f) * scale;
+    return obb;
+}
 
-                float t;
-                glm::vec3 intersectionPoint;
-                glm::vec3 normal;
+void Physics::UpdateBroadphase(entt::entity entity, const OBB& obb, bool dynamic, uint32_t order, const glm::vec3& displacement)
+{
+    const bee::AABB bounds = bee::AABB::FromOBB(obb.center, obb.axes, obb.halfSizes);
 
-                if (LineSegmentOBBIntersection(start, start + remainingMovement, obbB, t, intersectionPoint, normal))
-                {
-                    if (t < nearestT)
-                    {
-                        nearestT = t;
-                        collisionNormal = normal;
-                        collidedEntity = entityB.first;
-                    }
-                }
-            }
+    auto [it, inserted] = m_proxies.try_emplace(entity);
+    ColliderProxy& collider = it->second;
 
-            if (collidedEntity != entt::null)
-            {
-                // Collision detected at time t = nearestT
-                // Update position to collision point
-                glm::vec3 movementToCollision = remainingMovement * nearestT;
-                start += movementToCollision;
-                obbA.center = start;
-
-                // Store collision info
-                CollisionInfo info;
-                info.worldPosition = start;
-                info.normal = collisionNormal;
-                // set the impact velocity to the velocity of the rigidbody in the inverse direction of the collision normal
-                info.impactVelocity = glm::dot(rigidbody.velocity, -collisionNormal);
-                m_collisions[std::make_pair(entityA, collidedEntity)] = info;
-
-                // Adjust velocity (simple reflection)
-                glm::vec3 velocity = rigidbody.velocity;
-                rigidbody.velocity =
-                    velocity - 2.0f * glm::dot(velocity, collisionNormal) * collisionNormal * m_reflectionCoefficient;
-                // also set the other entity's velocity
-                if (bee::Engine.Registry().all_of<Rigidbody>(collidedEntity))
-                {
-                    auto& otherRigidbody = bee::Engine.Registry().get<Rigidbody>(collidedEntity);
-                    glm::vec3 otherVelocity = otherRigidbody.velocity;
-                    otherRigidbody.velocity = otherVelocity + 2.0f * glm::dot(otherVelocity, -collisionNormal) *
-                                                                  -collisionNormal * m_reflectionCoefficient;
-                }
+    // gaining or losing a rigidbody moves the collider to the other tree
+    if (!inserted && collider.dynamic != dynamic)
+    {
+        (collider.dynamic ? m_dynamicTree : m_staticTree).DestroyProxy(collider.proxy);
+        inserted = true;
+    }
 
-                // place them back to the point of collision plus the size of the bounding box
-                glm::vec3 boundingVolume = obbA.halfSizes;
-                start += boundingVolume * collisionNormal;
+    bee::AABBTree& tree = dynamic ? m_dynamicTree : m_staticTree;
+    if (inserted)
+        collider.proxy = tree.CreateProxy(bounds, entity);
+    else
+        tree.MoveProxy(collider.proxy, bounds, displacement);
 
-                // Update remaining movement
-                remainingMovement = remainingMovement * (1.0f - nearestT);
+    collider.dynamic = dynamic;
+    collider.order = order;
+    collider.stamp = m_stamp;
+}
 
-                // Adjust remaining movement based on new velocity
-                remainingMovement = rigidbody.velocity * (glm::length(remainingMovement) / glm::length(velocity));
-            }
-            else
-            {
-                // No collision, move to end position
-                start += remainingMovement;
-                remainingMovement = glm::vec3(0.0f);
-            }
+void Physics::RemoveStaleProxies(bool dynamic)
+{
+    // colliders that weren't seen this step got destroyed or lost their collider
+    for (auto it = m_proxies.begin(); it != m_proxies.end();)
+    {
+        if (it->second.stamp == m_stamp || (it->second.dynamic && !dynamic))
+        {
+            ++it;
+            continue;
         }
 
-        // Update transform component
-        bee::Engine.Registry().get<bee::Transform>(entityA).SetPosition(start);
+        (it->second.dynamic ? m_dynamicTree : m_staticTree).DestroyProxy(it->second.proxy);
+        entityOBBs.erase(it->first);
+        it = m_proxies.erase(it);
+    }
+    if (!dynamic) return;
+
+    for (auto it = entityOBBs.begin(); it != entityOBBs.end();)
+    {
+        if (it->second.stamp == m_stamp)
+            ++it;
+        else
+            it = entityOBBs.erase(it);
     }
 }
 
-bool Physics::LineSegmentOBBIntersection(const glm::vec3& start,
-                                         const glm::vec3& end,
-                                         const OBB& obb,
-                                         float& t,
-                                         glm::vec3& intersectionPoint,
-                                         glm::vec3& normal)
+Physics::CollisionInfo Physics::GetStaticContactInfo(entt::entity entityA,
+                                                      entt::entity entityB,
+                                                      float penetration,
+                                                      const glm::vec3& normal) const
 {
-    // Transform the line segment into the OBB's local space
-    glm::vec3 dir = end - start;
-    glm::vec3 localStart = start - obb.center;
-
-    // Initialize variables for tracking the interval of intersection
-    float tmin = 0.0f;
-    float tmax = 1.0f;
+    const OBB& obbA = entityOBBs.find(entityA)->second.obb;
+    const OBB& obbB = entityOBBs.find(entityB)->second.obb;
 
-    // For each OBB axis
-    for (int i = 0; i < 3; ++i)
+    auto HalfSizeAlongNormal = [](const OBB& obb, const glm::vec3& n) -> float
     {
-        glm::vec3 axis = obb.axes[i];
-        float e = glm::dot(axis, localStart);
-        float f = glm::dot(axis, dir);
-        float h = obb.halfSizes[i];
-
-        if (std::abs(f) > 1e-6f)
-        {
-            float t1 = (-h - e) / f;
-            float t2 = (h - e) / f;
+        return obb.halfSizes.x * std::abs(glm::dot(n, obb.axes[0])) + obb.halfSizes.y * std::abs(glm::dot(n, obb.axes[1])) +
+               obb.halfSizes.z * std::abs(glm::dot(n, obb.axes[2]));
+    };
 
-            if (t1 > t2) std::swap(t1, t2);
+    // Collision normal from SAT
+    // After collision detection and determining collision normal
+    glm::vec3 collisionNormal = normal;
 
-            if (t1 > tmin) tmin = t1;
-            if (t2 < tmax) tmax = t2;
+    // Calculate half-size projections along the collision normal
+    float distanceA = HalfSizeAlongNormal(obbA, collisionNormal);
+    float distanceB = HalfSizeAlongNormal(obbB, collisionNormal);
 
-            if (tmin > tmax) return false;
-            if (tmax < 0.0f) return false;
-        }
-        else
-        {
-            if (-e - h > 0.0f || -e + h < 0.0f) return false;
-        }
-    }
+    // Calculate the contact points on both OBBs
+    glm::vec3 contactPointA = obbA.center + collisionNormal * (distanceA - penetration * 0.5f);
+    glm::vec3 contactPointB = obbB.center - collisionNormal * (distanceB - penetration * 0.5f);
 
-    t = tmin;
+    // Decide which object is smaller
+    float sizeA = obbA.halfSizes.x * obbA.halfSizes.y * obbA.halfSizes.z;
+    float sizeB = obbB.halfSizes.x * obbB.halfSizes.y * obbB.halfSizes.z;
 
-    if (t < 0.0f) t = 0.0f;  // Clamp to segment start
-    if (t > 1.0f) t = 1.0f;  // Clamp to segment end
+    glm::vec3 hitPosition;
+    auto adjustedNormal = collisionNormal;
 
-    // Calculate intersection point
-    intersectionPoint = start + dir * t;
+    if (sizeA < sizeB)
+    {
+        // Object A is smaller
+        hitPosition = contactPointA;
 
-    // Calculate normal at the point of intersection
-    // Find the axis with the largest projection
-    glm::vec3 localPoint = intersectionPoint - obb.center;
-    for (int i = 0; i < 3; ++i)
+        // Adjust the collision normal to be the surface normal of object A at the contact point
+        // Find the axis of obbA that is most aligned with the collision normal
+        float maxDot = -FLT_MAX;
+        for (int i = 0; i < 3; ++i)
+        {
+            float dotProduct = glm::dot(collisionNormal, obbA.axes[i]);
+            if (std::abs(dotProduct) > maxDot)
+            {
+                maxDot = std::abs(dotProduct);
+                adjustedNormal = dotProduct > 0 ? obbA.axes[i] : -obbA.axes[i];
+            }
+        }
+    }
+    else
     {
-        float projection = glm::dot(localPoint, obb.axes[i]);
-        float extent = obb.halfSizes[i];
-        if (std::abs(projection) >= extent - 1e-3f)
+        // Object B is smaller
+        hitPosition = contactPointB;
+
+        // Adjust the collision normal to be the surface normal of object B at the contact point
+        float maxDot = -FLT_MAX;
+        for (int i = 0; i < 3; ++i)
         {
-            normal = obb.axes[i] * (projection > 0 ? 1.0f : -1.0f);
-            break;
+            float dotProduct = glm::dot(collisionNormal, obbB.axes[i]);
+            if (std::abs(dotProduct) > maxDot)
+            {
+                maxDot = std::abs(dotProduct);
+                adjustedNormal = dotProduct > 0 ? obbB.axes[i] : -obbB.axes[i];
+            }
         }
     }
 
-    return true;
-}
+    // convert adjustedNormal from localspace to worldspace
+    adjustedNormal = glm::normalize(obbA.axes[0] * adjustedNormal.x + obbA.axes[1] * adjustedNormal.y +
+                                    obbA.axes[2] * adjustedNormal.z);
 
+    // Store collision info with the adjusted normal
+    CollisionInfo info;
+    info.worldPosition = hitPosition;
+    info.normal = adjustedNormal;  // Use the adjusted normal
+    info.impactVelocity = 0.0f;    // Initialize impact velocity to 0
+    return info;
+}
 
 
 /*
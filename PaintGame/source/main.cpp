@@ -3,10 +3,11 @@
 #include "Physics.hpp"
 #include "components.hpp"
 
-int main()
+int main(int argc, char* argv[])
 {
     EngineSettings settings;
     settings.projectPath = "PaintGame";
+    bee::ParseArguments(settings, argc, argv);
     bee::Engine.Initialize(settings);
     bee::Engine.PushAppLayer(new Physics());
     bee::Engine.PushAppLayer(new Gameplay());
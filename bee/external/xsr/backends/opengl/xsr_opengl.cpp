@@ -405,6 +405,44 @@ texture_handle xsr::create_texture(int width, int height, const void* pixel_rgba
     return texture_handle{(int)internal::textures.size()};
 }
 
+void xsr::update_texture(texture_handle texture,
+                         int x,
+                         int y,
+                         int width,
+                         int height,
+                         const void* pixel_rgba_bytes,
+                         int row_length)
+{
+    if (texture.id <= 0 || texture.id > (int)internal::textures.size()) return;
+
+    glBindTexture(GL_TEXTURE_2D, internal::textures[texture.id - 1].id);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, row_length);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixel_rgba_bytes);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+bool xsr::read_texture(texture_handle texture, std::vector<unsigned char>& pixel_rgba_bytes, int& width, int& height)
+{
+    if (texture.id <= 0 || texture.id > (int)internal::textures.size()) return false;
+
+    glBindTexture(GL_TEXTURE_2D, internal::textures[texture.id - 1].id);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+    if (width <= 0 || height <= 0)
+    {
+        glBindTexture(GL_TEXTURE_2D, 0);
+        return false;
+    }
+
+    pixel_rgba_bytes.resize((size_t)width * (size_t)height * 4);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel_rgba_bytes.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return true;
+}
+
 void xsr::unload_texture(texture_handle texture)
 {
     if (texture.id <= 0 || texture.id > (int)internal::textures.size()) return;
@@ -141,6 +141,23 @@ void unload_mesh(mesh_handle mesh);
 /// </summary>
 texture_handle create_texture(int width, int height, const void* pixel_rgba_bytes);
 
+/// <summary>
+/// Replaces a rectangle of a texture with pixel data.
+/// </summary>
+/// <param name="row_length">Pixels per row of the source data, 0 if the rows are width pixels long.</param>
+void update_texture(texture_handle texture,
+                    int x,
+                    int y,
+                    int width,
+                    int height,
+                    const void* pixel_rgba_bytes,
+                    int row_length = 0);
+
+/// <summary>
+/// Reads the pixels of a texture back from the GPU. Slow, meant for loading time.
+/// </summary>
+bool read_texture(texture_handle texture, std::vector<unsigned char>& pixel_rgba_bytes, int& width, int& height);
+
 /// <summary>
 /// Unloads a texture from memory.
 /// </summary>
@@ -56,6 +56,7 @@
 #include "tools/tools.hpp"
 #include "tools/warnings.hpp"
 #include "tools/uuid.hpp"
+#include "tools/stringTable.hpp"
 
 
 
@@ -8,9 +8,13 @@
 #include "core/engine.hpp"
 #include "core/device.hpp"
 #include "core/fileio.hpp"
+#include "core/jobs.hpp"
+#include "core/timers.hpp"
+#include "core/replay.hpp"
 
 #include "resource/resourceManager.hpp"
 #include "managers/render_manager.hpp"
+#include "managers/interpolation_manager.hpp"
 #include "managers/grid_manager.hpp"
 #include "managers/undo_redo_manager.hpp"
 
@@ -18,6 +22,7 @@
 #include "tools/shapes.hpp"
 #include "tools/gradient.hpp"
 #include "tools/profiler.hpp"
+#include "tools/benchmark.hpp"
 #include "tools/raycasting.hpp"
 #include "tools/file_dialog.hpp"
 #include "tools/imguiHelper.hpp"
@@ -34,6 +39,11 @@
 
 #include "ecs/components.hpp"
 #include "ecs/enttHelper.hpp"
+#include "ecs/nameIndex.hpp"
+#include "ecs/uuidIndex.hpp"
+#include "ecs/snapshot.hpp"
+#include "ecs/registryStats.hpp"
+#include "ecs/stressScene.hpp"
 #include "ecs/enttCereal.hpp"
 #include "ecs/componentInspector.hpp"
 #include "ecs/componentInitialize.hpp"
@@ -45,6 +55,10 @@
 #include "rendering/RenderingHelper.hpp"
 
 #include "math/math.hpp"
+#include "math/trs.hpp"
+#include "math/aabbTree.hpp"
+#include "math/obb.hpp"
+#include "math/triangleBVH.hpp"
 
 #include "tools/Tweening/tween_system.hpp"
 
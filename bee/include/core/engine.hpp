@@ -8,14 +8,31 @@
 // #include "core/audio.hpp"
 // #include "editor/EditorLayer.hpp"
 
+// Limits how many particles all emitters together may have alive
+struct ParticleBudgetSettings
+{
+    int maxParticles = 4000;
+    float fullDetailDistance = 15.0f;  // emitters closer to the camera than this are not scaled down for distance
+    float cullDistance = 150.0f;       // emitters further away than this stop emitting
+    float minScreenSize = 0.005f;      // particles smaller than this fraction of the screen height emit less
+};
+
 struct EngineSettings
 {
     // Should be set by the application, relative to the .sln/$(WorkingDir).
     std::filesystem::path projectPath;
 
-    bool interpolateParticles = false;
+    bool interpolateTransforms = true;  // draws entities with an Interpolated component between their last two fixed steps
     float timeScale = 1.0f;
     float fixedUpdateRate = 60.0f;
+    uint64_t randomSeed = 0;  // 0 picks one from std::random_device, the seed is logged so a run can be repeated
+    ParticleBudgetSettings particleBudget;
+
+    // When set, the session from the start of the application is recorded to or replayed from this file
+    std::filesystem::path recordInput;
+    std::filesystem::path replayInput;
+    bool quitAfterReplay = true;
+    bool headlessReplay = false;  // a replay runs as fast as it can, nothing is drawn and the window only handles its events
 };
 
 namespace bee
@@ -25,6 +42,9 @@ class FileIO;
 class Device;
 class Input;
 class Audio;
+class JobSystem;
+class TimerWheel;
+class InputReplay;
 class ImGuiLayer;
 class EditorLayer;
 class WindowCloseEvent;
@@ -51,6 +71,11 @@ public:
     Device& Device() { return *m_device; }
     Input& Input() { return *m_input; }
     Audio& Audio() { return *m_audio; }
+    JobSystem& Jobs() { return *m_jobs; }
+    // Advanced with the scaled frame time before the layers update, and with the fixed time step before they fixed update
+    TimerWheel& Timers() { return *m_timers; }
+    TimerWheel& FixedTimers() { return *m_fixedTimers; }
+    InputReplay& Replay() { return *m_replay; }
     entt::registry& Registry() { return m_registry; }
     entt::entity EditorCamera() { return m_editorCamera; }
     entt::entity MainCamera() { return m_mainCamera; }
@@ -62,6 +87,8 @@ public:
 
     float GetGameTime() const { return m_gameTime; }
     float GetRealTime() const { return m_realTime; }
+    // How far the frame is between the last fixed step and the next one, from 0 to 1
+    float GetInterpolationAlpha() const { return m_interpolationAlpha; }
 
     bool IsPlaying() const { return m_playing; }
 
@@ -75,11 +102,17 @@ private:
     
     float m_gameTime = 0.0f;
     float m_realTime = 0.0f;
+    float m_accumulator = 0.0f;  // time the fixed steps are behind
+    float m_interpolationAlpha = 1.0f;
 
     bee::FileIO* m_fileIO = nullptr;
     bee::Device* m_device = nullptr;
     bee::Input* m_input = nullptr;
     bee::Audio* m_audio = nullptr;
+    bee::JobSystem* m_jobs = nullptr;
+    bee::TimerWheel* m_timers = nullptr;
+    bee::TimerWheel* m_fixedTimers = nullptr;
+    bee::InputReplay* m_replay = nullptr;
 
     bee::LayerStack m_applicationLayerStack;
     entt::registry m_registry;  // It works here
@@ -110,6 +143,8 @@ private:
 
     void StartApplication();
     void StopApplication();
+    void StartReplaySession();
+    bool IsHeadless() const;
 
     bool OnWindowClose(WindowCloseEvent& e);
     bool OnKeyPressed(KeyPressedEvent& e);
@@ -118,6 +153,9 @@ private:
 
 extern EngineClass Engine;
 
+// Reads --record <file>, --replay <file> and --headless from the command line into the settings
+void ParseArguments(EngineSettings& settings, int argc, char* argv[]);
+
 }  // namespace bee
 
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common.hpp"
+#include <bitset>
 #include "events/Event.hpp"
 
 namespace bee
@@ -269,15 +270,40 @@ public:
 
     static Input* Create();
 
+    /// <summary>
+    /// Everything the functions above answer from in a single frame, so input can be recorded and replayed.
+    /// The previous frame is not part of it, the input keeps that itself.
+    /// </summary>
+    struct State
+    {
+        static constexpr int keyCount = 350;
+        static constexpr int mouseButtonCount = 8;
+        static constexpr int gamepadCount = 4;
+        static constexpr int gamepadAxisCount = 6;
+
+        std::bitset<keyCount> keys;
+        uint8_t mouseButtons = 0;  // one bit per button
+        glm::vec2 mousePosition = glm::vec2(0.0f);
+        float mouseWheel = 0.0f;
+        uint8_t gamepadsConnected = 0;  // one bit per gamepad
+        uint16_t gamepadButtons[gamepadCount] = {};
+        float gamepadAxes[gamepadCount][gamepadAxisCount] = {};
+    };
+
 private:
     friend class EngineClass;
     friend class InputPc;
     friend class InputProspero;
+    friend class InputReplay;
 
     Input() = default;
     virtual ~Input() = default;
     virtual void Update() = 0;
 
+    virtual void GetState(State& state) const = 0;
+    // Replaces the state of the current frame, the previous frame stays what Update made it
+    virtual void SetState(const State& state) = 0;
+
     virtual void OnEvent(Event& e) = 0;
 };
 
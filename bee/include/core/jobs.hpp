@@ -0,0 +1,100 @@
+#pragma once
+#include "common.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace bee
+{
+
+/// <summary>
+/// Small pool of worker threads for data parallel loops.
+/// Work is split in chunks of a fixed size, so the split doesn't depend on the amount of threads. Writing the output of
+/// every chunk to its own buffer and merging the buffers in chunk order gives the same result for any thread count.
+/// There is one job slot, so ParallelFor and SetMaxThreads may only be called from the thread that created the pool
+/// (or from inside a job, where ParallelFor runs inline).
+/// </summary>
+class JobSystem
+{
+public:
+    // 0 uses one worker less than the hardware threads, the calling thread does work as well
+    explicit JobSystem(int workerCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Workers plus the calling thread
+    int ThreadCount() const { return static_cast<int>(m_workers.size()) + 1; }
+
+    // Limits the threads ParallelFor uses, clamped to [1, ThreadCount()]
+    void SetMaxThreads(int count);
+    int GetMaxThreads() const { return m_maxThreads.load(std::memory_order_relaxed); }
+
+    static size_t ChunkCount(size_t count, size_t chunkSize) { return (count + chunkSize - 1) / chunkSize; }
+
+    // 1 + the index of the pool worker running on this thread, 0 on the main thread and any other thread
+    static int WorkerIndex();
+
+    /// <summary>
+    /// Calls fn(begin, end, chunk) for every chunk of [0, count) and returns once all chunks are done.
+    /// Chunk i covers [i * chunkSize, min((i + 1) * chunkSize, count)). Calls from inside a job run on the calling thread.
+    /// </summary>
+    template <typename Fn>
+    void ParallelFor(size_t count, size_t chunkSize, Fn&& fn);
+
+private:
+    struct Job
+    {
+        void (*run)(void* context, size_t chunk) = nullptr;
+        void* context = nullptr;
+        size_t chunkCount = 0;
+        std::atomic<size_t> next{0};
+    };
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_finished;
+    Job* m_job = nullptr;
+    uint64_t m_generation = 0;
+    int m_busy = 0;
+    std::atomic<int> m_maxThreads{1};
+    std::thread::id m_owner;
+    bool m_quit = false;
+
+    void Dispatch(size_t chunkCount, void (*run)(void*, size_t), void* context);
+    void WorkerLoop(int index);
+    static void RunChunks(Job& job);
+};
+
+template <typename Fn>
+void JobSystem::ParallelFor(size_t count, size_t chunkSize, Fn&& fn)
+{
+    if (count == 0) return;
+    chunkSize = std::max<size_t>(chunkSize, 1);
+
+    struct Context
+    {
+        Fn* fn;
+        size_t count;
+        size_t chunkSize;
+    } context{&fn, count, chunkSize};
+
+    auto run = [](void* data, size_t chunk)
+    {
+        const Context& ctx = *static_cast<Context*>(data);
+        const size_t begin = chunk * ctx.chunkSize;
+        (*ctx.fn)(begin, std::min(begin + ctx.chunkSize, ctx.count), chunk);
+    };
+    Dispatch(ChunkCount(count, chunkSize), run, &context);
+}
+
+}  // namespace bee
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
@@ -0,0 +1,94 @@
+#pragma once
+#include "common.hpp"
+#include "core/input.hpp"
+#include "tools/benchmark.hpp"
+
+namespace bee
+{
+
+// What a session started from, a replay has to start from the same to play out the same
+struct ReplayInfo
+{
+    uint64_t randomSeed = 0;
+    float gameTime = 0.0f;
+    float fixedUpdateRate = 60.0f;
+    int width = 0;
+    int height = 0;
+    uint32_t checkpointInterval = 60;  // frames between registry hashes
+};
+
+/// <summary>
+/// Records the input state, frame time and random seed of every simulated frame into a compact binary file, and feeds
+/// them back in place of the real input and clock. Frames only store what changed since the frame before, so idle input
+/// costs a few bytes. Every checkpoint interval the registry is hashed; a replay compares its hashes with the recorded
+/// ones, so any difference in simulation between two builds shows up as a mismatch instead of a different profile.
+/// The engine starts a session when the application starts, the random generators are reseeded every frame.
+/// </summary>
+class InputReplay
+{
+public:
+    enum class Mode
+    {
+        None,
+        Recording,
+        Replaying
+    };
+
+    InputReplay() = default;
+    InputReplay(const InputReplay&) = delete;
+    InputReplay& operator=(const InputReplay&) = delete;
+
+    // The recording is kept in memory and written to the file on Stop
+    bool StartRecording(const std::filesystem::path& path, const ReplayInfo& info);
+    bool StartReplay(const std::filesystem::path& path);
+    // Writes the recording, or logs how the replay went
+    void Stop();
+
+    // Returns the frame time to simulate with. Records the input, or replaces it with the recorded input.
+    float BeginFrame(Input& input, float dt);
+    // Hashes the registry on checkpoint frames
+    void EndFrame(entt::registry& registry);
+
+    Mode GetMode() const { return m_mode; }
+    bool IsActive() const { return m_mode != Mode::None; }
+    bool IsReplaying() const { return m_mode == Mode::Replaying; }
+    // Every recorded frame was played
+    bool IsFinished() const { return m_mode == Mode::Replaying && m_readOffset >= m_data.size(); }
+    const ReplayInfo& Info() const { return m_info; }
+    uint32_t Frame() const { return m_frame; }
+    size_t Mismatches() const { return m_mismatches; }
+
+    // Entities and local TRS of every transform outside the editor, in storage order
+    static uint64_t HashRegistry(entt::registry& registry);
+
+    // Recording 5000 frames of random input to a file and replaying them, every frame has to come back exactly
+    static std::vector<benchmark::Result> Benchmark();
+
+private:
+    Mode m_mode = Mode::None;
+    std::filesystem::path m_path;
+    ReplayInfo m_info;
+    std::vector<uint8_t> m_data;  // frames, without the header
+    size_t m_readOffset = 0;
+    size_t m_flagsOffset = 0;  // flags of the frame that is being recorded
+    uint32_t m_frame = 0;
+    Input::State m_state;  // state of the last frame, frames store what changed since
+    uint64_t m_expectedHash = 0;
+    bool m_checkpoint = false;
+    size_t m_checkpoints = 0;
+    size_t m_mismatches = 0;
+    std::chrono::high_resolution_clock::time_point m_startTime;
+
+    template <typename T>
+    void Write(const T& value);
+    template <typename T>
+    bool Read(T& value);
+    void Reset();
+};
+
+}  // namespace bee
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
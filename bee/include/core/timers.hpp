@@ -0,0 +1,98 @@
+#pragma once
+#include "common.hpp"
+#include <limits>
+#include "tools/benchmark.hpp"
+
+namespace bee
+{
+
+// Called when a timer fires, data is whatever was passed when scheduling, an entity for example
+using TimerFunction = void (*)(void* context, uint64_t data);
+
+// Refers to a scheduled timer, it stays safe to use after the timer fired or was cancelled
+struct TimerHandle
+{
+    uint32_t index = std::numeric_limits<uint32_t>::max();
+    uint32_t generation = 0;
+};
+
+/// <summary>
+/// Hierarchical timing wheel for expirations and delayed callbacks. Time is cut in ticks, the first level has a slot
+/// for each of the next 256 ticks and every level above has 64 slots that each cover a whole turn of the level below.
+/// Scheduling and cancelling are O(1). A timer moves down a level when the level below comes around to its slot, so
+/// advancing only touches the slots of the ticks that passed and the timers that are close to firing.
+/// The wheel runs on the time it is advanced with, the engine advances one with the scaled frame time and one with the
+/// fixed time step.
+/// </summary>
+class TimerWheel
+{
+public:
+    explicit TimerWheel(float tickLength = 0.001f);
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // Fires on the first tick at or after Now() + delay, never in the tick that is running
+    TimerHandle Schedule(float delay, TimerFunction function, void* context = nullptr, uint64_t data = 0);
+    // Fires on the first tick at or after the time on this wheel
+    TimerHandle ScheduleAt(double time, TimerFunction function, void* context = nullptr, uint64_t data = 0);
+
+    // Returns false if the timer already fired or was cancelled
+    bool Cancel(const TimerHandle& handle);
+    bool IsPending(const TimerHandle& handle) const;
+
+    // Fires the timers of every tick that passed, in the order of their ticks. Negative time is ignored.
+    void Advance(float dt);
+
+    // Drops every pending timer without firing it
+    void Clear();
+
+    double Now() const { return static_cast<double>(m_tick) * m_tickLength + m_remainder; }
+    float TickLength() const { return static_cast<float>(m_tickLength); }
+    size_t Size() const { return m_pending; }
+
+private:
+    static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+    static constexpr int firstLevelBits = 8;
+    static constexpr int levelBits = 6;
+    static constexpr int levelCount = 5;  // 32 bits of ticks, later timers wait in the last level and cascade again
+    static constexpr uint32_t firstLevelSlots = 1u << firstLevelBits;
+    static constexpr uint32_t levelSlots = 1u << levelBits;
+    static constexpr uint32_t slotCount = firstLevelSlots + (levelCount - 1) * levelSlots;
+
+    struct Timer
+    {
+        uint64_t tick = 0;
+        TimerFunction function = nullptr;
+        void* context = nullptr;
+        uint64_t data = 0;
+        uint32_t slot = none;  // none while the timer is free
+        uint32_t next = none;  // in the slot, or in the free list
+        uint32_t previous = none;
+        uint32_t generation = 0;
+    };
+
+    std::vector<Timer> m_timers;
+    std::vector<uint32_t> m_slots;  // first timer of every slot, the first level comes first
+    uint32_t m_freeTimers = none;
+    size_t m_pending = 0;
+    uint64_t m_tick = 0;  // the last tick that ran
+    double m_tickLength;
+    double m_remainder = 0.0;  // time since the last tick
+
+    void Insert(uint32_t index);
+    void Unlink(uint32_t index);
+    void Free(uint32_t index);
+    void Cascade(uint32_t slot);
+    void RunTick();
+};
+
+// Schedules and expires thousands of lifetimes, against counting every one of them down each frame
+std::vector<benchmark::Result> BenchmarkTimerWheel();
+
+}  // namespace bee
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
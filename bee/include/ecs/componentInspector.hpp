@@ -2,6 +2,8 @@
 #include "common.hpp"
 #include "ecs/components.hpp"
 #include "ecs/enttCereal.hpp"
+#include "ecs/snapshot.hpp"
+#include "ecs/registryStats.hpp"
 #include "managers/undo_redo_manager.hpp"
 #include "tools/imguiHelper.hpp"
 
@@ -76,6 +78,9 @@ inline void ComponentManager::RegisterComponent(std::string name,
         registerComponentForDeserialization<ComponentType, cereal::JSONInputArchive>(name);
     }
 
+    bee::ecs::RegisterSnapshotType<ComponentType>();
+    bee::ecs::RegisterStorageType<ComponentType>();
+
     // create an entity with the component, and then delete it so that the component is registered
     entt::entity entity = Engine.Registry().create();
     Engine.Registry().emplace<ComponentType>(entity);
@@ -93,6 +98,9 @@ inline void ComponentManager::RegisterComponentNoSerialize(std::string name, boo
         .prop("removable"_hs, removable)
         .prop("name"_hs, name)
         .func<DrawFunction>("draw"_hs);
+    bee::ecs::RegisterSnapshotType<ComponentType>();
+    bee::ecs::RegisterStorageType<ComponentType>();
+
     // create an entity with the component, and then delete it so that the component is registered
     entt::entity entity = Engine.Registry().create();
     Engine.Registry().emplace<ComponentType>(entity);
@@ -117,6 +125,9 @@ inline void ComponentManager::RegisterComponentNoDraw(std::string name, bool rem
         registerComponentForDeserialization<ComponentType, cereal::JSONInputArchive>(name);
     }
 
+    bee::ecs::RegisterSnapshotType<ComponentType>();
+    bee::ecs::RegisterStorageType<ComponentType>();
+
     // create an entity with the component, and then delete it so that the component is registered
     entt::entity entity = Engine.Registry().create();
     Engine.Registry().emplace<ComponentType>(entity);
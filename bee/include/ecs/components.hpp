@@ -5,6 +5,7 @@
 #include "tools/gradient.hpp"
 #include "tools/ease.hpp"
 #include "tools/raycasting.hpp"
+#include "math/random.hpp"
 #include "resource/resourceManager.hpp"
 #include "resource/gltfLoader.hpp"
 #include "core/engine.hpp"
@@ -20,14 +21,13 @@ class Components;  // this is just here so I can easily find the components
 
 struct HierarchyNode
 {
-    std::string name;
+    Name name;
     entt::entity parent = entt::null;
     bool selectParent = false;
     std::vector<entt::entity> children = {};
 
     HierarchyNode() = default;
-    HierarchyNode(std::string& n) noexcept : name(std::move(n)) {}
-    HierarchyNode(const std::string& n) noexcept : name(n) {}
+    HierarchyNode(const std::string& n) : name(n) {}
 
     void DestroyChildren(entt::registry& registry);
 
@@ -69,7 +69,7 @@ private:
 struct Transform
 {
 public:
-    Transform() { m_dirty = true; }
+    Transform() = default;
     Transform(const glm::vec3& pos, const glm::quat& rot, const glm::vec3& scl);
 
     void SetPosition(const glm::vec3& pos);
@@ -78,17 +78,24 @@ public:
     void SetScale(const glm::vec3& scl);
 
     void RotateAroundAxis(const glm::vec3& axis, float angleDegrees);
+    // Rotates in local space by euler angles in degrees
+    void Rotate(const glm::vec3& eulerDegrees);
+    // Yaw around the world up axis and pitch around the local right axis, pitch is clamped to the limit
+    void AddYawPitch(float yawDegrees, float pitchDegrees, float pitchLimit = 89.0f);
 
     glm::vec3 GetPosition() const { return position; }
     glm::quat GetRotationQuat() const { return rotation; }
-    glm::vec3 GetRotationEuler() const { return rotationEuler; }
+    // Computed from the quaternion, only meant for displaying/editing
+    glm::vec3 GetRotationEuler() const;
     glm::vec3 GetScale() const { return scale; }
 
     glm::vec3 GetDirection() const;
     glm::vec3 GetRight() const;
     glm::vec3 GetUp() const;
 
-    void SetDirty(bool dirty) { m_dirty = dirty; }
+    // Changes every time the local TRS changes. Versions are unique across all transforms, so a copied transform keeps
+    // a version that still matches its values. Default constructed transforms are all identity and share version 0.
+    uint64_t GetVersion() const { return m_version; }
 
     template <class Archive>
     void save(Archive& archive) const
@@ -96,7 +103,6 @@ public:
         make_optional_nvp(archive, "position", position);
         make_optional_nvp(archive, "rotation", rotation);
         make_optional_nvp(archive, "scale", scale);
-        make_optional_nvp(archive, "rotationEuler", rotationEuler);
     }
 
     template <class Archive>
@@ -105,24 +111,62 @@ public:
         make_optional_nvp(archive, "position", position);
         make_optional_nvp(archive, "rotation", rotation);
         make_optional_nvp(archive, "scale", scale);
-        make_optional_nvp(archive, "rotationEuler", rotationEuler);
-        m_dirty = true;
+        MarkChanged();
     }
 
-    const glm::mat4& GetModelMatrix();
+    // Composed from the TRS every call, GetLocalModel reads the cached one when it is up to date
+    glm::mat4 GetModelMatrix() const;
 
     void SetModelMatrix(const glm::mat4& modelMatrix);
 
 private:
     friend class ComponentManager;
 
-    glm::mat4 m_model = glm::mat4(1.0f);
-    bool m_dirty = false;
-
+    // Local TRS, this is what gets read and written every frame. The matrix is kept apart in LocalModel.
     glm::vec3 position = glm::vec3(0.0f);
-    glm::quat rotation = glm::quat(glm::vec3(0.0f));
+    glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
     glm::vec3 scale = glm::vec3(1.0f);
-    glm::vec3 rotationEuler = glm::vec3(0.0f);
+    uint64_t m_version = 0;
+
+    void MarkChanged();
+};
+
+// Cached local matrix of a Transform, in a storage of its own so the transforms stay small. UpdateModelMatrices rebuilds
+// the stale ones in one batch every frame. Not saved, it is rebuilt from the transform.
+struct LocalModel
+{
+    glm::mat4 model = glm::mat4(1.0f);
+    uint64_t version = std::numeric_limits<uint64_t>::max();  // version of the transform it was built from
+};
+
+// The cached matrix when it matches the transform, otherwise it is composed. Only reads, so it is safe from workers.
+static inline glm::mat4 GetLocalModel(const entt::entity entity, entt::registry& registry)
+{
+    const auto& transform = registry.get<Transform>(entity);
+    const auto* local = registry.try_get<LocalModel>(entity);
+    if (local && local->version == transform.GetVersion()) return local->model;
+    return transform.GetModelMatrix();
+}
+
+// Opts the entity in to render interpolation. The local TRS is snapshot after every fixed step and the entity is drawn
+// blended between the last two snapshots, see InterpolationManager. Only the opt-in is saved, the snapshots are runtime.
+struct Interpolated
+{
+    glm::vec3 previousPosition = glm::vec3(0.0f);
+    glm::vec3 currentPosition = glm::vec3(0.0f);
+    glm::quat previousRotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    glm::quat currentRotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    glm::vec3 previousScale = glm::vec3(1.0f);
+    glm::vec3 currentScale = glm::vec3(1.0f);
+    bool initialized = false;  // false until the first snapshot, so a new entity does not blend in from the origin
+
+    // Blended local matrix, drawn instead of the matrix of the transform
+    glm::mat4 model = glm::mat4(1.0f);
+
+    template <class Archive>
+    void serialize(Archive&)
+    {
+    }
 };
 
 #define DEFAULT_MULTIPLY_COLOR glm::vec4(1.0f)
@@ -428,6 +472,7 @@ struct Emitter
     float time = 0.0f;
     int particleCount = 0;
     int id = 0;
+    float budgetScale = 1.0f;  // share of its emission rate and max particles the particle budget allows this frame
 
     // cerial
     template <class Archive>
@@ -444,7 +489,7 @@ struct Emitter
         // archive(cereal::make_nvp("specs", specs), cereal::make_nvp("particleSpecs", particleSpecs));
         make_optional_nvp(archive, "specs", specs);
         make_optional_nvp(archive, "particleSpecs", particleSpecs);
-        id = rand();
+        id = ThreadRandom().Int(0, std::numeric_limits<int>::max());
     }
 };
 #pragma endregion ParticleSystem
@@ -703,9 +748,6 @@ struct CanvasElement
 
 static inline glm::mat4 GetWorldModel(const entt::entity entity, entt::registry& registry)
 {
-    // Check for the Transform component
-    auto& transform = registry.get<Transform>(entity);
-
     // Try to get the HierarchyNode component
     if (auto* hierarchy = registry.try_get<HierarchyNode>(entity))
     {
@@ -721,7 +763,7 @@ static inline glm::mat4 GetWorldModel(const entt::entity entity, entt::registry&
 
                 glm::mat4 parentTransform = GetWorldModel(hierarchy->parent, registry);
                 glm::mat4 translated = glm::translate(glm::mat4(1.0f), uiPosition);
-                return parentTransform * translated * transform.GetModelMatrix();
+                return parentTransform * translated * GetLocalModel(entity, registry);
             }
         }
 
@@ -729,12 +771,30 @@ static inline glm::mat4 GetWorldModel(const entt::entity entity, entt::registry&
         if (hierarchy->parent != entt::null)
         {
             glm::mat4 parentTransform = GetWorldModel(hierarchy->parent, registry);
-            return parentTransform * transform.GetModelMatrix();
+            return parentTransform * GetLocalModel(entity, registry);
         }
     }
 
     // Return the local model matrix if no parent is found
-    return transform.GetModelMatrix();
+    return GetLocalModel(entity, registry);
+}
+
+// Combines the transform versions of the entity and all its parents, changes whenever one of the transforms that
+// GetWorldModel reads changes or the entity gets reparented
+static inline uint64_t GetWorldVersion(entt::entity entity, entt::registry& registry)
+{
+    uint64_t version = 14695981039346656037ull;
+    while (entity != entt::null)
+    {
+        // the entity is mixed in as well so reparenting changes the result
+        const auto* transform = registry.try_get<Transform>(entity);
+        version = (version ^ static_cast<uint64_t>(entt::to_integral(entity))) * 1099511628211ull;
+        version = (version ^ (transform ? transform->GetVersion() : 0)) * 1099511628211ull;
+
+        const auto* hierarchy = registry.try_get<HierarchyNode>(entity);
+        entity = hierarchy ? hierarchy->parent : entt::null;
+    }
+    return version;
 }
 
 static inline void SetWorldModel(entt::entity entity, const glm::mat4& modelMatrix, entt::registry& registry)
@@ -4,6 +4,8 @@
 #include "core/engine.hpp"
 #include "managers/grid_manager.hpp"
 #include "ecs/enttHelper.hpp"
+#include "ecs/uuidIndex.hpp"
+#include "tools/benchmark.hpp"
 
 // Typedef for archive functions
 template <typename Archive>
@@ -66,8 +68,33 @@ void registerComponentForDeserialization(std::string componentName)
     };
 }
 
+// Hierarchy links of an entity by UUID, written after its components. Entity ids change on every load, UUIDs don't.
+struct SerializedLinks
+{
+    uint64_t uuid = 0;  // as saved, a UUID that is already taken gets replaced on load
+    uint64_t parent = 0;
+    std::vector<uint64_t> children;
+
+    template <class Archive>
+    void serialize(Archive& archive)
+    {
+        make_optional_nvp(archive, "uuid", uuid);
+        make_optional_nvp(archive, "parent", parent);
+        make_optional_nvp(archive, "children", children);
+    }
+};
+using LoadedLinks = std::vector<std::pair<entt::entity, SerializedLinks>>;
+
+// Links the loaded entities by their saved UUIDs, first among each other and then to the rest of the registry. Entities
+// saved before links were written fall back to remapping their entity ids.
+void ResolveHierarchyLinks(entt::registry& registry,
+                           std::unordered_map<entt::entity, entt::entity>& entity_mapping,
+                           const LoadedLinks& links);
+
 void saveRegistry(entt::registry& registry, const fs::path& filename);
 void LoadRegistry(entt::registry& registry, const fs::path& filename);
+// Saving and loading stress scenes of several sizes through a temporary file
+std::vector<benchmark::Result> BenchmarkSerialization();
 
 template <class Archive>
 void serializeEntity(Archive& archive, entt::registry& registry, entt::entity entity)
@@ -85,6 +112,15 @@ void serializeEntity(Archive& archive, entt::registry& registry, entt::entity en
             bee::Log::Error("Failed to serialize component {}: {}", name, e.what());
         }
     }
+
+    if (const auto* node = registry.try_get<HierarchyNode>(entity))
+    {
+        SerializedLinks links;
+        links.uuid = ecs::GetUUID(registry, entity);
+        if (node->parent != entt::null) links.parent = ecs::GetUUID(registry, node->parent);
+        for (auto child : node->children) links.children.push_back(ecs::GetUUID(registry, child));
+        make_optional_nvp(archive, "links", links);
+    }
 }
 
 template <class Archive>
@@ -142,7 +178,8 @@ static void ChangeComponentBasedOnJsonString(const std::string& jsonString, entt
 template <class Archive>
 void deserializeEntity(Archive& archive,
                        entt::registry& registry,
-                       std::unordered_map<entt::entity, entt::entity>& entity_mapping)
+                       std::unordered_map<entt::entity, entt::entity>& entity_mapping,
+                       LoadedLinks& links)
 {
     // archive(cereal::make_nvp("entityID", entity));
     entt::entity old_entity;
@@ -181,20 +218,30 @@ void deserializeEntity(Archive& archive,
         }
     }
 
+    SerializedLinks entityLinks;
+    if (make_optional_nvp(archive, "links", entityLinks)) links.emplace_back(new_entity, std::move(entityLinks));
+
     if (!registry.all_of<Saveable>(new_entity))
     {
         registry.emplace<Saveable>(new_entity);
     }
+
+    // scenes saved before entities had a UUID
+    if (!registry.all_of<UUID>(new_entity))
+    {
+        registry.emplace<UUID>(new_entity);
+    }
 }
 
 template <class Archive>
 void deserializeEntityString(const std::string& data,
                              entt::registry& registry,
-                             std::unordered_map<entt::entity, entt::entity>& entity_mapping)
+                             std::unordered_map<entt::entity, entt::entity>& entity_mapping,
+                             LoadedLinks& links)
 {
     std::stringstream is(data);
     Archive archive(is);
-    deserializeEntity(archive, registry, entity_mapping);
+    deserializeEntity(archive, registry, entity_mapping, links);
 }
 
 template <class Archive>
@@ -228,11 +275,12 @@ void deserialize(Archive& archive, entt::registry& registry)
     }
 
     std::unordered_map<entt::entity, entt::entity> entity_mapping;
+    LoadedLinks links;
     for (size_t i = 0; i < entity_count; ++i)
     {
         try
         {
-            deserializeEntity(archive, registry, entity_mapping);
+            deserializeEntity(archive, registry, entity_mapping, links);
         }
         catch (const std::exception& e)
         {
@@ -240,7 +288,7 @@ void deserialize(Archive& archive, entt::registry& registry)
         }
     }
 
-    ecs::UpdateEntityMapping(entity_mapping, registry);
+    ResolveHierarchyLinks(registry, entity_mapping, links);
 
     // loop through every grid component
     auto grid_view = registry.view<bee::Grid, bee::Transform>();
@@ -299,34 +347,17 @@ template <class Archive>
 void deserialize(Archive& archive, entt::registry& registry, entt::entity& entity)
 {
     std::unordered_map<entt::entity, entt::entity> entity_mapping;
+    LoadedLinks links;
     try
     {
-        deserializeEntity(archive, registry, entity_mapping);
+        deserializeEntity(archive, registry, entity_mapping, links);
     }
     catch (const std::exception& e)
     {
         bee::Log::Error("Failed to deserialize entity: {}", e.what());
     }
 
-    for (auto&& [old_entity, new_entity] : entity_mapping)
-    {
-        if (auto* node = registry.try_get<bee::HierarchyNode>(new_entity))
-        {
-            if (node->parent != entt::null && entity_mapping.find(node->parent) != entity_mapping.end())
-            {
-                node->parent = entity_mapping[node->parent];
-            }
-
-            for (auto& child : node->children)
-            {
-                if (entity_mapping.find(child) != entity_mapping.end())
-                {
-                    child = entity_mapping[child];
-                }
-            }
-        }
-    }
-
+    ResolveHierarchyLinks(registry, entity_mapping, links);
     entity = entity_mapping[entity];
 }
 
@@ -4,6 +4,7 @@
 
 #include "common.hpp"
 #include "ecs/components.hpp"
+#include "tools/benchmark.hpp"
 
 namespace bee::ecs
 {
@@ -32,6 +33,9 @@ std::vector<entt::entity> FindEntitiesByName(entt::registry& registry, const std
 
 void RenderEntity(entt::registry& registry, entt::entity entity, const Ref<bee::FrameBuffer>& frameBuffer);
 
+// GetWorldModel at several hierarchy depths and duplicating trees of several sizes
+std::vector<benchmark::Result> BenchmarkHierarchy();
+
 template <typename Component>
 std::vector<entt::entity> GetAllChildrenWithComponent(entt::registry& registry, entt::entity entity)
 {
@@ -0,0 +1,40 @@
+#pragma once
+#include "common.hpp"
+
+namespace bee::ecs
+{
+
+/// <summary>
+/// Maps interned HierarchyNode names to the entities that carry them.
+/// Lives in the registry context and is kept in sync through the HierarchyNode construct/update/destroy signals,
+/// so renames have to go through SetName (or registry.patch) to be picked up.
+/// </summary>
+class NameIndex
+{
+public:
+    const std::vector<entt::entity>& Find(StringId name) const;
+
+    void Add(entt::entity entity, StringId name);
+    void Remove(entt::entity entity);
+    void Rebuild(entt::registry& registry);
+
+    size_t NameCount() const { return m_entities.size(); }
+
+private:
+    std::unordered_map<StringId, std::vector<entt::entity>> m_entities;
+    std::unordered_map<entt::entity, StringId> m_names;
+};
+
+// Returns the name index of the registry, creating and connecting it on first use
+NameIndex& GetNameIndex(entt::registry& registry);
+
+// Renames the entity and updates the name index
+void SetName(entt::registry& registry, entt::entity entity, const std::string& name);
+
+}  // namespace bee::ecs
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
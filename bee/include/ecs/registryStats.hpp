@@ -0,0 +1,67 @@
+#pragma once
+#include "common.hpp"
+
+namespace bee::ecs
+{
+
+// Memory use of a single component storage
+struct StorageStats
+{
+    entt::id_type id = 0;
+    std::string name;
+    size_t size = 0;            // components in use
+    size_t capacity = 0;        // components allocated for (whole pages)
+    size_t packedCapacity = 0;  // entity slots in the packed array
+    size_t extent = 0;          // entity slots in the sparse array
+    size_t componentSize = 0;   // 0 for tag components or unregistered types
+    size_t componentBytes = 0;
+    size_t packedBytes = 0;
+    size_t sparseBytes = 0;
+
+    size_t TotalBytes() const { return componentBytes + packedBytes + sparseBytes; }
+    // bytes that shrinking could give back, the sparse array is only released when the storage is cleared
+    size_t UnusedBytes() const
+    {
+        return (capacity - size) * componentSize + (packedCapacity - size) * sizeof(entt::entity);
+    }
+};
+
+// Memory use of the whole registry, also usable without the editor for soak tests
+struct RegistryStats
+{
+    size_t entities = 0;          // entities in use
+    size_t releasedEntities = 0;  // destroyed identifiers kept for recycling
+    size_t entityBytes = 0;
+    uint32_t maxVersion = 0;      // highest version of any identifier
+    size_t nearVersionWrap = 0;   // identifiers within 1/16th of wrapping their version
+    std::vector<StorageStats> storages;
+
+    size_t TotalBytes() const;
+    size_t UnusedBytes() const;
+};
+
+RegistryStats GetRegistryStats(entt::registry& registry);
+
+// Releases unused capacity of every storage, returns the number of bytes given back
+size_t ShrinkRegistry(entt::registry& registry);
+
+namespace internal
+{
+void RegisterComponentSize(entt::id_type id, size_t size);
+}
+
+// Lets the stats report component bytes for the type, registered components do this automatically
+template <typename Component>
+void RegisterStorageType()
+{
+    internal::RegisterComponentSize(entt::type_hash<Component>::value(),
+                                    entt::component_traits<Component>::page_size == 0u ? 0 : sizeof(Component));
+}
+
+}  // namespace bee::ecs
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
@@ -0,0 +1,110 @@
+#pragma once
+#include "common.hpp"
+#include "ecs/components.hpp"
+#include "tools/benchmark.hpp"
+
+namespace bee::ecs
+{
+
+/// <summary>
+/// In memory copy of every non editor entity and its components.
+/// Used to go in and out of play mode without unloading and reparsing the scene from disk.
+/// Entities are restored with the same identifiers, so selections and references stay valid.
+/// </summary>
+class RegistrySnapshot
+{
+public:
+    struct Storage
+    {
+        entt::id_type id = 0;
+        std::vector<entt::entity> entities;
+        std::shared_ptr<void> values;  // std::vector<Component>, empty for tag components
+        size_t bytes = 0;
+    };
+
+    void Capture(entt::registry& registry);
+    void Restore(entt::registry& registry);
+    void Clear();
+
+    bool Empty() const { return m_entities.empty(); }
+    size_t EntityCount() const { return m_entities.size(); }
+    size_t StorageCount() const { return m_storages.size(); }
+    size_t Bytes() const;
+
+private:
+    std::vector<entt::entity> m_entities;
+    std::vector<Storage> m_storages;
+};
+
+namespace internal
+{
+using CaptureFunction = void (*)(entt::registry& registry, RegistrySnapshot::Storage& storage);
+using RestoreFunction = void (*)(entt::registry& registry, const RegistrySnapshot::Storage& storage);
+
+void RegisterSnapshotFunctions(entt::id_type id, CaptureFunction capture, RestoreFunction restore);
+
+template <typename Component>
+void CaptureStorage(entt::registry& registry, RegistrySnapshot::Storage& snapshot)
+{
+    auto& storage = registry.storage<Component>();
+    const entt::sparse_set& entities = storage;
+    snapshot.entities.reserve(storage.size());
+
+    if constexpr (entt::component_traits<Component>::page_size == 0u)
+    {
+        for (auto entity : entities)
+        {
+            if (registry.all_of<EditorComponent>(entity)) continue;
+            snapshot.entities.push_back(entity);
+        }
+    }
+    else
+    {
+        auto values = std::make_shared<std::vector<Component>>();
+        values->reserve(storage.size());
+        for (auto entity : entities)
+        {
+            if (registry.all_of<EditorComponent>(entity)) continue;
+            snapshot.entities.push_back(entity);
+            values->push_back(storage.get(entity));
+        }
+        snapshot.bytes += values->size() * sizeof(Component);
+        snapshot.values = std::move(values);
+    }
+    snapshot.bytes += snapshot.entities.size() * sizeof(entt::entity);
+}
+
+template <typename Component>
+void RestoreStorage(entt::registry& registry, const RegistrySnapshot::Storage& snapshot)
+{
+    if constexpr (entt::component_traits<Component>::page_size == 0u)
+    {
+        registry.insert<Component>(snapshot.entities.begin(), snapshot.entities.end());
+    }
+    else
+    {
+        auto& values = *std::static_pointer_cast<std::vector<Component>>(snapshot.values);
+        registry.insert<Component>(snapshot.entities.begin(), snapshot.entities.end(), values.begin());
+    }
+}
+}  // namespace internal
+
+// Makes the component type part of play mode snapshots, registered components do this automatically
+template <typename Component>
+void RegisterSnapshotType()
+{
+    internal::RegisterSnapshotFunctions(entt::type_hash<Component>::value(),
+                                        &internal::CaptureStorage<Component>,
+                                        &internal::RestoreStorage<Component>);
+}
+
+// Capture and restore of the currently loaded scene
+std::vector<benchmark::Result> BenchmarkSnapshot();
+
+}  // namespace bee::ecs
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
@@ -0,0 +1,71 @@
+#pragma once
+#include "common.hpp"
+#include "tools/benchmark.hpp"
+
+namespace bee
+{
+class Random;
+}
+
+namespace bee::ecs
+{
+
+// Called for every generated entity, so a game can add its own components (colliders, scripts) to the mix
+using StressSceneDecorator = void (*)(entt::registry& registry, entt::entity entity, Random& random, void* context);
+
+// Shape of a generated scene, the same settings give the same scene on every machine
+struct StressSceneSettings
+{
+    uint64_t seed = 1;
+    int entityCount = 100000;
+    int depth = 4;             // levels of the hierarchy, 1 gives a flat scene
+    int fanOut = 8;            // children per entity
+    float extent = 250.0f;     // roots are spread over a cube of twice this size
+    float childOffset = 2.0f;  // children are placed within this distance of their parent
+
+    // share of the entities that get the component, emitters and lights are never renderable
+    float renderableFraction = 0.8f;
+    float raycastableFraction = 0.5f;
+    float emitterFraction = 0.001f;
+    float pointLightFraction = 0.002f;
+
+    int meshVariety = 3;     // distinct meshes, up to the shared models there are
+    int textureVariety = 4;  // distinct textures, up to the shared textures there are
+
+    StressSceneDecorator decorate = nullptr;
+    void* decorateContext = nullptr;
+};
+
+// What ended up in a generated scene
+struct StressSceneStats
+{
+    size_t entities = 0;
+    size_t roots = 0;
+    size_t renderables = 0;
+    size_t raycastables = 0;
+    size_t emitters = 0;
+    size_t pointLights = 0;
+};
+
+// Adds the scene to the registry, together with one scene data and one directional light. Every number comes from a
+// generator seeded with the settings, so two runs with the same settings create the same entities in the same order.
+StressSceneStats GenerateStressScene(entt::registry& registry, const StressSceneSettings& settings);
+
+// The decorator the editor generates scenes with, a game registers it in OnEngineInit. The context has to stay alive.
+void RegisterStressSceneDecorator(StressSceneDecorator decorate, void* context);
+// Fills in the registered decorator, settings keep their own when none was registered
+void UseRegisteredDecorator(StressSceneSettings& settings);
+
+// Generates into a registry of its own and writes it through saveRegistry, the running scene is not touched
+StressSceneStats SaveStressScene(const StressSceneSettings& settings, const fs::path& path);
+
+// Generating a scene, and whether the same seed gives the same scene twice
+std::vector<benchmark::Result> BenchmarkStressScene();
+
+}  // namespace bee::ecs
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
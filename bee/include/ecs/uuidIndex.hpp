@@ -0,0 +1,43 @@
+#pragma once
+#include "common.hpp"
+
+namespace bee::ecs
+{
+
+/// <summary>
+/// Maps UUID components to their entity. Lives in the registry context and is kept in sync through the UUID
+/// construct/update/destroy signals. A UUID that is already taken by another entity (duplicating, loading the same
+/// prefab twice) is replaced with a fresh one, so every UUID in the registry is unique.
+/// </summary>
+class UUIDIndex
+{
+public:
+    entt::entity Find(uint64_t uuid) const;
+
+    bool Add(entt::entity entity, uint64_t uuid);
+    void Remove(entt::entity entity);
+    void Rebuild(entt::registry& registry);
+
+    size_t Size() const { return m_entities.size(); }
+
+private:
+    std::unordered_map<uint64_t, entt::entity> m_entities;
+    std::unordered_map<entt::entity, uint64_t> m_uuids;
+};
+
+// Returns the UUID index of the registry, creating and connecting it on first use
+UUIDIndex& GetUUIDIndex(entt::registry& registry);
+
+// Returns entt::null if no entity has the UUID
+entt::entity FindEntityByUUID(entt::registry& registry, UUID uuid);
+
+// Returns an invalid UUID (0) if the entity has no UUID component
+UUID GetUUID(const entt::registry& registry, entt::entity entity);
+
+}  // namespace bee::ecs
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
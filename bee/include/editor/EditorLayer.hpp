@@ -114,14 +114,21 @@ private:
     bool m_openSaveAndPlayPopup = false;
     bool m_sceneChangedPopup = false;
     bool m_savePrefabPopup = false;
+    bool m_stressSceneWindow = false;
+    ecs::StressSceneSettings m_stressSceneSettings;
 
     raycasting::Ray m_previousRay;
     fs::path m_loadedSceneName = "";
 
+    // editor scene from before pressing play, restored when stopping
+    ecs::RegistrySnapshot m_playSnapshot;
+
 private:
     static void MainDockSpace(const ImGuiDockNodeFlags dockspace_flags);
     static void ApplyStyle(const bool opt_fullscreen, const ImGuiDockNodeFlags dockspace_flags, bool& dockspaceOpen);
     void MenuBar();
+    void EnterPlayMode();
+    void ExitPlayMode();
     void Viewport(const std::string& windowName, const entt::entity cameraEntity, bool showToolbar);
     void UpdateCameraConfig(const entt::entity cameraEntity) const;
     void SceneHierarchy();
@@ -0,0 +1,36 @@
+#pragma once
+#include "common.hpp"
+#include "tools/benchmark.hpp"
+
+namespace bee
+{
+
+/// <summary>
+/// Smooths out the fixed time step for rendering. After every fixed step the local TRS of each entity with an
+/// Interpolated component is snapshot, and before drawing the last two snapshots are blended with the fraction of a step
+/// that the frame is ahead of the simulation. Entities are drawn up to one fixed step behind, but move every frame.
+/// A transform that changed outside the fixed step, from the editor or a teleport in Update, is drawn as it is.
+/// </summary>
+class InterpolationManager
+{
+public:
+    // Moves the current snapshot to the previous one and takes a new one, after every fixed step
+    static void Snapshot(entt::registry& registry);
+    // Blends the snapshots into the model of every Interpolated component, alpha 1 draws the latest fixed step
+    static void Blend(entt::registry& registry, float alpha);
+
+    // The local matrix to draw the entity with, the blended one when the entity is interpolated
+    static glm::mat4 GetLocalModel(entt::entity entity, entt::registry& registry);
+    // GetWorldModel with the blended matrices of the entity and its parents
+    static glm::mat4 GetWorldModel(entt::entity entity, entt::registry& registry);
+};
+
+// Blending the snapshots of many entities against composing their transforms, and the snapshot copy itself
+std::vector<benchmark::Result> BenchmarkInterpolation();
+
+}  // namespace bee
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
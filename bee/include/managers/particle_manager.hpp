@@ -6,23 +6,35 @@ namespace bee
 class ParticleManager
 {
 public:
+    // Expires particles through the engine timers, call once the registry and timers exist
+    static void Initialize();
     static void Update(float dt);
     static void FixedUpdate(float dt);
     static void Draw();
 
     static void CreateEmitter(Emitter emitter, entt::entity entity = entt::null);
 
+    // Moving and coloring the particles of one emitter in the engine registry, they are removed again afterwards
+    static std::vector<benchmark::Result> Benchmark();
+
 private:
     friend class EngineClass;
     static void UpdateEmitters(float dt);
+    static void ApplyParticleBudget();
+    static void GroupParticles();
     static void UpdateParticleTransforms(float dt);
-    static void UpdateParticleLifetime(float dt);
     static void UpdateParticleColors();
 
+    static void OnLifeTimeConstruct(entt::registry& registry, entt::entity entity);
+    static void OnLifeTimeDestroy(entt::registry& registry, entt::entity entity);
+    static void OnParticlesChanged(entt::registry& registry, entt::entity entity);
+    static void OnParticleExpired(void* context, uint64_t entity);
+
     static void EmitAllParticles(entt::entity emitterEntt);
 
     static void EmitRemainingParticles(entt::entity emitterEntt);
-    static void CreateParticle(entt::entity emitterEntt);
+    // Draws the random properties of all the particles at once
+    static void CreateParticles(entt::entity emitterEntt, int count);
 
 #pragma region Particle Components
     struct ParticlePhysics
@@ -33,9 +45,11 @@ private:
         float rotationSpeed = 0.0f;
     };
 
+    // Scheduled on the engine timers when the component is added, also when a snapshot brings it back
     struct LifeTime
     {
-        float remaining;
+        double expiresAt = 0.0;  // time on Engine.Timers()
+        TimerHandle timer;
     };
 
     struct EmitterID
@@ -1,6 +1,7 @@
 #pragma once
 #include "common.hpp"
 #include "xsr/include/xsr.hpp"
+#include "tools/benchmark.hpp"
 
 namespace bee
 {
@@ -19,6 +20,9 @@ public:
     static void Render(const entt::entity cameraEntity, entt::registry& registry);
     static void RenderUI(const entt::entity cameraEntity, entt::registry& registry);
 
+    // Submitting the renderables of generated scenes, the entries are cleared again so nothing gets drawn
+    static std::vector<benchmark::Result> Benchmark();
+
 private:
     static const glm::mat4& GetWorldModelCache(const entt::entity entity, entt::registry& registry);
 
@@ -22,7 +22,8 @@ public:
     static void Redo();
     static void OnImGuiRender();
 
-    static std::unordered_map<entt::entity, entt::entity> EntityMap;
+    // Entities get recreated by undo/redo, so commands find them again through their UUID
+    static entt::entity ResolveEntity(entt::entity entity, UUID uuid);
 
 private:
     static std::stack<Ref<Command>> m_undoStack;
@@ -56,6 +57,7 @@ public:
 
 private:
     entt::entity m_target;
+    UUID m_targetUUID = UUID(0);
     glm::mat4 m_previousModelMatrix;
     glm::mat4 m_newModelMatrix;
 };
@@ -72,6 +74,7 @@ public:
 private:
     std::string m_entityData;
     entt::entity m_entity;
+    UUID m_entityUUID = UUID(0);
 };
 
 // ====== Delete entity command ======
@@ -89,6 +92,7 @@ public:
 private:
     std::string m_entityData;
     entt::entity m_entity;
+    UUID m_entityUUID = UUID(0);
 };
 
 // ====== any type command ======
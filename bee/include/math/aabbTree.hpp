@@ -0,0 +1,241 @@
+#pragma once
+#include "common.hpp"
+
+namespace bee
+{
+
+struct AABB
+{
+    glm::vec3 min = glm::vec3(0.0f);
+    glm::vec3 max = glm::vec3(0.0f);
+
+    AABB() = default;
+    AABB(const glm::vec3& minimum, const glm::vec3& maximum) : min(minimum), max(maximum) {}
+
+    bool Overlaps(const AABB& other) const
+    {
+        return min.x <= other.max.x && max.x >= other.min.x && min.y <= other.max.y && max.y >= other.min.y &&
+               min.z <= other.max.z && max.z >= other.min.z;
+    }
+
+    bool Contains(const AABB& other) const
+    {
+        return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z && max.x >= other.max.x &&
+               max.y >= other.max.y && max.z >= other.max.z;
+    }
+
+    // Surface area, used as the cost when picking where to insert a leaf
+    float Area() const
+    {
+        glm::vec3 d = max - min;
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    glm::vec3 Center() const { return (min + max) * 0.5f; }
+
+    static AABB Merge(const AABB& a, const AABB& b) { return AABB(glm::min(a.min, b.min), glm::max(a.max, b.max)); }
+
+    // Bounds of a box with the given center, unit axes and half sizes
+    static AABB FromOBB(const glm::vec3& center, const glm::vec3 axes[3], const glm::vec3& halfSizes)
+    {
+        glm::vec3 extent = glm::abs(axes[0]) * halfSizes.x + glm::abs(axes[1]) * halfSizes.y + glm::abs(axes[2]) * halfSizes.z;
+        return AABB(center - extent, center + extent);
+    }
+
+    // Slab test of the segment start + t * (end - start), t in [0, 1]
+    bool IntersectsSegment(const glm::vec3& start, const glm::vec3& end) const;
+};
+
+/// <summary>
+/// Dynamic bounding volume tree, based on the one in Box2D.
+/// Leaves store a fattened AABB so small movements don't touch the tree, only a proxy that leaves its fat bounds
+/// gets reinserted. The tree is kept balanced with rotations on the way up after every insert and remove.
+/// </summary>
+class AABBTree
+{
+public:
+    static constexpr int Null = -1;
+
+    explicit AABBTree(float margin = 0.1f) : m_margin(margin) {}
+
+    int CreateProxy(const AABB& aabb, entt::entity entity);
+    void DestroyProxy(int proxy);
+
+    // Returns true if the proxy had to be reinserted. The displacement stretches the fat bounds in the direction of
+    // movement so moving objects don't get reinserted every step.
+    bool MoveProxy(int proxy, const AABB& aabb, const glm::vec3& displacement = glm::vec3(0.0f));
+
+    const AABB& GetFatAABB(int proxy) const { return m_nodes[proxy].aabb; }
+    entt::entity GetEntity(int proxy) const { return m_nodes[proxy].entity; }
+
+    // Calls fn(proxy) for every leaf whose fat bounds overlap the aabb, stops early when fn returns false
+    template <typename Fn>
+    void Query(const AABB& aabb, Fn&& fn) const;
+
+    // Calls fn(proxy) for every leaf whose fat bounds are touched by the segment, stops early when fn returns false
+    template <typename Fn>
+    void QuerySegment(const glm::vec3& start, const glm::vec3& end, Fn&& fn) const;
+
+    // Calls fn(proxy) for every leaf whose fat bounds pass test(aabb), subtrees that fail the test are skipped.
+    // Stops early when fn returns false. The test is evaluated again for every node, so it can change while querying.
+    template <typename Test, typename Fn>
+    void QueryIf(Test&& test, Fn&& fn) const;
+
+    // Calls fn(proxy) for every node, leaves and branches, used for debug drawing
+    template <typename Fn>
+    void ForEachNode(Fn&& fn) const;
+
+    void Clear();
+
+    size_t ProxyCount() const { return m_proxyCount; }
+    int Height() const { return m_root == Null ? 0 : m_nodes[m_root].height; }
+    size_t ReinsertCount() const { return m_reinserts; }
+    void ResetReinsertCount() { m_reinserts = 0; }
+
+private:
+    struct Node
+    {
+        AABB aabb;
+        entt::entity entity = entt::null;
+        int parent = Null;  // next free node when the node is not in use
+        int child1 = Null;
+        int child2 = Null;
+        int height = 0;  // 0 for leaves, -1 for free nodes
+
+        bool IsLeaf() const { return child1 == Null; }
+    };
+
+    // Nodes still to visit in a query. Balanced trees fit in the fixed part, a degenerate tree spills over into the
+    // vector instead of running off the end.
+    class NodeStack
+    {
+    public:
+        void Push(int node)
+        {
+            if (m_count < fixedSize)
+                m_fixed[m_count++] = node;
+            else
+                m_overflow.push_back(node);
+        }
+
+        int Pop()
+        {
+            if (m_overflow.empty()) return m_fixed[--m_count];
+            const int node = m_overflow.back();
+            m_overflow.pop_back();
+            return node;
+        }
+
+        bool Empty() const { return m_count == 0; }
+
+    private:
+        static constexpr int fixedSize = 64;
+        int m_fixed[fixedSize];
+        int m_count = 0;
+        std::vector<int> m_overflow;  // only used while the fixed part is full
+    };
+
+    std::vector<Node> m_nodes;
+    int m_root = Null;
+    int m_freeList = Null;
+    size_t m_proxyCount = 0;
+    size_t m_reinserts = 0;
+    float m_margin;
+
+    int AllocateNode();
+    void FreeNode(int node);
+    void InsertLeaf(int leaf);
+    void RemoveLeaf(int leaf);
+    int Balance(int node);
+    void Refit(int node);
+};
+
+template <typename Fn>
+void AABBTree::Query(const AABB& aabb, Fn&& fn) const
+{
+    if (m_root == Null) return;
+
+    NodeStack stack;
+    stack.Push(m_root);
+    while (!stack.Empty())
+    {
+        const Node& node = m_nodes[stack.Pop()];
+        if (!node.aabb.Overlaps(aabb)) continue;
+
+        if (node.IsLeaf())
+        {
+            if (!fn(static_cast<int>(&node - m_nodes.data()))) return;
+        }
+        else
+        {
+            stack.Push(node.child1);
+            stack.Push(node.child2);
+        }
+    }
+}
+
+template <typename Fn>
+void AABBTree::QuerySegment(const glm::vec3& start, const glm::vec3& end, Fn&& fn) const
+{
+    if (m_root == Null) return;
+
+    const AABB segmentBounds(glm::min(start, end), glm::max(start, end));
+    NodeStack stack;
+    stack.Push(m_root);
+    while (!stack.Empty())
+    {
+        const Node& node = m_nodes[stack.Pop()];
+        if (!node.aabb.Overlaps(segmentBounds) || !node.aabb.IntersectsSegment(start, end)) continue;
+
+        if (node.IsLeaf())
+        {
+            if (!fn(static_cast<int>(&node - m_nodes.data()))) return;
+        }
+        else
+        {
+            stack.Push(node.child1);
+            stack.Push(node.child2);
+        }
+    }
+}
+
+template <typename Test, typename Fn>
+void AABBTree::QueryIf(Test&& test, Fn&& fn) const
+{
+    if (m_root == Null) return;
+
+    NodeStack stack;
+    stack.Push(m_root);
+    while (!stack.Empty())
+    {
+        const Node& node = m_nodes[stack.Pop()];
+        if (!test(node.aabb)) continue;
+
+        if (node.IsLeaf())
+        {
+            if (!fn(static_cast<int>(&node - m_nodes.data()))) return;
+        }
+        else
+        {
+            stack.Push(node.child1);
+            stack.Push(node.child2);
+        }
+    }
+}
+
+template <typename Fn>
+void AABBTree::ForEachNode(Fn&& fn) const
+{
+    for (size_t i = 0; i < m_nodes.size(); i++)
+    {
+        if (m_nodes[i].height >= 0) fn(static_cast<int>(i));
+    }
+}
+
+}  // namespace bee
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
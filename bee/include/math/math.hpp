@@ -1,5 +1,6 @@
 #pragma once
 #include "common.hpp"
+#include "math/random.hpp"
 
 #define M_PI 3.14159265358979323846
 
@@ -56,39 +57,17 @@ T Damp(T a, T b, float lambda, float dt)
     return Lerp(a, b, 1 - exp(-lambda * dt));
 }
 
+// These draw from the generator of the calling thread, see ThreadRandom
+
 // random direction in a sphere
-static inline glm::vec3 RandomDirectionInSphere()
-{
-    float theta = glm::linearRand(0.0f, 2.0f * glm::pi<float>());
-    float phi = glm::linearRand(0.0f, glm::pi<float>());
-    return glm::vec3(sin(phi) * cos(theta), sin(phi) * sin(theta), cos(phi));
-}
+static inline glm::vec3 RandomDirectionInSphere() { return ThreadRandom().UnitVector(); }
 
-static inline float RandomFloat(float min, float max) { return glm::linearRand(min, max); }
+static inline float RandomFloat(float min, float max) { return ThreadRandom().Float(min, max); }
 
+// angle is the half angle of the cone in degrees
 static inline glm::vec3 RandomDirectionInCone(const glm::vec3& direction, const float angle)
 {
-    // Convert angle from degrees to radians
-    float radianAngle = glm::radians(angle);
-
-    // Generate a random angle within the cone
-    float theta = glm::linearRand(0.0f, 2.0f * glm::pi<float>());
-    float phi = glm::linearRand(0.0f, radianAngle);
-
-    // Spherical coordinates to Cartesian coordinates conversion
-    float x = sin(phi) * cos(theta);
-    float y = sin(phi) * sin(theta);
-    float z = cos(phi);
-
-    // Generate a random vector within the unit sphere in the cone's direction
-    glm::vec3 randomDir = glm::vec3(x, y, z);
-
-    // Align the cone direction with the z-axis and rotate the random direction to match the original direction
-    glm::vec3 up = glm::vec3(0.0f, 0.0f, 1.0f);
-    glm::quat rotation = glm::rotation(up, glm::normalize(direction));
-    randomDir = rotation * randomDir;
-
-    return glm::normalize(randomDir);
+    return ThreadRandom().DirectionInCone(direction, angle);
 }
 }  // namespace bee
 
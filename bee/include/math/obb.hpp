@@ -0,0 +1,66 @@
+#pragma once
+#include "common.hpp"
+#include "tools/benchmark.hpp"
+
+namespace bee
+{
+
+// Oriented bounding box, the axes are expected to be normalized
+struct OBB
+{
+    glm::vec3 center = glm::vec3(0.0f);
+    glm::vec3 axes[3] = {glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f)};
+    glm::vec3 halfSizes = glm::vec3(0.0f);  // including scale
+};
+
+/// <summary>
+/// Four boxes in structure of arrays layout, one box per SIMD lane.
+/// Lanes past count are ignored by the batch tests.
+/// </summary>
+struct OBB4
+{
+    alignas(16) float center[3][4] = {};
+    alignas(16) float axes[3][3][4] = {};  // [axis][component][lane]
+    alignas(16) float halfSizes[3][4] = {};
+    int count = 0;
+
+    void Set(int lane, const OBB& obb);
+    OBB Get(int lane) const;
+};
+
+// Packs the boxes into blocks of four, the last block can be partially filled
+void PackOBBs(const OBB* obbs, size_t count, std::vector<OBB4>& out);
+
+/// <summary>
+/// Separating axis test between two boxes. On overlap returns the smallest penetration and the axis it was found on,
+/// pointing from a to b.
+/// </summary>
+bool OBBOverlap(const OBB& a, const OBB& b, float& penetration, glm::vec3& normal);
+
+/// <summary>
+/// Same test as OBBOverlap, a against all boxes in the block at once.
+/// Returns a bit mask of the lanes that overlap, penetration and normal are only written for those lanes.
+/// </summary>
+int OBBOverlap4(const OBB& a, const OBB4& b, float penetration[4], glm::vec3 normal[4]);
+
+/// <summary>
+/// Intersects the segment from start to end with the box. t is the fraction along the segment of the first hit,
+/// normal the face normal at that point.
+/// </summary>
+bool SegmentOBBIntersection(const glm::vec3& start, const glm::vec3& end, const OBB& obb, float& t, glm::vec3& normal);
+
+/// <summary>
+/// Same test as SegmentOBBIntersection against all boxes in the block at once, returns a bit mask of the lanes hit.
+/// </summary>
+int SegmentOBBIntersection4(const glm::vec3& start, const glm::vec3& end, const OBB4& b, float t[4], glm::vec3 normal[4]);
+
+// Checks the batch tests against the scalar ones on random boxes and times both
+std::vector<benchmark::Result> BenchmarkOBB();
+
+}  // namespace bee
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
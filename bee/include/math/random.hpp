@@ -0,0 +1,78 @@
+#pragma once
+#include "common.hpp"
+#include <limits>
+#include "tools/benchmark.hpp"
+
+namespace bee
+{
+
+/// <summary>
+/// xoshiro256** generator with its state expanded from a 64 bit seed by splitmix64. The same seed gives the same
+/// numbers on every platform. The batch functions fill whole arrays, which is where emitting large bursts of particles
+/// spends its time. Satisfies UniformRandomBitGenerator, so it can be passed to std::shuffle.
+/// </summary>
+class Random
+{
+public:
+    using result_type = uint64_t;
+
+    explicit Random(uint64_t seed = 0x9E3779B97F4A7C15ull) { Seed(seed); }
+
+    void Seed(uint64_t seed);
+
+    uint64_t Next()
+    {
+        const uint64_t result = Rotate(m_state[1] * 5, 7) * 9;
+        const uint64_t t = m_state[1] << 17;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = Rotate(m_state[3], 45);
+        return result;
+    }
+
+    // In [0, 1), from the top 24 bits so every value is exactly representable
+    float Float() { return static_cast<float>(Next() >> 40) * (1.0f / 16777216.0f); }
+    float Float(float min, float max) { return min + (max - min) * Float(); }
+    // In [min, max], both included
+    int Int(int min, int max);
+    uint32_t UInt() { return static_cast<uint32_t>(Next() >> 32); }
+
+    // Uniform over the sphere
+    glm::vec3 UnitVector();
+    // Uniform over the cap around the direction, angle is the half angle of the cone in degrees
+    glm::vec3 DirectionInCone(const glm::vec3& direction, float angle);
+
+    void Floats(float* out, size_t count, float min = 0.0f, float max = 1.0f);
+    void UnitVectors(glm::vec3* out, size_t count);
+    void DirectionsInCone(glm::vec3* out, size_t count, const glm::vec3& direction, float angle);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+    result_type operator()() { return Next(); }
+
+private:
+    uint64_t m_state[4];
+
+    static uint64_t Rotate(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+// The generator of the calling thread. Threads get their own stream of the global seed, numbered by JobSystem::WorkerIndex,
+// so the main thread has stream 0 and worker i has stream i + 1 on every run. Threads outside the pool share stream 0.
+Random& ThreadRandom();
+
+// Reseeds every thread, each generator picks up the new seed the next time its thread calls ThreadRandom
+void SeedRandom(uint64_t seed);
+uint64_t GetRandomSeed();
+
+// Batch generation against drawing every value from glm::linearRand
+std::vector<benchmark::Result> BenchmarkRandom();
+
+}  // namespace bee
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
@@ -0,0 +1,110 @@
+#pragma once
+#include "common.hpp"
+#include "math/aabbTree.hpp"
+#include "tools/benchmark.hpp"
+
+namespace bee
+{
+
+struct TriangleHit
+{
+    float t = 0.0f;  // along the ray, in units of the ray direction
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::vec3 normal = glm::vec3(0.0f);  // face normal, facing the ray
+    glm::vec2 uv = glm::vec2(0.0f);
+    uint32_t triangle = 0;  // index of the triangle in the source index buffer
+};
+
+/// <summary>
+/// Static bounding volume hierarchy over the triangles of a mesh, in the local space of the mesh.
+/// Built once with binned SAH. The two children of a node are stored next to each other and the triangles are
+/// reordered so every leaf covers a contiguous range, a node is 32 bytes.
+/// </summary>
+class TriangleBVH
+{
+public:
+    // indices are a triangle list, normals and uvs can be empty
+    void Build(const std::vector<glm::vec3>& positions,
+               const std::vector<glm::vec3>& normals,
+               const std::vector<glm::vec2>& uvs,
+               const std::vector<uint32_t>& indices);
+    void Clear();
+
+    // Closest triangle hit with t in [0, maxT], both sides of a triangle are hit
+    bool Intersect(const glm::vec3& origin, const glm::vec3& direction, float maxT, TriangleHit& hit) const;
+
+    // Calls fn(triangle) for the triangles in every leaf that touches the box.
+    // Triangles are numbered in the order of the BVH, not of the source index buffer.
+    template <typename Fn>
+    void Query(const AABB& aabb, Fn&& fn) const;
+
+    // Corners, vertex normals and uvs of a triangle in BVH order. The normals are the face normal if the mesh had none.
+    void GetTriangle(uint32_t triangle, glm::vec3& a, glm::vec3& b, glm::vec3& c) const;
+    const glm::vec3* GetNormals(uint32_t triangle) const { return &m_normals[triangle * 3]; }
+    const glm::vec2* GetUVs(uint32_t triangle) const { return &m_uvs[triangle * 3]; }
+
+    bool Empty() const { return m_nodes.empty(); }
+    size_t TriangleCount() const { return m_triangles.size(); }
+    size_t NodeCount() const { return m_nodes.size(); }
+    AABB Bounds() const { return m_nodes.empty() ? AABB() : AABB(m_nodes[0].min, m_nodes[0].max); }
+
+private:
+    static constexpr uint32_t maxLeafSize = 4;
+    static constexpr int maxDepth = 64;
+
+    struct Node
+    {
+        glm::vec3 min;
+        uint32_t leftFirst;  // first triangle for leaves, left child for inner nodes, the right child follows it
+        glm::vec3 max;
+        uint32_t count;  // 0 for inner nodes
+    };
+
+    // Edges are stored instead of the other two corners, that's what the intersection test needs
+    struct Triangle
+    {
+        glm::vec3 v0;
+        glm::vec3 edge1;
+        glm::vec3 edge2;
+    };
+
+    std::vector<Node> m_nodes;
+    std::vector<Triangle> m_triangles;
+    std::vector<glm::vec3> m_normals;  // three per triangle, in the order of m_triangles
+    std::vector<glm::vec2> m_uvs;
+    std::vector<uint32_t> m_sourceTriangles;
+};
+
+// Builds the triangle BVHs of the glTF assets and checks and times raycasts against testing every triangle
+std::vector<benchmark::Result> BenchmarkTriangleBVH();
+
+template <typename Fn>
+void TriangleBVH::Query(const AABB& aabb, Fn&& fn) const
+{
+    if (m_nodes.empty()) return;
+
+    uint32_t stack[maxDepth];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0)
+    {
+        const Node& node = m_nodes[stack[--stackSize]];
+        if (!aabb.Overlaps(AABB(node.min, node.max))) continue;
+
+        if (node.count > 0)
+        {
+            for (uint32_t i = node.leftFirst; i < node.leftFirst + node.count; i++) fn(i);
+            continue;
+        }
+        stack[stackSize++] = node.leftFirst + 1;
+        stack[stackSize++] = node.leftFirst;
+    }
+}
+
+}  // namespace bee
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
@@ -0,0 +1,37 @@
+#pragma once
+#include "common.hpp"
+#include "tools/benchmark.hpp"
+
+namespace bee
+{
+
+/// <summary>
+/// Composes translation * rotation * scale matrices for count transforms.
+/// Processes 4 transforms at a time with SSE when available, the remainder goes through the scalar path.
+/// </summary>
+void ComposeTRS(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales, glm::mat4* out, size_t count);
+
+/// <summary>
+/// Scalar reference of ComposeTRS, same math as Transform::GetModelMatrix.
+/// </summary>
+void ComposeTRSScalar(const glm::vec3* positions,
+                      const glm::quat* rotations,
+                      const glm::vec3* scales,
+                      glm::mat4* out,
+                      size_t count);
+
+/// <summary>
+/// Rebuilds the LocalModel of every Transform that changed since the last call in one batch.
+/// </summary>
+void UpdateModelMatrices(entt::registry& registry);
+
+// Batch kernel vs scalar compose vs Transform::GetModelMatrix
+std::vector<benchmark::Result> BenchmarkComposeTRS();
+
+}  // namespace bee
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
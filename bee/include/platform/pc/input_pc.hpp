@@ -29,6 +29,8 @@ private:
 
     void Update() override;
     void OnEvent(Event& e) override;
+    void GetState(State& state) const override;
+    void SetState(const State& state) override;
 };
 }  // namespace bee
 
@@ -26,6 +26,13 @@ void LoadGLTFFromEntity(const entt::entity& sceneEntity, entt::registry& registr
 void LogGLTFWarningsAndErrors(const std::string& warn, const std::string& err, const fs::path& filePath);
 
 std::vector<unsigned int> ConvertIndicesToUnsignedInt(const tinygltf::Accessor& indexAccessor, const tinygltf::Model& model);
+// Positions, normals, first texture coordinates and triangle indices of the primitive, false if it has no positions
+bool GetPrimitiveGeometry(const tinygltf::Model& model,
+                          const tinygltf::Primitive& primitive,
+                          std::vector<glm::vec3>& positions,
+                          std::vector<glm::vec3>& normals,
+                          std::vector<glm::vec2>& texCoords,
+                          std::vector<unsigned int>& indices);
 Ref<bee::resource::Mesh> CreateMeshHandle(const tinygltf::Model& model,
                                           const tinygltf::Primitive& primitive,
                                           const std::string& name);
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "resource/resource.hpp"
+#include "math/triangleBVH.hpp"
+#include <mutex>
 #include "xsr/include/xsr.hpp"
 
 namespace bee::resource
@@ -21,9 +23,26 @@ public:
 
     bool is_valid() const { return m_handle.is_valid(); }
 
+    // CPU copy of the triangles for exact raycasts, meshes without one are treated as their box
+    void SetGeometry(std::vector<glm::vec3> positions,
+                     std::vector<glm::vec3> normals,
+                     std::vector<glm::vec2> uvs,
+                     std::vector<uint32_t> indices);
+    bool HasGeometry() const;
+
+    // Built on first use and cached, nullptr if the mesh has no geometry. The geometry is released after the build.
+    const TriangleBVH* GetTriangleBVH() const;
+
 private:
     xsr::mesh_handle m_handle;
     bool m_isRendered = false;
+
+    mutable std::mutex m_bvhMutex;
+    mutable std::unique_ptr<TriangleBVH> m_triangleBVH;
+    mutable std::vector<glm::vec3> m_positions;
+    mutable std::vector<glm::vec3> m_normals;
+    mutable std::vector<glm::vec2> m_uvs;
+    mutable std::vector<uint32_t> m_indices;
 };
 
 }  // namespace bee::resource
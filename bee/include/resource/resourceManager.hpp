@@ -5,6 +5,7 @@
 #include "resource/mesh.hpp"
 #include "resource/texture.hpp"
 #include "resource/gltfModel.hpp"
+#include "tools/benchmark.hpp"
 
 namespace bee::resource
 {
@@ -21,6 +22,9 @@ void OnImGuiRender();
 
 void UnloadResources();
 
+// Parsing and uploading the shared meshes and textures, sized by the bytes of the file
+std::vector<benchmark::Result> BenchmarkLoading();
+
 }  // namespace bee::resource
 
 
@@ -1,28 +1,289 @@
 #pragma once
+#include <limits>
+#include <memory>
+#include <vector>
 #include "core.hpp"
 #include "tools/Tweening/tween.hpp"
+#include "tools/benchmark.hpp"
 
+// The value at the address is the start value and is written every update
 #define CREATE_REF_TWEEN(T, address, endValue, duration) \
-    std::make_shared<bee::RefTween<T>>(std::make_shared<T>(address), endValue, duration)
+    bee::Tween<T>((address), endValue, duration).SetTarget(&(address))
 
-#define CREATE_TWEEN(T, startValue, endValue, duration) \
-    std::make_shared<bee::Tween<T>>(startValue, endValue, duration)
+#define CREATE_TWEEN(T, startValue, endValue, duration) bee::Tween<T>(startValue, endValue, duration)
 
 
 namespace bee
 {
-using TweenRef = std::shared_ptr<bee::ITween>;
+
+// Refers to a tween in its pool, it stays safe to use after the tween finished or was removed
+struct TweenHandle
+{
+    uint32_t pool = 0;
+    uint32_t slot = std::numeric_limits<uint32_t>::max();
+    uint32_t generation = 0;
+};
+
+class ITweenPool
+{
+public:
+    virtual ~ITweenPool() = default;
+    virtual void Update(float dt) = 0;
+    virtual bool Remove(const TweenHandle& handle) = 0;
+    virtual bool IsActive(const TweenHandle& handle) const = 0;
+    virtual void Clear() = 0;
+    virtual size_t Size() const = 0;
+};
+
+/// <summary>
+/// The tweens of one value type, stored contiguously and updated in a single pass. A finished tween is swapped with
+/// the last one and popped, handles go through a slot table so they survive the tweens moving around.
+/// Tweens added from a callback start in the next update, removing a tween from a callback takes effect immediately.
+/// </summary>
+template <typename T>
+class TweenPool : public ITweenPool
+{
+public:
+    explicit TweenPool(uint32_t poolIndex = 0) : m_poolIndex(poolIndex) {}
+
+    TweenHandle Add(const Tween<T>& tween);
+    void Update(float dt) override;
+    bool Remove(const TweenHandle& handle) override;
+    bool IsActive(const TweenHandle& handle) const override;
+    void Clear() override;
+    size_t Size() const override { return m_tweens.size() - m_removed + m_added.size(); }
+
+private:
+    static constexpr uint32_t addedBit = 0x80000000u;  // set on the index of a slot whose tween waits in m_added
+
+    struct Slot
+    {
+        uint32_t index;
+        uint32_t generation;
+    };
+
+    std::vector<Tween<T>> m_tweens;
+    std::vector<uint32_t> m_tweenSlots;  // slot of every tween in m_tweens
+    std::vector<Tween<T>> m_added;       // added while updating
+    std::vector<uint32_t> m_addedSlots;
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+    size_t m_removed = 0;  // removed while updating, still in m_tweens until the pass reaches them
+    uint32_t m_poolIndex;
+    bool m_updating = false;
+
+    void Erase(size_t index);
+    void EraseAdded(size_t index);
+    void FreeSlot(uint32_t slot);
+};
+
 class Tweener
 {
 public:
     static void Update(float dt);
 
-    static void AddTween(const TweenRef& tween);
-    static void RemoveTween(const TweenRef& tween);
+    template <typename T>
+    static TweenHandle AddTween(const Tween<T>& tween)
+    {
+        return GetPool<T>().Add(tween);
+    }
+
+    // Returns false if the tween already finished or was removed
+    static bool RemoveTween(const TweenHandle& handle);
+    static bool IsActive(const TweenHandle& handle);
+    static void Clear();
+    static size_t Size();
+
+    template <typename T>
+    static TweenPool<T>& GetPool()
+    {
+        static TweenPool<T>& pool = CreatePool<T>();
+        return pool;
+    }
+
+private:
+    static std::vector<std::unique_ptr<ITweenPool>>& Pools();
+
+    template <typename T>
+    static TweenPool<T>& CreatePool()
+    {
+        auto& pools = Pools();
+        pools.push_back(std::make_unique<TweenPool<T>>(static_cast<uint32_t>(pools.size())));
+        return static_cast<TweenPool<T>&>(*pools.back());
+    }
 };
+
+// Times updating, finishing and removing thousands of tweens
+std::vector<benchmark::Result> BenchmarkTween();
+
+template <typename T>
+TweenHandle TweenPool<T>::Add(const Tween<T>& tween)
+{
+    uint32_t slot;
+    if (!m_freeSlots.empty())
+    {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else
+    {
+        slot = static_cast<uint32_t>(m_slots.size());
+        m_slots.push_back({0, 0});
+    }
+
+    // the pass only reads m_tweens, growing it from a callback would move the tween that is being updated
+    auto& tweens = m_updating ? m_added : m_tweens;
+    auto& slots = m_updating ? m_addedSlots : m_tweenSlots;
+    m_slots[slot].index = static_cast<uint32_t>(tweens.size()) | (m_updating ? addedBit : 0u);
+    tweens.push_back(tween);
+    slots.push_back(slot);
+
+    Tween<T>& added = tweens.back();
+    added.m_elapsed = 0.0f;
+    added.m_alive = true;
+    if (added.m_target) added.m_startValue = *added.m_target;
+
+    return {m_poolIndex, slot, m_slots[slot].generation};
+}
+
+template <typename T>
+void TweenPool<T>::Update(float dt)
+{
+    m_updating = true;
+    for (size_t i = 0; i < m_tweens.size();)
+    {
+        Tween<T>& tween = m_tweens[i];
+        if (!tween.m_alive)
+        {
+            m_removed--;
+            Erase(i);
+            continue;
+        }
+
+        tween.m_elapsed += dt;
+        const bool finished = tween.m_elapsed >= tween.m_duration;
+        const float t = finished ? 1.0f : tween.m_elapsed / tween.m_duration;
+        const T value = bee::easeLerp(tween.m_startValue, tween.m_endValue, t, tween.m_ease);
+
+        if (tween.m_target) *tween.m_target = finished ? tween.m_endValue : value;
+        if (tween.m_onUpdate) tween.m_onUpdate(tween.m_updateContext, value, t);
+
+        // removed by its own callback, erased at the top of the loop
+        if (!tween.m_alive) continue;
+        if (!finished)
+        {
+            i++;
+            continue;
+        }
+
+        if (tween.m_onComplete) tween.m_onComplete(tween.m_completeContext, tween.m_endValue);
+        if (tween.m_alive)
+            FreeSlot(m_tweenSlots[i]);
+        else
+            m_removed--;
+        Erase(i);
+    }
+    m_updating = false;
+
+    for (size_t i = 0; i < m_added.size(); i++)
+    {
+        m_slots[m_addedSlots[i]].index = static_cast<uint32_t>(m_tweens.size());
+        m_tweens.push_back(m_added[i]);
+        m_tweenSlots.push_back(m_addedSlots[i]);
+    }
+    m_added.clear();
+    m_addedSlots.clear();
+}
+
+template <typename T>
+bool TweenPool<T>::Remove(const TweenHandle& handle)
+{
+    if (!IsActive(handle)) return false;
+
+    const uint32_t index = m_slots[handle.slot].index;
+    FreeSlot(handle.slot);
+    if (index & addedBit)
+    {
+        EraseAdded(index & ~addedBit);
+    }
+    else if (m_updating)
+    {
+        m_tweens[index].m_alive = false;
+        m_removed++;
+    }
+    else
+    {
+        Erase(index);
+    }
+    return true;
+}
+
+template <typename T>
+bool TweenPool<T>::IsActive(const TweenHandle& handle) const
+{
+    return handle.slot < m_slots.size() && m_slots[handle.slot].generation == handle.generation;
+}
+
+template <typename T>
+void TweenPool<T>::Clear()
+{
+    for (size_t i = 0; i < m_tweens.size(); i++)
+    {
+        if (!m_tweens[i].m_alive) continue;
+        FreeSlot(m_tweenSlots[i]);
+        m_tweens[i].m_alive = false;
+    }
+    for (uint32_t slot : m_addedSlots) FreeSlot(slot);
+    m_added.clear();
+    m_addedSlots.clear();
+
+    if (m_updating)
+    {
+        m_removed = m_tweens.size();
+        return;
+    }
+    m_tweens.clear();
+    m_tweenSlots.clear();
+    m_removed = 0;
+}
+
+template <typename T>
+void TweenPool<T>::Erase(size_t index)
+{
+    if (index + 1 < m_tweens.size())
+    {
+        m_tweens[index] = m_tweens.back();
+        m_tweenSlots[index] = m_tweenSlots.back();
+        // a removed tween no longer owns its slot, it may already belong to a new tween
+        if (m_tweens[index].m_alive) m_slots[m_tweenSlots[index]].index = static_cast<uint32_t>(index);
+    }
+    m_tweens.pop_back();
+    m_tweenSlots.pop_back();
+}
+
+template <typename T>
+void TweenPool<T>::EraseAdded(size_t index)
+{
+    if (index + 1 < m_added.size())
+    {
+        m_added[index] = m_added.back();
+        m_addedSlots[index] = m_addedSlots.back();
+        m_slots[m_addedSlots[index]].index = static_cast<uint32_t>(index) | addedBit;
+    }
+    m_added.pop_back();
+    m_addedSlots.pop_back();
+}
+
+template <typename T>
+void TweenPool<T>::FreeSlot(uint32_t slot)
+{
+    m_slots[slot].generation++;
+    m_freeSlots.push_back(slot);
+}
+
 }  // namespace bee
 
 
 /*
 Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
-*/
\ No newline at end of file
+*/
@@ -0,0 +1,75 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+#include <filesystem>
+#include "tools/log.hpp"
+
+namespace bee::benchmark
+{
+
+struct Result
+{
+    std::string group;  // the registered benchmark it came from
+    std::string name;
+    size_t size = 0;  // problem size for benchmarks that run at several, 0 otherwise
+    size_t operations = 0;
+    double nsPerOp = 0.0;
+    double totalMs = 0.0;
+    double bytesPerOp = 0.0;  // allocated on the calling thread, frees are not subtracted. Only counted in bee_bench.
+    double allocationsPerOp = 0.0;
+};
+
+using BenchmarkFunction = std::function<std::vector<Result>()>;
+
+/// <summary>
+/// Times the function, which should perform the given amount of operations, and keeps the fastest of the repeats.
+/// Allocations are counted while it runs, of the repeats the one that allocated least is kept, so pools and vectors
+/// that only grow in the warm up run don't count.
+/// </summary>
+Result Measure(const std::string& name, size_t operations, const std::function<void()>& function, int repeats = 5);
+
+// Measure for one of the sizes a benchmark runs at, the size is kept apart from the name so builds can be compared
+Result MeasureSize(const std::string& name,
+                   size_t size,
+                   size_t operations,
+                   const std::function<void()>& function,
+                   int repeats = 5);
+
+// Called by the operator new that bee_bench replaces, counts the allocation when it happens inside Measure
+void CountAllocation(size_t size);
+
+// Keeps the message of a check that did not hold, Fail formats it
+void AddFailure(const std::string& message);
+
+// Reports a correctness check inside a benchmark that did not hold. It is logged as an error and kept until the next
+// RunAll, bee_bench exits with an error when any check failed.
+template <typename FormatString, typename... Args>
+void Fail(const FormatString& format, const Args&... args)
+{
+    AddFailure(fmt::format(format, args...));
+}
+
+// Keeps the value alive so the compiler can't optimize the benchmarked work away
+void DoNotOptimize(const void* value);
+
+// Registered benchmarks can be run from the profiler window
+void Register(const std::string& name, BenchmarkFunction function);
+
+const std::vector<Result>& RunAll();
+const std::vector<Result>& GetResults();
+const std::vector<std::string>& GetFailures();
+
+// Writes the last results and failed checks with the build they came from, returns false if the file could not be written
+bool WriteJson(const std::filesystem::path& path);
+
+// Draws the benchmark table inside the current ImGui window
+void OnImGuiRender();
+
+}  // namespace bee::benchmark
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
@@ -3,9 +3,13 @@
 // This header file was created by Chatgpt. Could I have made it myself, yes. But just asking chatgpt to do it is faster and
 // easier.
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <functional>
 #include <stdexcept>
+#include <type_traits>
+#include "tools/benchmark.hpp"
 
 namespace bee
 {
@@ -35,71 +39,168 @@ inline T lerp(const T& a, const T& b, float t)
 }
 
 // https://easings.net/
-inline std::function<float(float)> getEaseFunction(EaseType easeType)
+// The curve is picked at compile time, there is no call through a pointer and the InOut curves only select between
+// two values, so loops over these vectorize.
+template <EaseType Type>
+inline float ease(float t)
+{
+    if constexpr (Type == EaseType::Linear)
+        return t;
+    else if constexpr (Type == EaseType::EaseInQuad)
+        return t * t;
+    else if constexpr (Type == EaseType::EaseOutQuad)
+        return t * (2.0f - t);
+    else if constexpr (Type == EaseType::EaseInOutQuad)
+        return t < 0.5f ? 2.0f * t * t : -1.0f + (4.0f - 2.0f * t) * t;
+    else if constexpr (Type == EaseType::EaseInCubic)
+        return t * t * t;
+    else if constexpr (Type == EaseType::EaseOutCubic)
+    {
+        const float u = t - 1.0f;
+        return u * u * u + 1.0f;
+    }
+    else if constexpr (Type == EaseType::EaseInOutCubic)
+        return t < 0.5f ? 4.0f * t * t * t : (t - 1.0f) * (2.0f * t - 2.0f) * (2.0f * t - 2.0f) + 1.0f;
+    else if constexpr (Type == EaseType::EaseInQuart)
+        return t * t * t * t;
+    else if constexpr (Type == EaseType::EaseOutQuart)
+    {
+        const float u = t - 1.0f;
+        return 1.0f - u * u * u * u;
+    }
+    else if constexpr (Type == EaseType::EaseInOutQuart)
+    {
+        const float u = t - 1.0f;
+        return t < 0.5f ? 8.0f * t * t * t * t : 1.0f - 8.0f * u * u * u * u;
+    }
+    else if constexpr (Type == EaseType::EaseInQuint)
+        return t * t * t * t * t;
+    else if constexpr (Type == EaseType::EaseOutQuint)
+    {
+        const float u = t - 1.0f;
+        return 1.0f + u * u * u * u * u;
+    }
+    else if constexpr (Type == EaseType::EaseInOutQuint)
+    {
+        const float u = t - 1.0f;
+        return t < 0.5f ? 16.0f * t * t * t * t * t : 1.0f + 16.0f * u * u * u * u * u;
+    }
+    else
+        static_assert(Type == EaseType::Linear, "Unsupported ease type.");
+}
+
+// One ease curve over count values
+template <EaseType Type>
+inline void easeBatch(const float* t, float* out, size_t count)
+{
+    for (size_t i = 0; i < count; i++) out[i] = ease<Type>(t[i]);
+}
+
+// Calls fn with std::integral_constant<EaseType, easeType>, so a runtime type picks a compile time curve in one switch
+template <typename Fn>
+inline decltype(auto) dispatchEase(EaseType easeType, Fn&& fn)
 {
     switch (easeType)
     {
         case EaseType::Linear:
-            return [](float t) { return t; };
+            return fn(std::integral_constant<EaseType, EaseType::Linear>{});
         case EaseType::EaseInQuad:
-            return [](float t) { return t * t; };
+            return fn(std::integral_constant<EaseType, EaseType::EaseInQuad>{});
         case EaseType::EaseOutQuad:
-            return [](float t) { return t * (2 - t); };
+            return fn(std::integral_constant<EaseType, EaseType::EaseOutQuad>{});
         case EaseType::EaseInOutQuad:
-            return [](float t) { return t < 0.5f ? 2 * t * t : -1 + (4 - 2 * t) * t; };
+            return fn(std::integral_constant<EaseType, EaseType::EaseInOutQuad>{});
         case EaseType::EaseInCubic:
-            return [](float t) { return t * t * t; };
+            return fn(std::integral_constant<EaseType, EaseType::EaseInCubic>{});
         case EaseType::EaseOutCubic:
-            return [](float t)
-            {
-                t -= 1;
-                return t * t * t + 1;
-            };
+            return fn(std::integral_constant<EaseType, EaseType::EaseOutCubic>{});
         case EaseType::EaseInOutCubic:
-            return [](float t) { return t < 0.5f ? 4 * t * t * t : (t - 1) * (2 * t - 2) * (2 * t - 2) + 1; };
+            return fn(std::integral_constant<EaseType, EaseType::EaseInOutCubic>{});
         case EaseType::EaseInQuart:
-            return [](float t) { return t * t * t * t; };
+            return fn(std::integral_constant<EaseType, EaseType::EaseInQuart>{});
         case EaseType::EaseOutQuart:
-            return [](float t)
-            {
-                t -= 1;
-                return 1 - t * t * t * t;
-            };  // Fixes modification
+            return fn(std::integral_constant<EaseType, EaseType::EaseOutQuart>{});
         case EaseType::EaseInOutQuart:
-            return [](float t)
-            {
-                if (t < 0.5f)
-                {
-                    return 8 * t * t * t * t;
-                }
-                else
-                {
-                    t -= 1;  // Decrement `t` before using it
-                    return 1 - 8 * t * t * t * t;
-                }
-            };
+            return fn(std::integral_constant<EaseType, EaseType::EaseInOutQuart>{});
         case EaseType::EaseInQuint:
-            return [](float t) { return t * t * t * t * t; };
+            return fn(std::integral_constant<EaseType, EaseType::EaseInQuint>{});
         case EaseType::EaseOutQuint:
-            return [](float t)
-            {
-                t -= 1;
-                return 1 + t * t * t * t * t;
-            };  // Fixes modification
+            return fn(std::integral_constant<EaseType, EaseType::EaseOutQuint>{});
         case EaseType::EaseInOutQuint:
-            return [](float t)
-            { return t < 0.5f ? 16 * t * t * t * t * t : (t -= 1, 1 + 16 * t * t * t * t * t); };  // Fixes modification
+            return fn(std::integral_constant<EaseType, EaseType::EaseInOutQuint>{});
         default:
             throw std::invalid_argument("Unsupported m_ease type.");
     }
 }
 
+inline float ease(EaseType easeType, float t)
+{
+    return dispatchEase(easeType, [t](auto type) { return ease<decltype(type)::value>(t); });
+}
+
+// Switches once for the whole batch
+inline void easeBatch(EaseType easeType, const float* t, float* out, size_t count)
+{
+    dispatchEase(easeType, [&](auto type) { easeBatch<decltype(type)::value>(t, out, count); });
+}
+
+// For code that wants to keep the curve around, calling through the std::function costs more than ease(easeType, t)
+inline std::function<float(float)> getEaseFunction(EaseType easeType)
+{
+    return dispatchEase(easeType,
+                        [](auto type) -> std::function<float(float)>
+                        {
+                            float (*function)(float) = &ease<decltype(type)::value>;
+                            return function;
+                        });
+}
+
 template <typename T>
 inline T easeLerp(const T& a, const T& b, float t, EaseType easeType)
 {
-    auto easeFunc = getEaseFunction(easeType);
-    float easedT = easeFunc(t);
-    return lerp<T>(a, b, easedT);
+    return lerp<T>(a, b, ease(easeType, t));
+}
+
+// Benchmarks the batch kernels of every ease type against evaluating through getEaseFunction
+std::vector<benchmark::Result> BenchmarkEase();
+
+// Every ease curve baked into a table of easeTableSize entries over [0, 1]. Sampling interpolates linearly between
+// the entries and stays within easeTableMaxError of the exact curve, the steepest curve (EaseInOutQuint) sets the bound.
+constexpr int easeTableSize = 256;
+constexpr float easeTableMaxError = 1e-4f;
+
+inline const float* getEaseTable(EaseType easeType)
+{
+    // built once, the first time any table is needed
+    static const auto tables = []()
+    {
+        std::array<std::array<float, easeTableSize>, static_cast<size_t>(EaseType::Count)> result;
+        for (size_t type = 0; type < result.size(); type++)
+        {
+            const EaseType curve = static_cast<EaseType>(type);
+            for (int i = 0; i < easeTableSize; i++)
+                result[type][i] = ease(curve, static_cast<float>(i) / static_cast<float>(easeTableSize - 1));
+        }
+        return result;
+    }();
+    return tables[static_cast<size_t>(easeType)].data();
+}
+
+// t is clamped to [0, 1], NaN counts as 0 so it can't index outside the table
+inline float sampleEase(const float* table, float t)
+{
+    const float x = (t > 0.0f ? std::min(t, 1.0f) : 0.0f) * static_cast<float>(easeTableSize - 1);
+    const int i = std::min(static_cast<int>(x), easeTableSize - 2);
+    const float fraction = x - static_cast<float>(i);
+    return table[i] + (table[i + 1] - table[i]) * fraction;
+}
+
+inline float sampleEase(EaseType easeType, float t) { return sampleEase(getEaseTable(easeType), t); }
+
+inline void sampleEase(EaseType easeType, const float* t, float* out, size_t count)
+{
+    const float* table = getEaseTable(easeType);
+    for (size_t i = 0; i < count; i++) out[i] = sampleEase(table, t[i]);
 }
 
 }  // namespace bee
@@ -23,6 +23,8 @@ private:
 
 void BeginSection(const std::string& name);
 void EndSection(const std::string& name);
+// Shows a named value under Counters in the profiler window, like a cache hit rate or an object count
+void SetCounter(const std::string& name, float value);
 void OnImGuiRender();
 
 time_t now();
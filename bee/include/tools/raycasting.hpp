@@ -2,6 +2,8 @@
 
 #include <glm/glm.hpp>
 #include <entt/entt.hpp>
+#include "math/aabbTree.hpp"
+#include "resource/mesh.hpp"
 
 namespace bee
 {
@@ -14,6 +16,7 @@ struct HitInfo
     float distance;
     glm::vec3 position;
     glm::vec3 normal;
+    glm::vec2 uv = glm::vec2(0.0f);  // only set by mesh hits
 };
 
 struct Ray
@@ -27,12 +30,164 @@ struct Ray
     glm::vec3 GetPoint(float distance) const { return origin + direction * distance; }
 
     HitInfo IntersectTransform(glm::mat4 transform, glm::vec3 min, glm::vec3 max) const;
+    // Same as above with the inverse of the transform already known
+    HitInfo IntersectTransform(const glm::mat4& transform, const glm::mat4& inverse, glm::vec3 min, glm::vec3 max) const;
+};
+
+// Six planes pointing inwards, xyz is the normal and w the distance
+struct Frustum
+{
+    glm::vec4 planes[6];
+
+    static Frustum FromViewProjection(const glm::mat4& viewProjection);
+    // Frustum through a rectangle on the screen, in normalized device coordinates, used for marquee selection
+    static Frustum FromScreenRect(const glm::mat4& viewProjection, const glm::vec2& ndcMin, const glm::vec2& ndcMax);
+
+    // Conservative, can return true for boxes just outside a corner of the frustum
+    bool Intersects(const AABB& aabb) const;
 };
 
 glm::vec3 GetEntityScaler(const entt::registry& registry, entt::entity entity);
 glm::vec3 GetEntityOffset(const entt::registry& registry, entt::entity entity);
 HitInfo IntersectRayWithEntity(const Ray& ray, const glm::mat4& transform, const glm::vec3& scaler = glm::vec3(1.0f));
 
+// Exact hit on the triangles of the mesh, uses the mesh box when the mesh has no triangle BVH.
+// The distance is in units of the ray direction.
+HitInfo IntersectRayWithMesh(const Ray& ray, const glm::mat4& transform, const resource::Mesh& mesh);
+
+struct SceneHit
+{
+    entt::entity entity = entt::null;
+    HitInfo info = {false, 0.0f, glm::vec3(0.0f), glm::vec3(0.0f)};  // distance is in world units
+};
+
+/// <summary>
+/// Bounding volume hierarchy over the Raycastable entities, with the same boxes the editor draws for them.
+/// Update only touches entities whose transform, parents or mesh changed: their proxies get refit and are only
+/// reinserted when they leave their fat bounds, so the tree keeps its incremental insert order.
+/// The engine updates it once per frame before drawing, call Update again when a query needs positions from this frame.
+/// </summary>
+class SceneBVH
+{
+public:
+    void Update(entt::registry& registry);
+    void Rebuild(entt::registry& registry);
+    void Clear();
+
+    // Closest hit along the ray, filter(entity) returns false for entities that should be ignored
+    template <typename Filter>
+    SceneHit Raycast(const Ray& ray, float maxDistance, Filter&& filter) const;
+    SceneHit Raycast(const Ray& ray, float maxDistance = std::numeric_limits<float>::max()) const;
+
+    // True if anything is hit between start and end, stops at the first hit. Meant for line of sight checks.
+    template <typename Filter>
+    bool Linecast(const glm::vec3& start, const glm::vec3& end, Filter&& filter) const;
+    bool Linecast(const glm::vec3& start, const glm::vec3& end) const;
+
+    // Appends all entities whose box touches the frustum
+    template <typename Filter>
+    void QueryFrustum(const Frustum& frustum, std::vector<entt::entity>& out, Filter&& filter) const;
+    void QueryFrustum(const Frustum& frustum, std::vector<entt::entity>& out) const;
+
+    const AABBTree& Tree() const { return m_tree; }
+    size_t Size() const { return m_entries.size(); }
+    size_t ChangedCount() const { return m_changed; }  // entities updated by the last Update
+
+    // Test the triangles of meshes that have a triangle BVH instead of their box, on by default
+    void SetExactMeshes(bool exact) { m_exactMeshes = exact; }
+    bool GetExactMeshes() const { return m_exactMeshes; }
+
+private:
+    struct Entry
+    {
+        glm::mat4 model;
+        glm::mat4 inverse;
+        glm::vec3 halfSize;
+        glm::vec3 scaler;
+        glm::vec3 offset;
+        Ref<resource::Mesh> mesh;  // null for cells and entities without a visible mesh
+        AABB bounds;
+        uint64_t version = 0;
+        int proxy = AABBTree::Null;
+        uint32_t stamp = 0;
+    };
+
+    AABBTree m_tree = AABBTree(0.1f);
+    std::unordered_map<entt::entity, Entry> m_entries;
+    uint32_t m_stamp = 0;
+    size_t m_changed = 0;
+    bool m_exactMeshes = true;
+
+    // Exact test against the box or the triangles of the entry, the ray direction has to be normalized
+    bool IntersectEntry(const Entry& entry, const Ray& ray, float maxDistance, HitInfo& hit) const;
+    const Entry& GetEntry(int proxy) const { return m_entries.find(m_tree.GetEntity(proxy))->second; }
+    static bool RayHitsBounds(const AABB& aabb, const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance);
+};
+
+// Returns the scene BVH of the registry, it's created on first use
+SceneBVH& GetSceneBVH(entt::registry& registry);
+
+template <typename Filter>
+SceneHit SceneBVH::Raycast(const Ray& ray, float maxDistance, Filter&& filter) const
+{
+    SceneHit closest;
+    const glm::vec3 direction = glm::normalize(ray.direction);
+    const Ray unitRay(ray.origin, direction);
+    const glm::vec3 inverseDirection = 1.0f / direction;
+    float closestDistance = maxDistance;
+
+    // the test reads the closest hit so far, so subtrees behind it are skipped
+    m_tree.QueryIf([&](const AABB& aabb) { return RayHitsBounds(aabb, ray.origin, inverseDirection, closestDistance); },
+                   [&](int proxy)
+                   {
+                       const entt::entity entity = m_tree.GetEntity(proxy);
+                       if (!filter(entity)) return true;
+
+                       HitInfo hit;
+                       if (IntersectEntry(GetEntry(proxy), unitRay, closestDistance, hit))
+                       {
+                           closestDistance = hit.distance;
+                           closest.entity = entity;
+                           closest.info = hit;
+                       }
+                       return true;
+                   });
+    return closest;
+}
+
+template <typename Filter>
+bool SceneBVH::Linecast(const glm::vec3& start, const glm::vec3& end, Filter&& filter) const
+{
+    const float length = glm::length(end - start);
+    if (length <= 0.0f) return false;
+
+    const Ray ray(start, (end - start) / length);
+    bool blocked = false;
+    m_tree.QuerySegment(start,
+                        end,
+                        [&](int proxy)
+                        {
+                            if (!filter(m_tree.GetEntity(proxy))) return true;
+                            HitInfo hit;
+                            blocked = IntersectEntry(GetEntry(proxy), ray, length, hit);
+                            return !blocked;
+                        });
+    return blocked;
+}
+
+template <typename Filter>
+void SceneBVH::QueryFrustum(const Frustum& frustum, std::vector<entt::entity>& out, Filter&& filter) const
+{
+    m_tree.QueryIf([&](const AABB& aabb) { return frustum.Intersects(aabb); },
+                   [&](int proxy)
+                   {
+                       const entt::entity entity = m_tree.GetEntity(proxy);
+                       // the fat bounds passed, check the real ones
+                       if (filter(entity) && frustum.Intersects(GetEntry(proxy).bounds)) out.push_back(entity);
+                       return true;
+                   });
+}
+
 };  // namespace raycasting
 }  // namespace bee
 
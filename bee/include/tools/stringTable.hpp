@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+namespace bee
+{
+
+// Id into the global string table, 0 is always the empty string
+using StringId = uint32_t;
+
+namespace strings
+{
+// Returns the id of the string, adding it to the table if it is not in there yet
+StringId Intern(std::string_view str);
+
+// Looks up a string without adding it, returns false if it was never interned
+bool Find(std::string_view str, StringId& outId);
+
+// Returns the interned string, the reference stays valid for the lifetime of the program
+const std::string& Get(StringId id);
+
+// Hash of the interned string, computed once when the string is added
+size_t GetHash(StringId id);
+
+// Amount of unique strings in the table
+size_t Count();
+}  // namespace strings
+
+/// <summary>
+/// Interned string. Only stores the id of the string, so copying and comparing is as cheap as an integer.
+/// Serializes as a plain string so existing scene files stay compatible.
+/// </summary>
+class Name
+{
+public:
+    Name() = default;
+    Name(std::string_view str) : m_id(strings::Intern(str)) {}
+    Name(const std::string& str) : m_id(strings::Intern(str)) {}
+    Name(const char* str) : m_id(strings::Intern(str)) {}
+
+    const std::string& str() const { return strings::Get(m_id); }
+    const char* c_str() const { return str().c_str(); }
+    StringId id() const { return m_id; }
+    size_t hash() const { return strings::GetHash(m_id); }
+    bool empty() const { return m_id == 0; }
+
+    operator const std::string&() const { return str(); }
+
+    bool operator==(const Name& other) const { return m_id == other.m_id; }
+    bool operator!=(const Name& other) const { return m_id != other.m_id; }
+
+    template <class Archive>
+    std::string save_minimal(const Archive&) const
+    {
+        return str();
+    }
+
+    template <class Archive>
+    void load_minimal(const Archive&, const std::string& value)
+    {
+        m_id = strings::Intern(value);
+    }
+
+private:
+    StringId m_id = 0;
+};
+
+}  // namespace bee
+
+template <>
+struct std::hash<bee::Name>
+{
+    size_t operator()(const bee::Name& name) const noexcept { return name.hash(); }
+};
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
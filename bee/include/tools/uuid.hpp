@@ -1,14 +1,55 @@
 #pragma once
 #include <stdint.h>
 #include <string>
+#include <functional>
 
 // Got this uuid class from the Hazel engine
 namespace bee
 {
 
+/// <summary>
+/// Stable 64 bit identifier. Used as a component so entities can be found again after they are recreated
+/// by undo/redo, scene loading or play mode, which all hand out new entt identifiers.
+/// </summary>
+class UUID
+{
+public:
+    UUID();
+    UUID(uint64_t uuid);
+    UUID(const UUID&) = default;
+
+    operator uint64_t() const { return m_UUID; }
+
+    bool IsValid() const { return m_UUID != 0; }
+
+    template <class Archive>
+    uint64_t save_minimal(const Archive&) const
+    {
+        return m_UUID;
+    }
+
+    template <class Archive>
+    void load_minimal(const Archive&, const uint64_t& value)
+    {
+        m_UUID = value;
+    }
+
+private:
+    uint64_t m_UUID;
+};
+
+}  // namespace bee
+
+namespace std
+{
+template <>
+struct hash<bee::UUID>
+{
+    size_t operator()(const bee::UUID& uuid) const { return std::hash<uint64_t>()(static_cast<uint64_t>(uuid)); }
+};
 }  // namespace std
 
 
 /*
 Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
-*/
\ No newline at end of file
+*/
@@ -3,6 +3,7 @@
 #include "imgui/ImGuiLayer.h"
 #include "editor/EditorLayer.hpp"
 #include "managers/particle_manager.hpp"
+#include <random>
 
 using namespace bee;
 
@@ -13,11 +14,24 @@ void EngineClass::Initialize(const EngineSettings& settings)
 {
     m_settings = settings;
     Log::Initialize();
+
+    // seeded on the main thread first, so it gets the first stream
+    std::random_device device;
+    const uint64_t seed = settings.randomSeed != 0 ? settings.randomSeed : (static_cast<uint64_t>(device()) << 32) | device();
+    bee::SeedRandom(seed);
+    bee::Log::Info("Random seed {}", seed);
+
     m_fileIO = new bee::FileIO();
     m_device = bee::Device::Create();
     m_input = bee::Input::Create();
     m_audio = new bee::Audio();
+    m_jobs = new bee::JobSystem();
+    m_timers = new bee::TimerWheel();
+    m_replay = new bee::InputReplay();
+    m_fixedTimers = new bee::TimerWheel(1.0f / settings.fixedUpdateRate);
     m_registry = entt::registry();
+    bee::ecs::GetNameIndex(m_registry);
+    bee::ecs::GetUUIDIndex(m_registry);
 
     // Create render configuration
     xsr::render_configuration render_config;
@@ -49,6 +63,34 @@ void EngineClass::Initialize(const EngineSettings& settings)
 
     RenderManager::Initialize();
     ComponentManager::RegisterComponents();
+
+    // particles are not registered components, but live particles should come back after play mode
+    // and show up in the registry stats
+    bee::ecs::RegisterSnapshotType<ParticleManager::ParticlePhysics>();
+    bee::ecs::RegisterStorageType<ParticleManager::ParticlePhysics>();
+    bee::ecs::RegisterSnapshotType<ParticleManager::LifeTime>();
+    bee::ecs::RegisterStorageType<ParticleManager::LifeTime>();
+    bee::ecs::RegisterSnapshotType<ParticleManager::EmitterID>();
+    bee::ecs::RegisterStorageType<ParticleManager::EmitterID>();
+    ParticleManager::Initialize();
+
+    bee::benchmark::Register("Transform", &bee::BenchmarkComposeTRS);
+    bee::benchmark::Register("Snapshot", &bee::ecs::BenchmarkSnapshot);
+    bee::benchmark::Register("OBB", &bee::BenchmarkOBB);
+    bee::benchmark::Register("TriangleBVH", &bee::BenchmarkTriangleBVH);
+    bee::benchmark::Register("Gradient", &bee::BenchmarkGradient);
+    bee::benchmark::Register("Ease", &bee::BenchmarkEase);
+    bee::benchmark::Register("Tween", &bee::BenchmarkTween);
+    bee::benchmark::Register("TimerWheel", &bee::BenchmarkTimerWheel);
+    bee::benchmark::Register("Random", &bee::BenchmarkRandom);
+    bee::benchmark::Register("Interpolation", &bee::BenchmarkInterpolation);
+    bee::benchmark::Register("StressScene", &bee::ecs::BenchmarkStressScene);
+    bee::benchmark::Register("Hierarchy", &bee::ecs::BenchmarkHierarchy);
+    bee::benchmark::Register("Serialization", &bee::BenchmarkSerialization);
+    bee::benchmark::Register("Resources", &bee::resource::BenchmarkLoading);
+    bee::benchmark::Register("Particles", &bee::ParticleManager::Benchmark);
+    bee::benchmark::Register("Rendering", &bee::RenderManager::Benchmark);
+    bee::benchmark::Register("Replay", &bee::InputReplay::Benchmark);
 }
 
 void EngineClass::Shutdown()
@@ -66,6 +108,14 @@ void EngineClass::Shutdown()
         layer->OnDetach();
     }
 
+    // destroying particles cancels their timers, so the registry goes first
+    m_registry.clear();
+    delete m_jobs;
+    delete m_timers;
+    m_timers = nullptr;
+    delete m_fixedTimers;
+    m_fixedTimers = nullptr;
+    delete m_replay;
     delete m_input;
     delete m_audio;
     delete m_device;
@@ -101,6 +151,8 @@ void bee::EngineClass::OnEvent(Event& e)
 
 void bee::EngineClass::StartApplication()
 {
+    StartReplaySession();
+
     // loop through all layers and call OnAttach
     try
     {
@@ -135,6 +187,8 @@ void bee::EngineClass::StartApplication()
 
 void bee::EngineClass::StopApplication()
 {
+    m_replay->Stop();
+
     // loop through all layers and call OnDetach
     for (Layer* layer : m_applicationLayerStack)
     {
@@ -149,10 +203,47 @@ void bee::EngineClass::StopApplication()
     m_device->HideCursor(false);
 }
 
+void bee::EngineClass::StartReplaySession()
+{
+    if (!m_settings.replayInput.empty())
+    {
+        if (!m_replay->StartReplay(m_settings.replayInput)) return;
+
+        // the same starting point as the recording, the seed also makes the layers attach with the same random numbers
+        const ReplayInfo& info = m_replay->Info();
+        m_gameTime = info.gameTime;
+        m_settings.fixedUpdateRate = info.fixedUpdateRate;
+        if (info.width != m_device->GetWidth() || info.height != m_device->GetHeight())
+        {
+            bee::Log::Warn("The replay was recorded at {}x{}, the window is {}x{}",
+                           info.width,
+                           info.height,
+                           m_device->GetWidth(),
+                           m_device->GetHeight());
+        }
+        bee::SeedRandom(info.randomSeed);
+    }
+    else if (!m_settings.recordInput.empty())
+    {
+        ReplayInfo info;
+        info.randomSeed = bee::GetRandomSeed();
+        info.gameTime = m_gameTime;
+        info.fixedUpdateRate = m_settings.fixedUpdateRate;
+        info.width = m_device->GetWidth();
+        info.height = m_device->GetHeight();
+        bee::SeedRandom(info.randomSeed);
+        m_replay->StartRecording(m_settings.recordInput, info);
+    }
+    else
+    {
+        return;
+    }
+    m_accumulator = 0.0f;
+}
+
 void EngineClass::Run()
 {
     auto previousTime = std::chrono::high_resolution_clock::now();
-    float accumulator = 0.0f;
 
 #ifdef EDITOR_MODE
     for (Layer* layer : m_editorLayerStack)
@@ -192,8 +283,11 @@ void EngineClass::Run()
         m_realTime += dt;
         dt *= m_settings.timeScale;
         dt = std::min(dt, 0.1f);
+        const bool headless = IsHeadless();
+        if (!headless) m_device->BeginFrame();
+        // a replay runs on the recorded frame times and input, not on the clock and the devices
+        if (!m_paused && m_replay->IsActive()) dt = m_replay->BeginFrame(*m_input, dt);
         m_gameTime += dt;
-        m_device->BeginFrame();
 
 #ifdef EDITOR_MODE
         for (Layer* layer : m_editorLayerStack)
@@ -206,29 +300,36 @@ void EngineClass::Run()
         if (!m_paused)
         {
             Update(dt);
-            accumulator += dt;
+            m_accumulator += dt;
 
             PROFILE_SECTION("Fixed Loop");
-            while (accumulator >= fixedDeltaTimeMS)
+            while (m_accumulator >= fixedDeltaTimeMS)
             {
                 FixedUpdate(fixedDeltaTimeMS);
-                accumulator -= fixedDeltaTimeMS;
+                m_accumulator -= fixedDeltaTimeMS;
+            }
+            m_interpolationAlpha = std::clamp(m_accumulator / fixedDeltaTimeMS, 0.0f, 1.0f);
+
+            if (m_replay->IsActive()) m_replay->EndFrame(m_registry);
+            if (m_replay->IsFinished())
+            {
+                m_replay->Stop();
+                if (m_settings.quitAfterReplay) m_running = false;
             }
         }
-        // Interpolate particles to the "next" frame
-        if (!m_paused && m_settings.interpolateParticles) ParticleManager::FixedUpdate(accumulator);
 
         Draw();
 
-        // Interpolate particles back so that they are in the correct position for the next frame
-        if (!m_paused && m_settings.interpolateParticles) ParticleManager::FixedUpdate(-accumulator);
-
-        m_imguiLayer->Begin();
-        ImGuiRender();
-        m_imguiLayer->End();
+        if (!headless)
+        {
+            m_imguiLayer->Begin();
+            ImGuiRender();
+            m_imguiLayer->End();
+        }
 
         m_input->Update();
-        m_device->EndFrame();
+        // the swap waits on vsync, a headless replay only lets the window handle its events now and then
+        if (!headless || m_replay->Frame() % 60 == 0) m_device->EndFrame();
     }
 
     StopApplication();
@@ -238,6 +339,8 @@ void bee::EngineClass::Update(float deltaTime)
 {
     try
     {
+        m_timers->Advance(deltaTime);
+
         for (Layer* layer : m_applicationLayerStack)
         {
             if (!layer->loaded) continue;
@@ -265,6 +368,8 @@ void bee::EngineClass::FixedUpdate(float fixedDeltaTime)
 #endif
     try
     {
+        m_fixedTimers->Advance(fixedDeltaTime);
+
         for (Layer* layer : m_applicationLayerStack)
         {
             if (!layer->loaded) continue;
@@ -278,10 +383,15 @@ void bee::EngineClass::FixedUpdate(float fixedDeltaTime)
     }
 
     ParticleManager::FixedUpdate(fixedDeltaTime);
+    InterpolationManager::Snapshot(m_registry);
 }
 
 void bee::EngineClass::Draw()
 {
+    UpdateModelMatrices(m_registry);
+    // picking and line of sight queries during the frame see the positions that get drawn
+    bee::raycasting::GetSceneBVH(m_registry).Update(m_registry);
+
 #ifdef EDITOR_MODE
     for (Layer* layer : m_editorLayerStack)
     {
@@ -305,6 +415,10 @@ void bee::EngineClass::Draw()
     }
     ParticleManager::Draw();
 
+    InterpolationManager::Blend(m_registry, m_settings.interpolateTransforms ? m_interpolationAlpha : 1.0f);
+    // everything above can be seen by the simulation, everything below only ends up on screen
+    if (IsHeadless()) return;
+
     RenderManager::SubmitRenderables(m_registry);
     // TODO: Make billboards work with multiple cameras, probably do the billboarding in the shader
 #ifdef EDITOR_MODE
@@ -487,6 +601,23 @@ bool bee::EngineClass::OnWindowResize(WindowResizeEvent& e)
     return false;
 }
 
+bool bee::EngineClass::IsHeadless() const { return m_settings.headlessReplay && m_replay->IsReplaying(); }
+
+void bee::ParseArguments(EngineSettings& settings, int argc, char* argv[])
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string argument = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (argument == "--record" && hasValue)
+            settings.recordInput = argv[++i];
+        else if (argument == "--replay" && hasValue)
+            settings.replayInput = argv[++i];
+        else if (argument == "--headless")
+            settings.headlessReplay = true;
+    }
+}
+
 
 
 /*
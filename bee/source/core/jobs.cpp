@@ -0,0 +1,116 @@
+#include "core/jobs.hpp"
+#include <cassert>
+
+namespace bee::internal
+{
+// set while a thread runs chunks, nested ParallelFor calls then run inline instead of waiting on the pool
+thread_local bool insideJob = false;
+thread_local int workerIndex = 0;
+}  // namespace bee::internal
+
+using namespace bee::internal;
+
+bee::JobSystem::JobSystem(int workerCount) : m_owner(std::this_thread::get_id())
+{
+    if (workerCount <= 0) workerCount = std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 0);
+
+    m_workers.reserve(workerCount);
+    for (int i = 0; i < workerCount; i++) m_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+    m_maxThreads = ThreadCount();
+}
+
+bee::JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_all();
+    for (auto& worker : m_workers) worker.join();
+}
+
+void bee::JobSystem::SetMaxThreads(int count)
+{
+    // workers read the limit while they pick up a job
+    assert(std::this_thread::get_id() == m_owner && "JobSystem is owned by the thread that created it");
+    m_maxThreads.store(std::clamp(count, 1, ThreadCount()), std::memory_order_relaxed);
+}
+
+void bee::JobSystem::RunChunks(Job& job)
+{
+    const bool wasInsideJob = insideJob;
+    insideJob = true;
+    for (size_t chunk = job.next.fetch_add(1); chunk < job.chunkCount; chunk = job.next.fetch_add(1))
+    {
+        job.run(job.context, chunk);
+    }
+    insideJob = wasInsideJob;
+}
+
+void bee::JobSystem::Dispatch(size_t chunkCount, void (*run)(void*, size_t), void* context)
+{
+    Job job;
+    job.run = run;
+    job.context = context;
+    job.chunkCount = chunkCount;
+
+    if (chunkCount == 1 || GetMaxThreads() == 1 || m_workers.empty() || insideJob)
+    {
+        RunChunks(job);
+        return;
+    }
+
+    // m_job is a single slot, a second dispatching thread would overwrite a job that is still running
+    assert(std::this_thread::get_id() == m_owner && "JobSystem is owned by the thread that created it");
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &job;
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    RunChunks(job);
+
+    // the job lives on this stack, so wait for every worker that picked it up
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_job = nullptr;
+    m_finished.wait(lock, [&]() { return m_busy == 0; });
+}
+
+int bee::JobSystem::WorkerIndex() { return workerIndex; }
+
+void bee::JobSystem::WorkerLoop(int index)
+{
+    workerIndex = index + 1;
+    uint64_t generation = 0;
+    while (true)
+    {
+        Job* job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&]() { return m_quit || m_generation != generation; });
+            if (m_quit) return;
+
+            generation = m_generation;
+            // workers past the thread limit sit this job out
+            if (!m_job || index + 1 >= GetMaxThreads()) continue;
+            job = m_job;
+            m_busy++;
+        }
+
+        RunChunks(*job);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_busy--;
+        }
+        m_finished.notify_one();
+    }
+}
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
@@ -0,0 +1,458 @@
+#include "core/replay.hpp"
+#include "core.hpp"
+#include <cstring>
+#include <type_traits>
+
+namespace bee::internal
+{
+static constexpr uint32_t replayMagic = 0x50455242;  // "BREP"
+static constexpr uint32_t replayVersion = 2;
+
+// What a frame stores besides its frame time
+enum ReplayFlags : uint8_t
+{
+    ReplayKeys = 1 << 0,
+    ReplayMouseButtons = 1 << 1,
+    ReplayMousePosition = 1 << 2,
+    ReplayMouseWheel = 1 << 3,
+    ReplayGamepads = 1 << 4,
+    ReplayCheckpoint = 1 << 5
+};
+
+template <typename T>
+static void WriteValue(std::vector<uint8_t>& data, const T& value)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    const size_t offset = data.size();
+    data.resize(offset + sizeof(T));
+    std::memcpy(data.data() + offset, &value, sizeof(T));
+}
+
+template <typename T>
+static bool ReadValue(const std::vector<uint8_t>& data, size_t& offset, T& value)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (offset + sizeof(T) > data.size()) return false;
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+// The header is written field by field, so the file doesn't depend on how the compiler pads ReplayInfo
+static void WriteHeader(std::vector<uint8_t>& data, uint32_t frameCount, const bee::ReplayInfo& info)
+{
+    WriteValue(data, replayMagic);
+    WriteValue(data, replayVersion);
+    WriteValue(data, frameCount);
+    WriteValue(data, info.randomSeed);
+    WriteValue(data, info.gameTime);
+    WriteValue(data, info.fixedUpdateRate);
+    WriteValue(data, info.width);
+    WriteValue(data, info.height);
+    WriteValue(data, info.checkpointInterval);
+}
+
+static bool ReadHeader(const std::vector<uint8_t>& data, size_t& offset, uint32_t& frameCount, bee::ReplayInfo& info)
+{
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    return ReadValue(data, offset, magic) && magic == replayMagic && ReadValue(data, offset, version) &&
+           version == replayVersion && ReadValue(data, offset, frameCount) && ReadValue(data, offset, info.randomSeed) &&
+           ReadValue(data, offset, info.gameTime) && ReadValue(data, offset, info.fixedUpdateRate) &&
+           ReadValue(data, offset, info.width) && ReadValue(data, offset, info.height) &&
+           ReadValue(data, offset, info.checkpointInterval);
+}
+
+static uint64_t FrameSeed(uint64_t seed, uint32_t frame) { return seed + 0x9E3779B97F4A7C15ull * (frame + 1ull); }
+
+static bool GamepadsEqual(const bee::Input::State& a, const bee::Input::State& b)
+{
+    return a.gamepadsConnected == b.gamepadsConnected &&
+           std::equal(std::begin(a.gamepadButtons), std::end(a.gamepadButtons), std::begin(b.gamepadButtons)) &&
+           std::memcmp(a.gamepadAxes, b.gamepadAxes, sizeof(a.gamepadAxes)) == 0;
+}
+
+static bool StatesEqual(const bee::Input::State& a, const bee::Input::State& b)
+{
+    return a.keys == b.keys && a.mouseButtons == b.mouseButtons && a.mousePosition == b.mousePosition &&
+           a.mouseWheel == b.mouseWheel && GamepadsEqual(a, b);
+}
+
+// Input that changes a little every frame like a real session, disconnected gamepads are left zeroed like a replay does
+static void RandomInputs(uint32_t frameCount, std::vector<bee::Input::State>& states, std::vector<float>& frameTimes)
+{
+    using State = bee::Input::State;
+    bee::Random random(5000);
+    State state;
+    states.resize(frameCount);
+    frameTimes.resize(frameCount);
+    for (uint32_t frame = 0; frame < frameCount; frame++)
+    {
+        for (int i = random.Int(0, 3); i > 0; i--) state.keys.flip(static_cast<size_t>(random.Int(0, State::keyCount - 1)));
+        if (random.Int(0, 3) == 0) state.mouseButtons = static_cast<uint8_t>(random.UInt());
+        if (random.Int(0, 1) == 0) state.mousePosition = glm::vec2(random.Float(0.0f, 1920.0f), random.Float(0.0f, 1080.0f));
+        state.mouseWheel = random.Int(0, 7) == 0 ? random.Float(-3.0f, 3.0f) : 0.0f;
+        if (random.Int(0, 15) == 0)
+        {
+            state.gamepadsConnected = static_cast<uint8_t>(random.Int(0, (1 << State::gamepadCount) - 1));
+            for (int i = 0; i < State::gamepadCount; i++)
+            {
+                const bool connected = (state.gamepadsConnected >> i) & 1;
+                state.gamepadButtons[i] = connected ? static_cast<uint16_t>(random.UInt()) : 0;
+                for (float& axis : state.gamepadAxes[i]) axis = connected ? random.Float(-1.0f, 1.0f) : 0.0f;
+            }
+        }
+        states[frame] = state;
+        frameTimes[frame] = random.Float(0.001f, 0.1f);
+    }
+}
+}  // namespace bee::internal
+using namespace bee::internal;
+
+template <typename T>
+void bee::InputReplay::Write(const T& value)
+{
+    WriteValue(m_data, value);
+}
+
+template <typename T>
+bool bee::InputReplay::Read(T& value)
+{
+    return ReadValue(m_data, m_readOffset, value);
+}
+
+void bee::InputReplay::Reset()
+{
+    m_mode = Mode::None;
+    m_data.clear();
+    m_readOffset = 0;
+    m_frame = 0;
+    m_state = Input::State();
+    m_checkpoint = false;
+    m_checkpoints = 0;
+    m_mismatches = 0;
+    m_startTime = std::chrono::high_resolution_clock::now();
+}
+
+bool bee::InputReplay::StartRecording(const std::filesystem::path& path, const ReplayInfo& info)
+{
+    Stop();
+    Reset();
+    m_mode = Mode::Recording;
+    m_path = path;
+    m_info = info;
+    m_info.checkpointInterval = std::max(m_info.checkpointInterval, 1u);
+    bee::Log::Info("Recording input to {}, seed {}", path.string(), m_info.randomSeed);
+    return true;
+}
+
+bool bee::InputReplay::StartReplay(const std::filesystem::path& path)
+{
+    Stop();
+    Reset();
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        bee::Log::Error("Could not open replay {}", path.string());
+        return false;
+    }
+
+    m_data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    uint32_t frameCount = 0;
+    ReplayInfo info;
+    size_t headerSize = 0;
+    if (!ReadHeader(m_data, headerSize, frameCount, info))
+    {
+        bee::Log::Error("{} is not a replay of this version", path.string());
+        m_data.clear();
+        return false;
+    }
+    m_data.erase(m_data.begin(), m_data.begin() + static_cast<std::ptrdiff_t>(headerSize));
+
+    m_mode = Mode::Replaying;
+    m_path = path;
+    m_info = info;
+    m_info.checkpointInterval = std::max(m_info.checkpointInterval, 1u);
+    bee::Log::Info("Replaying {} frames from {}, seed {}", frameCount, path.string(), m_info.randomSeed);
+    return true;
+}
+
+void bee::InputReplay::Stop()
+{
+    if (m_mode == Mode::Recording)
+    {
+        std::vector<uint8_t> header;
+        WriteHeader(header, m_frame, m_info);
+
+        std::ofstream file(m_path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+        file.write(reinterpret_cast<const char*>(m_data.data()), static_cast<std::streamsize>(m_data.size()));
+        if (file)
+            bee::Log::Info("Recorded {} frames to {}, {} bytes", m_frame, m_path.string(), header.size() + m_data.size());
+        else
+            bee::Log::Error("Could not write replay {}", m_path.string());
+    }
+    else if (m_mode == Mode::Replaying)
+    {
+        const double seconds =
+            std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - m_startTime).count();
+        const double frameMs = m_frame > 0 ? seconds * 1000.0 / m_frame : 0.0;
+        bee::Log::Info("Replayed {} frames in {:.2f} s, {:.3f} ms per frame", m_frame, seconds, frameMs);
+        if (m_mismatches == 0)
+            bee::Log::Info("All {} checkpoints matched the recording", m_checkpoints);
+        else
+            bee::Log::Warn("{} of {} checkpoints did not match the recording", m_mismatches, m_checkpoints);
+    }
+    m_mode = Mode::None;
+    m_data.clear();
+    m_data.shrink_to_fit();
+}
+
+float bee::InputReplay::BeginFrame(Input& input, float dt)
+{
+    if (m_mode == Mode::Recording)
+    {
+        Input::State state;
+        input.GetState(state);
+
+        Write(dt);
+        m_flagsOffset = m_data.size();
+        uint8_t flags = 0;
+        Write(flags);
+
+        // keys are stored as the list of keys that went down or up
+        const std::bitset<Input::State::keyCount> changed = state.keys ^ m_state.keys;
+        if (changed.any())
+        {
+            flags |= ReplayKeys;
+            Write(static_cast<uint16_t>(changed.count()));
+            for (uint16_t key = 0; key < Input::State::keyCount; key++)
+                if (changed[key]) Write(key);
+        }
+        if (state.mouseButtons != m_state.mouseButtons)
+        {
+            flags |= ReplayMouseButtons;
+            Write(state.mouseButtons);
+        }
+        if (state.mousePosition != m_state.mousePosition)
+        {
+            flags |= ReplayMousePosition;
+            Write(state.mousePosition);
+        }
+        if (state.mouseWheel != 0.0f)
+        {
+            flags |= ReplayMouseWheel;
+            Write(state.mouseWheel);
+        }
+        if (!GamepadsEqual(state, m_state))
+        {
+            flags |= ReplayGamepads;
+            Write(state.gamepadsConnected);
+            for (int i = 0; i < Input::State::gamepadCount; i++)
+            {
+                if (!((state.gamepadsConnected >> i) & 1)) continue;
+                Write(state.gamepadButtons[i]);
+                Write(state.gamepadAxes[i]);
+            }
+        }
+        m_data[m_flagsOffset] = flags;
+        m_state = state;
+    }
+    else if (m_mode == Mode::Replaying)
+    {
+        if (IsFinished()) return dt;
+
+        uint8_t flags = 0;
+        bool valid = Read(dt) && Read(flags);
+        if (valid && (flags & ReplayKeys))
+        {
+            uint16_t count = 0;
+            valid = Read(count);
+            for (uint16_t i = 0; valid && i < count; i++)
+            {
+                uint16_t key = 0;
+                valid = Read(key) && key < Input::State::keyCount;
+                if (valid) m_state.keys.flip(key);
+            }
+        }
+        if (valid && (flags & ReplayMouseButtons)) valid = Read(m_state.mouseButtons);
+        if (valid && (flags & ReplayMousePosition)) valid = Read(m_state.mousePosition);
+        m_state.mouseWheel = 0.0f;
+        if (valid && (flags & ReplayMouseWheel)) valid = Read(m_state.mouseWheel);
+        if (valid && (flags & ReplayGamepads))
+        {
+            valid = Read(m_state.gamepadsConnected);
+            for (int i = 0; valid && i < Input::State::gamepadCount; i++)
+            {
+                m_state.gamepadButtons[i] = 0;
+                std::fill(std::begin(m_state.gamepadAxes[i]), std::end(m_state.gamepadAxes[i]), 0.0f);
+                if (!((m_state.gamepadsConnected >> i) & 1)) continue;
+                valid = Read(m_state.gamepadButtons[i]) && Read(m_state.gamepadAxes[i]);
+            }
+        }
+        m_checkpoint = (flags & ReplayCheckpoint) != 0;
+        if (valid && m_checkpoint) valid = Read(m_expectedHash);
+
+        if (!valid)
+        {
+            bee::Log::Error("Replay {} is cut off at frame {}", m_path.string(), m_frame);
+            m_readOffset = m_data.size();
+            m_checkpoint = false;
+        }
+        input.SetState(m_state);
+    }
+
+    // reseeded every frame, so a frame gets the same numbers no matter what drew numbers before it
+    if (m_mode != Mode::None) SeedRandom(FrameSeed(m_info.randomSeed, m_frame));
+    return dt;
+}
+
+void bee::InputReplay::EndFrame(entt::registry& registry)
+{
+    if (m_mode == Mode::Recording)
+    {
+        if ((m_frame + 1) % m_info.checkpointInterval == 0)
+        {
+            m_data[m_flagsOffset] |= ReplayCheckpoint;
+            Write(HashRegistry(registry));
+        }
+    }
+    else if (m_mode == Mode::Replaying && m_checkpoint)
+    {
+        m_checkpoints++;
+        if (HashRegistry(registry) != m_expectedHash)
+        {
+            // only the first one, once the simulation diverged every checkpoint after it differs as well
+            if (m_mismatches == 0) bee::Log::Warn("Replay diverged from the recording at frame {}", m_frame);
+            m_mismatches++;
+        }
+    }
+    if (m_mode != Mode::None) m_frame++;
+}
+
+uint64_t bee::InputReplay::HashRegistry(entt::registry& registry)
+{
+    PROFILE_FUNCTION();
+
+    // FNV-1a over the raw bytes, the same simulation gives the same bits
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const void* data, size_t size)
+    {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    };
+
+    for (auto [entity, transform] : registry.view<Transform>(entt::exclude<EditorComponent>).each())
+    {
+        const auto id = entt::to_integral(entity);
+        const glm::vec3 position = transform.GetPosition();
+        const glm::quat rotation = transform.GetRotationQuat();
+        const glm::vec3 scale = transform.GetScale();
+        mix(&id, sizeof(id));
+        mix(&position, sizeof(position));
+        mix(&rotation, sizeof(rotation));
+        mix(&scale, sizeof(scale));
+    }
+    return hash;
+}
+
+std::vector<bee::benchmark::Result> bee::InputReplay::Benchmark()
+{
+    constexpr uint32_t frameCount = 5000;
+    Input& input = Engine.Input();
+    entt::registry& registry = Engine.Registry();
+    Input::State saved;
+    input.GetState(saved);
+    const uint64_t savedSeed = GetRandomSeed();
+
+    std::vector<Input::State> states;
+    std::vector<float> frameTimes;
+    RandomInputs(frameCount, states, frameTimes);
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "bee_replay_roundtrip.brep";
+    ReplayInfo info;
+    info.randomSeed = 1234;
+    info.gameTime = 3.5f;
+    info.fixedUpdateRate = 50.0f;
+    info.width = 1280;
+    info.height = 720;
+    info.checkpointInterval = 30;
+
+    std::vector<benchmark::Result> results;
+    results.push_back(benchmark::Measure(
+        "Record 5000 frames",
+        frameCount,
+        [&]()
+        {
+            InputReplay replay;
+            replay.StartRecording(path, info);
+            for (uint32_t frame = 0; frame < frameCount; frame++)
+            {
+                input.SetState(states[frame]);
+                replay.BeginFrame(input, frameTimes[frame]);
+                replay.EndFrame(registry);
+            }
+            replay.Stop();
+        },
+        1));
+
+    size_t wrongFrames = 0;
+    bool wrongInfo = false;
+    bool unfinished = false;
+    size_t mismatches = 0;
+    results.push_back(benchmark::Measure(
+        "Replay 5000 frames",
+        frameCount,
+        [&]()
+        {
+            InputReplay replay;
+            if (!replay.StartReplay(path))
+            {
+                unfinished = true;
+                return;
+            }
+            const ReplayInfo& read = replay.Info();
+            wrongInfo = read.randomSeed != info.randomSeed || read.gameTime != info.gameTime ||
+                        read.fixedUpdateRate != info.fixedUpdateRate || read.width != info.width ||
+                        read.height != info.height || read.checkpointInterval != info.checkpointInterval;
+            Input::State state;
+            for (uint32_t frame = 0; frame < frameCount; frame++)
+            {
+                const float dt = replay.BeginFrame(input, 0.0f);
+                input.GetState(state);
+                if (dt != frameTimes[frame] || !StatesEqual(state, states[frame])) wrongFrames++;
+                replay.EndFrame(registry);
+            }
+            unfinished = !replay.IsFinished();
+            mismatches = replay.Mismatches();
+            replay.Stop();
+        },
+        1));
+
+    if (wrongFrames > 0 || wrongInfo || unfinished || mismatches > 0)
+        bee::benchmark::Fail("Replay round trip failed: {} of {} frames differ, header {}, {}, {} checkpoint mismatches",
+                             wrongFrames,
+                             frameCount,
+                             wrongInfo ? "differs" : "matches",
+                             unfinished ? "not finished" : "finished",
+                             mismatches);
+    else
+        bee::Log::Info("Replay round trip: {} random frames came back exactly", frameCount);
+
+    input.SetState(saved);
+    SeedRandom(savedSeed);
+    std::error_code error;
+    std::filesystem::remove(path, error);
+    return results;
+}
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
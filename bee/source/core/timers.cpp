@@ -0,0 +1,339 @@
+#include "core/timers.hpp"
+#include "core.hpp"
+
+namespace bee::internal
+{
+// State of the randomized run in BenchmarkTimerWheel, timers are numbered in the order they are scheduled
+struct TimerCheck
+{
+    static constexpr uint64_t unfired = std::numeric_limits<uint64_t>::max();
+    static constexpr uint64_t cancelled = std::numeric_limits<uint64_t>::max();
+
+    bee::TimerWheel wheel;
+    bee::Random random = bee::Random(285);
+    std::vector<uint64_t> expected;  // tick the timer has to fire on, cancelled once it is cancelled
+    std::vector<uint64_t> firedAt;
+    std::vector<bee::TimerHandle> handles;
+    uint64_t tick = 0;  // the tick the wheel is running
+    uint64_t lastTick = 0;
+    size_t total = 0;
+    size_t wrong = 0;
+};
+
+// Mostly timers in the first level, some that cascade down once and some from two levels up
+static void ScheduleCheckTimer(TimerCheck& check);
+
+static void OnCheckTimer(void* context, uint64_t id)
+{
+    TimerCheck& check = *static_cast<TimerCheck*>(context);
+    if (check.firedAt[id] != TimerCheck::unfired || check.expected[id] != check.tick) check.wrong++;
+    check.firedAt[id] = check.tick;
+
+    // schedule from inside the callback, the new timer can take the place of the one that just fired
+    if (check.expected.size() < check.total) ScheduleCheckTimer(check);
+
+    // cancel a random timer, which may have fired already and must not be cancelled then
+    if (id % 5 == 0)
+    {
+        const size_t other = static_cast<size_t>(check.random.Next() % check.expected.size());
+        const bool pending = check.firedAt[other] == TimerCheck::unfired && check.expected[other] != TimerCheck::cancelled;
+        if (check.wheel.Cancel(check.handles[other]) != pending) check.wrong++;
+        if (pending) check.expected[other] = TimerCheck::cancelled;
+    }
+}
+
+static void ScheduleCheckTimer(TimerCheck& check)
+{
+    const int level = check.random.Int(0, 9);
+    const int maxDelay = level < 5 ? 255 : level < 8 ? 16383 : (1 << 20);
+    const uint64_t tick = check.tick + static_cast<uint64_t>(check.random.Int(1, maxDelay));
+    const uint64_t id = check.expected.size();
+    check.expected.push_back(tick);
+    check.lastTick = std::max(check.lastTick, tick);
+    check.firedAt.push_back(TimerCheck::unfired);
+    // half a tick early so rounding can't push it to the next tick
+    const double time = (static_cast<double>(tick) - 0.5) * static_cast<double>(check.wheel.TickLength());
+    check.handles.push_back(check.wheel.ScheduleAt(time, &OnCheckTimer, &check, id));
+}
+}  // namespace bee::internal
+
+using namespace bee::internal;
+
+bee::TimerWheel::TimerWheel(float tickLength) : m_slots(slotCount, none), m_tickLength(tickLength) {}
+
+bee::TimerHandle bee::TimerWheel::Schedule(float delay, TimerFunction function, void* context, uint64_t data)
+{
+    return ScheduleAt(Now() + static_cast<double>(delay), function, context, data);
+}
+
+bee::TimerHandle bee::TimerWheel::ScheduleAt(double time, TimerFunction function, void* context, uint64_t data)
+{
+    uint32_t index;
+    if (m_freeTimers != none)
+    {
+        index = m_freeTimers;
+        m_freeTimers = m_timers[index].next;
+    }
+    else
+    {
+        index = static_cast<uint32_t>(m_timers.size());
+        m_timers.emplace_back();
+    }
+
+    // the tick that is running already fired its timers, so the earliest is the next one
+    const uint64_t next = m_tick + 1;
+    const double tick = std::ceil(time / m_tickLength);
+    Timer& timer = m_timers[index];
+    if (!(tick > static_cast<double>(next)))
+        timer.tick = next;
+    else if (tick >= static_cast<double>(std::numeric_limits<uint64_t>::max()))
+        timer.tick = std::numeric_limits<uint64_t>::max();
+    else
+        timer.tick = static_cast<uint64_t>(tick);
+    timer.function = function;
+    timer.context = context;
+    timer.data = data;
+
+    Insert(index);
+    m_pending++;
+    return {index, timer.generation};
+}
+
+bool bee::TimerWheel::Cancel(const TimerHandle& handle)
+{
+    if (!IsPending(handle)) return false;
+    Unlink(handle.index);
+    Free(handle.index);
+    return true;
+}
+
+bool bee::TimerWheel::IsPending(const TimerHandle& handle) const
+{
+    return handle.index < m_timers.size() && m_timers[handle.index].generation == handle.generation &&
+           m_timers[handle.index].slot != none;
+}
+
+void bee::TimerWheel::Advance(float dt)
+{
+    if (!(dt > 0.0f)) return;
+
+    m_remainder += static_cast<double>(dt);
+    if (m_pending == 0)
+    {
+        // every slot is empty, so there is nothing to cascade or fire on the way
+        const double ticks = std::floor(m_remainder / m_tickLength);
+        m_tick += static_cast<uint64_t>(ticks);
+        m_remainder -= ticks * m_tickLength;
+        return;
+    }
+
+    while (m_remainder >= m_tickLength)
+    {
+        m_remainder -= m_tickLength;
+        RunTick();
+    }
+}
+
+void bee::TimerWheel::Clear()
+{
+    for (uint32_t index = 0; index < m_timers.size(); index++)
+    {
+        if (m_timers[index].slot != none) Free(index);
+    }
+    std::fill(m_slots.begin(), m_slots.end(), none);
+}
+
+void bee::TimerWheel::Insert(uint32_t index)
+{
+    Timer& timer = m_timers[index];
+    const uint64_t next = m_tick + 1;
+    const uint64_t delta = timer.tick - next;
+
+    uint32_t slot;
+    if (delta < firstLevelSlots)
+    {
+        slot = static_cast<uint32_t>(timer.tick & (firstLevelSlots - 1));
+    }
+    else
+    {
+        // the lowest level whose turn reaches the tick, timers past the last level wait in its furthest slot
+        int level = 1;
+        while (level < levelCount - 1 && delta >= (1ull << (firstLevelBits + level * levelBits))) level++;
+        const uint64_t maxDelta = (1ull << (firstLevelBits + level * levelBits)) - 1;
+        const uint64_t tick = delta > maxDelta ? next + maxDelta : timer.tick;
+        const int shift = firstLevelBits + (level - 1) * levelBits;
+        slot = firstLevelSlots + static_cast<uint32_t>(level - 1) * levelSlots +
+               static_cast<uint32_t>((tick >> shift) & (levelSlots - 1));
+    }
+
+    timer.slot = slot;
+    timer.previous = none;
+    timer.next = m_slots[slot];
+    if (timer.next != none) m_timers[timer.next].previous = index;
+    m_slots[slot] = index;
+}
+
+void bee::TimerWheel::Unlink(uint32_t index)
+{
+    Timer& timer = m_timers[index];
+    if (timer.previous != none)
+        m_timers[timer.previous].next = timer.next;
+    else
+        m_slots[timer.slot] = timer.next;
+    if (timer.next != none) m_timers[timer.next].previous = timer.previous;
+}
+
+void bee::TimerWheel::Free(uint32_t index)
+{
+    Timer& timer = m_timers[index];
+    timer.slot = none;
+    timer.previous = none;
+    timer.generation++;
+    timer.next = m_freeTimers;
+    m_freeTimers = index;
+    m_pending--;
+}
+
+void bee::TimerWheel::Cascade(uint32_t slot)
+{
+    uint32_t index = m_slots[slot];
+    m_slots[slot] = none;
+    while (index != none)
+    {
+        const uint32_t next = m_timers[index].next;
+        Insert(index);
+        index = next;
+    }
+}
+
+void bee::TimerWheel::RunTick()
+{
+    const uint64_t tick = m_tick + 1;
+
+    // when the first level comes around, the next slot of the level above moves down, and so on up the levels
+    if ((tick & (firstLevelSlots - 1)) == 0)
+    {
+        for (int level = 1; level < levelCount; level++)
+        {
+            const int shift = firstLevelBits + (level - 1) * levelBits;
+            const uint32_t slot = static_cast<uint32_t>((tick >> shift) & (levelSlots - 1));
+            Cascade(firstLevelSlots + static_cast<uint32_t>(level - 1) * levelSlots + slot);
+            if (slot != 0) break;
+        }
+    }
+
+    m_tick = tick;
+    const uint32_t slot = static_cast<uint32_t>(tick & (firstLevelSlots - 1));
+    while (m_slots[slot] != none)
+    {
+        // copied before the timer is freed, the callback can schedule new timers into its place
+        const uint32_t index = m_slots[slot];
+        const TimerFunction function = m_timers[index].function;
+        void* const context = m_timers[index].context;
+        const uint64_t data = m_timers[index].data;
+        Unlink(index);
+        Free(index);
+        function(context, data);
+    }
+}
+
+std::vector<bee::benchmark::Result> bee::BenchmarkTimerWheel()
+{
+    constexpr size_t count = 10000;
+    constexpr float dt = 1.0f / 60.0f;
+    constexpr float maxLifetime = 5.0f;
+    constexpr int frames = static_cast<int>(maxLifetime / dt) + 2;
+
+    std::vector<float> lifetimes(count);
+    for (auto& lifetime : lifetimes) lifetime = glm::linearRand(0.5f, maxLifetime);
+
+    std::vector<benchmark::Result> results;
+
+    // what the particles and bullets did: touch every lifetime every frame to find the few that ran out
+    size_t countedDown = 0;
+    std::vector<float> remaining;
+    results.push_back(benchmark::Measure("Count down lifetimes for 5 s",
+                                         count,
+                                         [&]()
+                                         {
+                                             remaining = lifetimes;
+                                             for (int frame = 0; frame < frames; frame++)
+                                             {
+                                                 for (size_t i = 0; i < remaining.size();)
+                                                 {
+                                                     remaining[i] -= dt;
+                                                     if (remaining[i] > 0.0f)
+                                                     {
+                                                         i++;
+                                                         continue;
+                                                     }
+                                                     countedDown++;
+                                                     remaining[i] = remaining.back();
+                                                     remaining.pop_back();
+                                                 }
+                                             }
+                                         }));
+
+    size_t fired = 0;
+    auto onFire = [](void* context, uint64_t) { (*static_cast<size_t*>(context))++; };
+    results.push_back(benchmark::Measure("Timer wheel lifetimes for 5 s",
+                                         count,
+                                         [&]()
+                                         {
+                                             TimerWheel wheel;
+                                             for (float lifetime : lifetimes) wheel.Schedule(lifetime, onFire, &fired);
+                                             for (int frame = 0; frame < frames; frame++) wheel.Advance(dt);
+                                         }));
+    if (fired != countedDown) bee::benchmark::Fail("Timer wheel fired {} timers, counting down expired {}", fired, countedDown);
+
+    TimerWheel wheel;
+    std::vector<TimerHandle> handles(count);
+    results.push_back(benchmark::Measure("Schedule and cancel timers",
+                                         count,
+                                         [&]()
+                                         {
+                                             for (size_t i = 0; i < count; i++)
+                                                 handles[i] = wheel.Schedule(lifetimes[i], onFire, &fired);
+                                             for (const auto& handle : handles) wheel.Cancel(handle);
+                                         }));
+    if (wheel.Size() != 0) bee::benchmark::Fail("{} timers were not cancelled", wheel.Size());
+
+    // Randomized run of 285k timers at every level of the wheel, with cancels and timers scheduled from callbacks. The
+    // wheel is advanced a tick at a time, so every timer has to fire exactly once and on its own tick.
+    constexpr size_t checkCount = 285000;
+    size_t wrong = 0;
+    results.push_back(benchmark::Measure("Randomized timer run",
+                                         checkCount,
+                                         [&]()
+                                         {
+                                             auto check = std::make_unique<TimerCheck>();
+                                             check->total = checkCount;
+                                             for (size_t i = 0; i < checkCount / 2; i++) ScheduleCheckTimer(*check);
+                                             const double tickLength = static_cast<double>(check->wheel.TickLength());
+                                             // a broken wheel could keep timers forever, stop once all should be gone
+                                             while (check->wheel.Size() > 0 && check->tick < check->lastTick)
+                                             {
+                                                 check->tick++;
+                                                 check->wheel.Advance(check->wheel.TickLength());
+                                                 if (check->wheel.Now() != static_cast<double>(check->tick) * tickLength)
+                                                     check->wrong++;
+                                             }
+                                             for (size_t id = 0; id < check->expected.size(); id++)
+                                             {
+                                                 const bool shouldFire = check->expected[id] != TimerCheck::cancelled;
+                                                 if (shouldFire != (check->firedAt[id] != TimerCheck::unfired))
+                                                     check->wrong++;
+                                             }
+                                             wrong = check->wrong;
+                                         },
+                                         1));
+    if (wrong > 0) bee::benchmark::Fail("Randomized timer run: {} timers fired wrong, late, twice or not at all", wrong);
+
+    return results;
+}
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
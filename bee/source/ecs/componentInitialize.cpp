@@ -12,8 +12,8 @@ entt::entity bee::ecs::CreateDefault(const std::string& name)
 {
     entt::registry& registry = bee::Engine.Registry();
     entt::entity entity = CreateEmpty();
-    registry.emplace<HierarchyNode>(entity);
-    registry.get<HierarchyNode>(entity).name = name;
+    registry.emplace<UUID>(entity);
+    registry.emplace<HierarchyNode>(entity, name);
     registry.emplace<Transform>(entity);
     registry.emplace<Raycastable>(entity);
     registry.emplace<Saveable>(entity);
@@ -94,8 +94,7 @@ entt::entity bee::ecs::CreateCanvas()
 {
     entt::registry& registry = bee::Engine.Registry();
     entt::entity entity = CreateCamera();
-    HierarchyNode& node = registry.get<HierarchyNode>(entity);
-    node.name = ICON_FA_DIAGRAM_LEAN_CANVAS SPACE_FA "Canvas";
+    SetName(registry, entity, ICON_FA_DIAGRAM_LEAN_CANVAS SPACE_FA "Canvas");
     registry.emplace<Canvas>(entity);
     Camera& camera = registry.get<Camera>(entity);
     camera.orthographic = true;
@@ -12,11 +12,20 @@ std::vector<entt::id_type> component_render_order = {
     entt::type_hash<bee::SceneData>::value(),
     entt::type_hash<bee::Camera>::value()};
 
+// Editor only view of the transform rotation in euler angles, for the one transform the inspector shows
+struct EulerView
+{
+    entt::entity entity = entt::null;
+    uint64_t version = 0;  // transform version the angles were typed for
+    glm::vec3 euler = glm::vec3(0.0f);
+};
+EulerView euler_view;
+
 using namespace entt;
 void bee::ComponentManager::RegisterComponents()
 {
     // Register components with drawing functions
-    // RegisterComponentNoDraw<UUID>("UUID", false, true);
+    RegisterComponentNoDraw<UUID>("UUID", false, true);
     RegisterComponent<HierarchyNode, DrawHierarchyNodeComponent>("HierarchyNode", false, true);
     RegisterComponent<Transform, DrawTransformComponent>("Transform", false, true);
     RegisterComponent<Renderable, DrawRenderableComponent>("Renderable", true, true);
@@ -25,6 +34,7 @@ void bee::ComponentManager::RegisterComponents()
     RegisterComponent<PointLight, DrawPointLightComponent>("PointLight", true, true);
     RegisterComponent<SceneData, DrawSceneDataComponent>("SceneData", true, true);
     RegisterComponentNoDraw<Raycastable>("Raycastable", false, true);
+    RegisterComponentNoDraw<Interpolated>("Interpolated", true, true);
     RegisterComponent<Camera, DrawCameraComponent>("Camera", true, true);
     RegisterComponent<GltfScene, DrawGltfSceneComponent>("GltfScene", true, true);
     RegisterComponent<GltfNode, DrawGltfNodeComponent>("GltfNode", true, true);
@@ -39,6 +49,14 @@ void bee::ComponentManager::RegisterComponents()
     RegisterComponent<CanvasElement, DrawCanvasElementComponent>("CanvasElement", true, true);
 
     // Register component without a drawing function
+
+    // Not visible in the inspector, but they still have to survive play mode
+    bee::ecs::RegisterSnapshotType<Saveable>();
+    bee::ecs::RegisterStorageType<Saveable>();
+    bee::ecs::RegisterSnapshotType<EditorIcon>();
+    bee::ecs::RegisterStorageType<EditorIcon>();
+    bee::ecs::RegisterSnapshotType<LocalModel>();
+    bee::ecs::RegisterStorageType<LocalModel>();
 }
 
 // Made with help from OpenAI. (2024). ChatGPT [Large language model]. https://chatgpt.com
@@ -226,9 +244,15 @@ void bee::ComponentManager::DrawTransformComponent(entt::entity entity)
                       {
                           transform.SetPosition(transform.position);
                       }
-                      if (bee::ImGuiHelper::Vec3("Rotation (Euler)", transform.rotationEuler))
+                      // euler angles are not stored on the transform, keep the last edited ones around so the
+                      // fields don't jump to an equivalent rotation while typing
+                      // selecting another entity or changing the transform anywhere else drops them
+                      const bool typed = euler_view.entity == entity && euler_view.version == transform.GetVersion();
+                      glm::vec3 euler = typed ? euler_view.euler : transform.GetRotationEuler();
+                      if (bee::ImGuiHelper::Vec3("Rotation (Euler)", euler))
                       {
-                          transform.SetRotation(transform.rotationEuler);
+                          transform.SetRotation(euler);
+                          euler_view = {entity, transform.GetVersion(), euler};
                       }
                       if (bee::ImGuiHelper::Vec3("Scale", transform.scale))
                       {
@@ -248,7 +272,12 @@ void bee::ComponentManager::DrawHierarchyNodeComponent(entt::entity entity)
     DrawComponent(label,
                   [&]()
                   {
-                      bee::ImGuiHelper::InputText("Name", hierarchyNode.name);
+                      std::string name = hierarchyNode.name;
+                      if (bee::ImGuiHelper::InputText("Name", name)) bee::ecs::SetName(registry, entity, name);
+                      if (const UUID* uuid = registry.try_get<UUID>(entity))
+                      {
+                          ImGui::TextDisabled("UUID: %llu", static_cast<unsigned long long>(*uuid));
+                      }
                       bee::ImGuiHelper::Checkbox("Select Parent On Click", &hierarchyNode.selectParent);
                   });
 
@@ -341,6 +370,7 @@ void bee::ComponentManager::DrawEmitterComponent(entt::entity entity)
                   {
                       ImGui::Text("ID: %d", emitter.id);
                       ImGui::Text("Particle Count: %s", FormatWithCommas(emitter.particleCount).c_str());
+                      ImGui::Text("Budget Scale: %.2f", emitter.budgetScale);
 
                       if (ImGui::TreeNode("Emitter Settings"))
                       {
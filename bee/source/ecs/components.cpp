@@ -2,37 +2,44 @@
 #include "ecs/components.hpp"
 #include "tools/raycasting.hpp"
 #include <glm/gtx/matrix_decompose.hpp>
+#include <atomic>
+
+namespace bee::internal
+{
+// shared by all transforms so versions never repeat, atomic because transforms can be moved from worker threads
+std::atomic<uint64_t> transformVersion{0};
+}  // namespace bee::internal
+
+using namespace bee::internal;
 
 bee::Transform::Transform(const glm::vec3& pos, const glm::quat& rot, const glm::vec3& scl)
     : position(pos), rotation(rot), scale(scl)
 {
-    m_dirty = true;
+    MarkChanged();
 }
 
 void bee::Transform::SetPosition(const glm::vec3& pos)
 {
     position = pos;
-    m_dirty = true;
+    MarkChanged();
 }
 
 void bee::Transform::SetRotationQuat(const glm::quat& rot)
 {
     rotation = rot;
-    rotationEuler = glm::degrees(glm::eulerAngles(rotation));
-    m_dirty = true;
+    MarkChanged();
 }
 
 void bee::Transform::SetRotation(const glm::vec3& euler)
 {
-    rotationEuler = euler;
-    rotation = glm::quat(glm::radians(rotationEuler));
-    m_dirty = true;
+    rotation = glm::quat(glm::radians(euler));
+    MarkChanged();
 }
 
 void bee::Transform::SetScale(const glm::vec3& scl)
 {
     scale = scl;
-    m_dirty = true;
+    MarkChanged();
 }
 
 void bee::Transform::RotateAroundAxis(const glm::vec3& axis, float angleDegrees)
@@ -42,15 +49,39 @@ void bee::Transform::RotateAroundAxis(const glm::vec3& axis, float angleDegrees)
 
     glm::quat rotationDelta = glm::angleAxis(angleRadians, normalizedAxis);
     rotation = rotationDelta * rotation;
+    MarkChanged();
+}
 
-    rotationEuler = glm::degrees(glm::eulerAngles(rotation));
-    m_dirty = true;
+void bee::Transform::Rotate(const glm::vec3& eulerDegrees)
+{
+    rotation = glm::normalize(rotation * glm::quat(glm::radians(eulerDegrees)));
+    MarkChanged();
 }
 
+void bee::Transform::AddYawPitch(float yawDegrees, float pitchDegrees, float pitchLimit)
+{
+    // current pitch from how far the forward vector points up
+    glm::vec3 forward = glm::rotate(rotation, glm::vec3(0.0f, 0.0f, -1.0f));
+    float pitch = glm::degrees(std::asin(glm::clamp(forward.y, -1.0f, 1.0f)));
+    float newPitch = glm::clamp(pitch + pitchDegrees, -pitchLimit, pitchLimit);
+
+    glm::quat yawDelta = glm::angleAxis(glm::radians(yawDegrees), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::quat pitchDelta = glm::angleAxis(glm::radians(newPitch - pitch), glm::vec3(1.0f, 0.0f, 0.0f));
+    rotation = glm::normalize(yawDelta * rotation * pitchDelta);
+    MarkChanged();
+}
+
+void bee::Transform::MarkChanged()
+{
+    m_version = ++transformVersion;
+}
+
+glm::vec3 bee::Transform::GetRotationEuler() const { return glm::degrees(glm::eulerAngles(rotation)); }
+
 glm::vec3 bee::Transform::GetDirection() const
 {
     // check if it's not zero vector
-    if (rotationEuler == glm::vec3(0.0f))
+    if (rotation == glm::quat(1.0f, 0.0f, 0.0f, 0.0f))
     {
         return glm::vec3(0.0f, 0.0f, -1.0f);
     }
@@ -61,14 +92,9 @@ glm::vec3 bee::Transform::GetRight() const { return glm::normalize(glm::cross(Ge
 
 glm::vec3 bee::Transform::GetUp() const { return glm::normalize(glm::cross(GetRight(), GetDirection())); }
 
-const glm::mat4& bee::Transform::GetModelMatrix()
+glm::mat4 bee::Transform::GetModelMatrix() const
 {
-    if (m_dirty)
-    {
-        m_model = glm::translate(glm::mat4(1.0f), position) * glm::toMat4(rotation) * glm::scale(glm::mat4(1.0f), scale);
-        m_dirty = false;
-    }
-    return m_model;
+    return glm::translate(glm::mat4(1.0f), position) * glm::toMat4(rotation) * glm::scale(glm::mat4(1.0f), scale);
 }
 
 void bee::Transform::SetModelMatrix(const glm::mat4& modelMatrix)
@@ -77,15 +103,7 @@ void bee::Transform::SetModelMatrix(const glm::mat4& modelMatrix)
     glm::vec3 skew;
     glm::vec4 perspective;
     glm::decompose(modelMatrix, scale, rotation, position, skew, perspective);
-
-    // Update the Euler rotation angles from the quaternion rotation
-    rotationEuler = glm::degrees(glm::eulerAngles(rotation));
-
-    // Mark the model as dirty to recalculate when needed
-    m_dirty = false;
-
-    // Store the model matrix directly
-    m_model = modelMatrix;
+    MarkChanged();
 }
 
 bee::Renderable::Renderable()
@@ -2,6 +2,56 @@
 #include "core.hpp"
 #include "cereal/cereal_optional_nvp.h"
 
+void bee::ResolveHierarchyLinks(entt::registry& registry,
+                                std::unordered_map<entt::entity, entt::entity>& entity_mapping,
+                                const LoadedLinks& links)
+{
+    if (links.empty())
+    {
+        ecs::UpdateEntityMapping(entity_mapping, registry);
+        return;
+    }
+
+    // the saved UUIDs, a loaded entity whose UUID was already taken still answers to the one it was saved with
+    std::unordered_map<uint64_t, entt::entity> loaded;
+    for (const auto& [entity, entityLinks] : links)
+    {
+        if (entityLinks.uuid != 0) loaded[entityLinks.uuid] = entity;
+    }
+    auto Resolve = [&](uint64_t uuid)
+    {
+        if (uuid == 0) return entt::entity(entt::null);
+        auto it = loaded.find(uuid);
+        return it != loaded.end() ? it->second : ecs::FindEntityByUUID(registry, UUID(uuid));
+    };
+
+    for (const auto& [entity, entityLinks] : links)
+    {
+        auto* node = registry.try_get<HierarchyNode>(entity);
+        if (!node) continue;
+
+        node->parent = Resolve(entityLinks.parent);
+        node->children.clear();
+        for (uint64_t childUUID : entityLinks.children)
+        {
+            const entt::entity child = Resolve(childUUID);
+            if (child != entt::null) node->children.push_back(child);
+        }
+    }
+
+    // a parent that was not loaded along, like the parent of an entity that comes back with undo, gets its child back
+    for (const auto& [entity, entityLinks] : links)
+    {
+        const auto* node = registry.try_get<HierarchyNode>(entity);
+        if (!node || node->parent == entt::null || loaded.count(entityLinks.parent)) continue;
+
+        auto* parentNode = registry.try_get<HierarchyNode>(node->parent);
+        if (parentNode && std::find(parentNode->children.begin(), parentNode->children.end(), entity) ==
+                              parentNode->children.end())
+            parentNode->children.push_back(entity);
+    }
+}
+
 void bee::saveRegistry(entt::registry& registry, const fs::path& filename)
 {
     // check if the file and directory exists
@@ -83,6 +133,63 @@ entt::entity bee::loadEntity(entt::registry& registry, const fs::path& filename)
     return newEntity;
 }
 
+std::vector<bee::benchmark::Result> bee::BenchmarkSerialization()
+{
+    // stress scenes in local registries through a file in the temp directory, the running scene is not touched
+    const fs::path path = fs::temp_directory_path() / "bee_benchmark.scene";
+    std::vector<benchmark::Result> results;
+    for (int count : {1000, 10000, 50000})
+    {
+        ecs::StressSceneSettings settings;
+        settings.entityCount = count;
+        entt::registry registry;
+        ecs::GenerateStressScene(registry, settings);
+        const size_t entities = static_cast<size_t>(count);
+
+        results.push_back(
+            benchmark::MeasureSize("saveRegistry", entities, entities, [&]() { saveRegistry(registry, path); }, 3));
+
+        size_t loaded = 0;
+        results.push_back(benchmark::MeasureSize("LoadRegistry",
+                                                 entities,
+                                                 entities,
+                                                 [&]()
+                                                 {
+                                                     entt::registry scene;
+                                                     LoadRegistry(scene, path);
+                                                     loaded = scene.storage<Saveable>().size();
+                                                 },
+                                                 3));
+        if (loaded != entities) bee::benchmark::Fail("Saved {} entities but loaded {}", entities, loaded);
+
+        // the hierarchy comes back through the UUIDs, every entity has to keep its parent and its children in order
+        std::unordered_map<uint64_t, std::vector<uint64_t>> savedLinks;
+        for (auto [entity, node] : registry.view<HierarchyNode>().each())
+        {
+            std::vector<uint64_t>& entityLinks = savedLinks[ecs::GetUUID(registry, entity)];
+            entityLinks.push_back(node.parent == entt::null ? 0 : static_cast<uint64_t>(ecs::GetUUID(registry, node.parent)));
+            for (auto child : node.children) entityLinks.push_back(ecs::GetUUID(registry, child));
+        }
+        entt::registry scene;
+        LoadRegistry(scene, path);
+        size_t wrongLinks = 0;
+        for (auto [entity, node] : scene.view<HierarchyNode>().each())
+        {
+            std::vector<uint64_t> entityLinks;
+            entityLinks.push_back(node.parent == entt::null ? 0 : static_cast<uint64_t>(ecs::GetUUID(scene, node.parent)));
+            for (auto child : node.children) entityLinks.push_back(ecs::GetUUID(scene, child));
+            auto it = savedLinks.find(ecs::GetUUID(scene, entity));
+            if (it == savedLinks.end() || it->second != entityLinks) wrongLinks++;
+        }
+        if (wrongLinks > 0)
+            bee::benchmark::Fail("{} of {} entities lost their hierarchy links when loaded", wrongLinks, entities);
+    }
+
+    std::error_code error;
+    fs::remove(path, error);
+    return results;
+}
+
 
 
 /*
@@ -1,6 +1,35 @@
 #include "ecs/enttHelper.hpp"
 #include "core.hpp"
 
+namespace bee::internal
+{
+// Walks the original tree and its copy side by side and counts the links that don't mirror each other
+static size_t WrongDuplicateLinks(entt::registry& registry, entt::entity original, entt::entity copy)
+{
+    if (copy == original || !registry.valid(copy) || !registry.all_of<bee::HierarchyNode>(copy)) return 1;
+    const auto& originalNode = registry.get<bee::HierarchyNode>(original);
+    const auto& copyNode = registry.get<bee::HierarchyNode>(copy);
+    if (originalNode.children.size() != copyNode.children.size()) return 1;
+
+    size_t wrong = 0;
+    for (size_t i = 0; i < originalNode.children.size(); i++)
+    {
+        const entt::entity originalChild = originalNode.children[i];
+        const entt::entity copyChild = copyNode.children[i];
+        if (registry.get<bee::HierarchyNode>(originalChild).parent != original) wrong++;
+        if (copyChild == originalChild || !registry.valid(copyChild) ||
+            registry.get<bee::HierarchyNode>(copyChild).parent != copy)
+        {
+            wrong++;
+            continue;
+        }
+        wrong += WrongDuplicateLinks(registry, originalChild, copyChild);
+    }
+    return wrong;
+}
+}  // namespace bee::internal
+using namespace bee::internal;
+
 void bee::ecs::DuplicateEntityRecursive(entt::registry& registry,
                                         entt::entity sourceEntity,
                                         std::unordered_map<entt::entity, entt::entity>& entityMap)
@@ -8,7 +37,7 @@ void bee::ecs::DuplicateEntityRecursive(entt::registry& registry,
     if (entityMap.find(sourceEntity) != entityMap.end()) return;  // Already duplicated
 
     // Create a new entity in the registry
-    entt::entity newEntity = ecs::CreateEmpty();
+    entt::entity newEntity = registry.create();
     entityMap[sourceEntity] = newEntity;
 
     for (auto [id, storage] : registry.storage())
@@ -19,27 +48,35 @@ void bee::ecs::DuplicateEntityRecursive(entt::registry& registry,
         }
     }
 
-    // Handle HierarchyNode separately due to its parent-child structure
-    if (registry.any_of<bee::HierarchyNode>(sourceEntity))
+    // add the entity to the parent children list, children of a duplicated parent belong to its copy
+    if (registry.any_of<bee::HierarchyNode>(newEntity))
     {
-        auto& oldNode = registry.get<bee::HierarchyNode>(sourceEntity);
-
-        // Recursively duplicate children
-        for (auto oldChild : oldNode.children)
+        auto& newNode = registry.get<bee::HierarchyNode>(newEntity);
+        if (newNode.parent != entt::null)
         {
-            DuplicateEntityRecursive(registry, oldChild, entityMap);
+            auto parent = entityMap.find(newNode.parent);
+            if (parent != entityMap.end())
+                newNode.parent = parent->second;
+            else
+                registry.get<bee::HierarchyNode>(newNode.parent).children.push_back(newEntity);
         }
     }
 
-    // add the entity to the parent children list
-    if (registry.any_of<bee::HierarchyNode>(newEntity))
+    // Handle HierarchyNode separately due to its parent-child structure
+    if (registry.any_of<bee::HierarchyNode>(sourceEntity))
     {
-        auto& newNode = registry.get<bee::HierarchyNode>(newEntity);
-        if (newNode.parent != entt::null)
+        // copied, the copy still lists the children of the original until they are duplicated
+        const std::vector<entt::entity> oldChildren = registry.get<bee::HierarchyNode>(sourceEntity).children;
+        std::vector<entt::entity> newChildren;
+        newChildren.reserve(oldChildren.size());
+
+        // Recursively duplicate children
+        for (auto oldChild : oldChildren)
         {
-            auto& parentNode = registry.get<bee::HierarchyNode>(newNode.parent);
-            parentNode.children.push_back(newEntity);
+            DuplicateEntityRecursive(registry, oldChild, entityMap);
+            newChildren.push_back(entityMap[oldChild]);
         }
+        registry.get<bee::HierarchyNode>(newEntity).children = std::move(newChildren);
     }
 
     // emitter id
@@ -47,7 +84,7 @@ void bee::ecs::DuplicateEntityRecursive(entt::registry& registry,
     {
         auto& newEmitter = registry.get<Emitter>(newEntity);
 
-        newEmitter.id = rand();
+        newEmitter.id = ThreadRandom().Int(0, std::numeric_limits<int>::max());
     }
 }
 
@@ -77,8 +114,8 @@ void bee::ecs::DuplicateSelectedEntities(entt::registry& registry,
         if (registry.any_of<Emitter>(newEntity))
         {
             auto& emitter = registry.get<Emitter>(newEntity);
-            emitter.id = rand();        // Assign a new unique ID
-            emitter.particleCount = 0;  // Reset particle count
+            emitter.id = ThreadRandom().Int(0, std::numeric_limits<int>::max());  // Assign a new unique ID
+            emitter.particleCount = 0;                                             // Reset particle count
         }
 
         if (registry.all_of<bee::HierarchyNode>(oldEntity))
@@ -200,15 +237,8 @@ std::vector<entt::entity> bee::ecs::GetAllChildren(entt::registry& registry, ent
 std::vector<entt::entity> bee::ecs::FindEntitiesByName(entt::registry& registry, const std::string& name)
 {
     std::vector<entt::entity> entities;
-    auto view = registry.view<HierarchyNode>();
-    for (auto entity : view)
-    {
-        auto& node = view.get<HierarchyNode>(entity);
-        if (node.name == name)
-        {
-            entities.push_back(entity);
-        }
-    }
+    StringId id = 0;
+    if (strings::Find(name, id)) entities = GetNameIndex(registry).Find(id);
 
     if (entities.empty())
     {
@@ -337,7 +367,8 @@ void bee::ecs::UpdateEntityMapping(std::unordered_map<entt::entity, entt::entity
 
 void bee::ecs::MarkAllAsDirty(entt::registry& registry)
 {
-    registry.view<bee::Transform>().each([](auto& transform) { transform.SetDirty(true); });
+    // the cached matrices are rebuilt from the transforms on the next update
+    registry.clear<bee::LocalModel>();
 }
 
 // BoundingInfo Structure
@@ -474,6 +505,102 @@ void bee::ecs::RenderEntity(entt::registry& registry, entt::entity entity, const
     frameBuffer->Unbind();
 }
 
+std::vector<bee::benchmark::Result> bee::ecs::BenchmarkHierarchy()
+{
+    // local registries, the running scene is not touched
+    std::vector<benchmark::Result> results;
+
+    // chains of parents, the world model of the last one multiplies every matrix up to the root
+    constexpr size_t chains = 1000;
+    for (int depth : {1, 4, 16})
+    {
+        entt::registry registry;
+        std::vector<entt::entity> leaves;
+        for (size_t chain = 0; chain < chains; chain++)
+        {
+            entt::entity parent = entt::null;
+            for (int level = 0; level < depth; level++)
+            {
+                const entt::entity entity = registry.create();
+                registry.emplace<Transform>(entity,
+                                            glm::vec3(1.0f, 0.0f, 0.0f),
+                                            glm::quat(glm::vec3(0.0f, 0.1f, 0.0f)),
+                                            glm::vec3(1.0f));
+                auto& node = registry.emplace<HierarchyNode>(entity);
+                if (parent != entt::null)
+                {
+                    node.parent = parent;
+                    registry.get<HierarchyNode>(parent).children.push_back(entity);
+                }
+                parent = entity;
+            }
+            leaves.push_back(parent);
+        }
+        // the local matrices are built up front, only the walk up the parents is measured
+        UpdateModelMatrices(registry);
+
+        glm::mat4 sum(0.0f);
+        results.push_back(benchmark::MeasureSize("GetWorldModel of the deepest child",
+                                                 static_cast<size_t>(depth),
+                                                 chains,
+                                                 [&]()
+                                                 {
+                                                     for (auto leaf : leaves) sum += GetWorldModel(leaf, registry);
+                                                     benchmark::DoNotOptimize(&sum);
+                                                 }));
+    }
+
+    // one full tree of the stress scene, the copies are kept until the end so every repeat copies the same tree
+    for (int depth : {2, 3, 4, 5})
+    {
+        StressSceneSettings settings;
+        settings.depth = depth;
+        size_t treeSize = 0;
+        for (int level = 0, width = 1; level < depth; level++, width *= settings.fanOut) treeSize += static_cast<size_t>(width);
+        settings.entityCount = static_cast<int>(treeSize) + 2;  // the scene data and the light come first
+
+        entt::registry registry;
+        GenerateStressScene(registry, settings);
+        entt::entity root = entt::null;
+        for (auto [entity, node] : registry.view<HierarchyNode>().each())
+        {
+            if (node.parent == entt::null && !node.children.empty()) root = entity;
+        }
+
+        // a subtree that has a parent, its copy has to end up next to it with every link pointing into the copy
+        const entt::entity subtree = registry.get<HierarchyNode>(root).children.front();
+        const size_t siblings = registry.get<HierarchyNode>(root).children.size();
+        const size_t entities = registry.storage<HierarchyNode>().size();
+        entt::entity subtreeCopy = DuplicateEntity(registry, subtree);
+        const auto& rootChildren = registry.get<HierarchyNode>(root).children;
+        size_t wrongLinks = WrongDuplicateLinks(registry, subtree, subtreeCopy);
+        if (wrongLinks == 0 && registry.get<HierarchyNode>(subtreeCopy).parent != root) wrongLinks++;
+        if (rootChildren.size() != siblings + 1 || std::count(rootChildren.begin(), rootChildren.end(), subtreeCopy) != 1)
+            wrongLinks++;
+        const size_t copied = registry.storage<HierarchyNode>().size() - entities;
+        const size_t subtreeSize = (treeSize - 1) / static_cast<size_t>(settings.fanOut);
+        if (wrongLinks > 0 || copied != subtreeSize)
+            bee::benchmark::Fail("Duplicating a subtree at depth {} copied {} of {} entities with {} wrong parent/child links",
+                                 depth,
+                                 copied,
+                                 subtreeSize,
+                                 wrongLinks);
+        if (registry.valid(subtreeCopy)) DestroyEntity(subtreeCopy, registry);
+
+        std::vector<entt::entity> copies;
+        results.push_back(benchmark::MeasureSize("DuplicateEntityRecursive",
+                                                 treeSize,
+                                                 treeSize,
+                                                 [&]() { copies.push_back(DuplicateEntity(registry, root)); }));
+        for (auto copy : copies) DestroyEntity(copy, registry);
+        if (registry.storage<HierarchyNode>().size() != treeSize + 2)
+            bee::benchmark::Fail("Destroying the duplicated trees left {} entities behind",
+                                 registry.storage<HierarchyNode>().size() - treeSize - 2);
+    }
+
+    return results;
+}
+
 
 /*
 Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
@@ -0,0 +1,89 @@
+#include "ecs/nameIndex.hpp"
+#include "ecs/components.hpp"
+
+namespace bee::ecs::internal
+{
+const std::vector<entt::entity> noEntities;
+
+void OnNodeConstruct(entt::registry& registry, entt::entity entity)
+{
+    registry.ctx().get<NameIndex>().Add(entity, registry.get<HierarchyNode>(entity).name.id());
+}
+
+void OnNodeUpdate(entt::registry& registry, entt::entity entity)
+{
+    NameIndex& index = registry.ctx().get<NameIndex>();
+    index.Remove(entity);
+    index.Add(entity, registry.get<HierarchyNode>(entity).name.id());
+}
+
+void OnNodeDestroy(entt::registry& registry, entt::entity entity) { registry.ctx().get<NameIndex>().Remove(entity); }
+
+}  // namespace bee::ecs::internal
+
+using namespace bee::ecs::internal;
+
+const std::vector<entt::entity>& bee::ecs::NameIndex::Find(StringId name) const
+{
+    auto it = m_entities.find(name);
+    if (it == m_entities.end()) return noEntities;
+    return it->second;
+}
+
+void bee::ecs::NameIndex::Add(entt::entity entity, StringId name)
+{
+    m_entities[name].push_back(entity);
+    m_names[entity] = name;
+}
+
+void bee::ecs::NameIndex::Remove(entt::entity entity)
+{
+    auto nameIt = m_names.find(entity);
+    if (nameIt == m_names.end()) return;
+
+    auto it = m_entities.find(nameIt->second);
+    if (it != m_entities.end())
+    {
+        auto& entities = it->second;
+        auto entityIt = std::find(entities.begin(), entities.end(), entity);
+        if (entityIt != entities.end())
+        {
+            // order does not matter, swap with the last one
+            *entityIt = entities.back();
+            entities.pop_back();
+        }
+        if (entities.empty()) m_entities.erase(it);
+    }
+    m_names.erase(nameIt);
+}
+
+void bee::ecs::NameIndex::Rebuild(entt::registry& registry)
+{
+    m_entities.clear();
+    m_names.clear();
+    registry.view<HierarchyNode>().each([&](entt::entity entity, HierarchyNode& node) { Add(entity, node.name.id()); });
+}
+
+bee::ecs::NameIndex& bee::ecs::GetNameIndex(entt::registry& registry)
+{
+    if (auto* index = registry.ctx().find<NameIndex>()) return *index;
+
+    NameIndex& index = registry.ctx().emplace<NameIndex>();
+    registry.on_construct<HierarchyNode>().connect<&OnNodeConstruct>();
+    registry.on_update<HierarchyNode>().connect<&OnNodeUpdate>();
+    registry.on_destroy<HierarchyNode>().connect<&OnNodeDestroy>();
+    index.Rebuild(registry);
+    return index;
+}
+
+void bee::ecs::SetName(entt::registry& registry, entt::entity entity, const std::string& name)
+{
+    GetNameIndex(registry);
+    registry.patch<HierarchyNode>(entity, [&](HierarchyNode& node) { node.name = name; });
+}
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
@@ -0,0 +1,105 @@
+#include "ecs/registryStats.hpp"
+#include "core.hpp"
+
+namespace bee::ecs::internal
+{
+std::unordered_map<entt::id_type, size_t>& GetComponentSizes()
+{
+    static std::unordered_map<entt::id_type, size_t> sizes;
+    return sizes;
+}
+
+size_t GetComponentSize(entt::id_type id)
+{
+    auto& sizes = GetComponentSizes();
+    auto it = sizes.find(id);
+    if (it != sizes.end()) return it->second;
+
+    // fall back to the meta type for components that were only registered with entt::meta
+    if (auto meta_type = entt::resolve(id)) return meta_type.size_of();
+    return 0;
+}
+}  // namespace bee::ecs::internal
+
+using namespace bee::ecs;
+using namespace bee::ecs::internal;
+
+void bee::ecs::internal::RegisterComponentSize(entt::id_type id, size_t size) { GetComponentSizes()[id] = size; }
+
+size_t bee::ecs::RegistryStats::TotalBytes() const
+{
+    size_t bytes = entityBytes;
+    for (const auto& storage : storages) bytes += storage.TotalBytes();
+    return bytes;
+}
+
+size_t bee::ecs::RegistryStats::UnusedBytes() const
+{
+    size_t bytes = 0;
+    for (const auto& storage : storages) bytes += storage.UnusedBytes();
+    return bytes;
+}
+
+RegistryStats bee::ecs::GetRegistryStats(entt::registry& registry)
+{
+    PROFILE_FUNCTION();
+    RegistryStats stats;
+
+    auto& entityStorage = registry.storage<entt::entity>();
+    const entt::sparse_set& identifiers = entityStorage;
+    stats.entities = entityStorage.in_use();
+    stats.releasedEntities = entityStorage.size() - entityStorage.in_use();
+    stats.entityBytes = (identifiers.capacity() + identifiers.extent()) * sizeof(entt::entity);
+
+    constexpr uint32_t versionMask = entt::entt_traits<entt::entity>::version_mask;
+    for (auto entity : identifiers)
+    {
+        const uint32_t version = entt::to_version(entity);
+        stats.maxVersion = std::max(stats.maxVersion, version);
+        if (version >= versionMask - versionMask / 16) stats.nearVersionWrap++;
+    }
+
+    for (auto&& [id, storage] : registry.storage())
+    {
+        StorageStats storageStats;
+        storageStats.id = id;
+        storageStats.name = std::string(storage.type().name());
+        storageStats.size = storage.size();
+        // capacity() is overridden by component storages to count payload pages, the base class gives the packed array
+        storageStats.capacity = storage.capacity();
+        storageStats.packedCapacity = storage.entt::sparse_set::capacity();
+        storageStats.extent = storage.extent();
+        storageStats.componentSize = GetComponentSize(id);
+        storageStats.componentBytes = storageStats.capacity * storageStats.componentSize;
+        storageStats.packedBytes = storageStats.packedCapacity * sizeof(entt::entity);
+        storageStats.sparseBytes = storageStats.extent * sizeof(entt::entity);
+        stats.storages.push_back(std::move(storageStats));
+    }
+
+    return stats;
+}
+
+size_t bee::ecs::ShrinkRegistry(entt::registry& registry)
+{
+    PROFILE_FUNCTION();
+    const size_t before = GetRegistryStats(registry).TotalBytes();
+
+    for (auto&& [id, storage] : registry.storage())
+    {
+        // storages with in place deletion keep tombstones around until compacted
+        if (storage.policy() == entt::deletion_policy::in_place) storage.compact();
+        storage.shrink_to_fit();
+    }
+    registry.storage<entt::entity>().shrink_to_fit();
+
+    const size_t after = GetRegistryStats(registry).TotalBytes();
+    const size_t reclaimed = before > after ? before - after : 0;
+    bee::Log::Info("Registry shrunk from {} to {} bytes", before, after);
+    return reclaimed;
+}
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
@@ -0,0 +1,149 @@
+#include "ecs/snapshot.hpp"
+#include "core.hpp"
+
+namespace bee::ecs::internal
+{
+struct SnapshotFunctions
+{
+    CaptureFunction capture = nullptr;
+    RestoreFunction restore = nullptr;
+};
+
+std::unordered_map<entt::id_type, SnapshotFunctions>& GetSnapshotFunctions()
+{
+    static std::unordered_map<entt::id_type, SnapshotFunctions> functions;
+    return functions;
+}
+
+std::unordered_set<entt::id_type> warnedStorages;
+}  // namespace bee::ecs::internal
+
+using namespace bee::ecs;
+using namespace bee::ecs::internal;
+
+void bee::ecs::internal::RegisterSnapshotFunctions(entt::id_type id, CaptureFunction capture, RestoreFunction restore)
+{
+    GetSnapshotFunctions()[id] = {capture, restore};
+}
+
+void bee::ecs::RegistrySnapshot::Capture(entt::registry& registry)
+{
+    PROFILE_FUNCTION();
+    Clear();
+
+    for (auto&& [entity] : registry.storage<entt::entity>().each())
+    {
+        if (registry.any_of<EditorComponent>(entity)) continue;
+        m_entities.push_back(entity);
+    }
+
+    auto& functions = GetSnapshotFunctions();
+    for (auto&& [id, storage] : registry.storage())
+    {
+        if (storage.empty()) continue;
+
+        auto it = functions.find(id);
+        if (it == functions.end())
+        {
+            if (warnedStorages.insert(id).second)
+            {
+                bee::Log::Warn("Storage {} is not registered for snapshots, it will not be restored",
+                               storage.type().name());
+            }
+            continue;
+        }
+
+        Storage snapshot;
+        snapshot.id = id;
+        it->second.capture(registry, snapshot);
+        if (!snapshot.entities.empty()) m_storages.push_back(std::move(snapshot));
+    }
+}
+
+void bee::ecs::RegistrySnapshot::Restore(entt::registry& registry)
+{
+    PROFILE_FUNCTION();
+
+    // recreate the entities with their old identifiers, only remap if the slot got taken in the meantime
+    std::unordered_map<entt::entity, entt::entity> entity_mapping;
+    for (auto entity : m_entities)
+    {
+        entt::entity newEntity = registry.valid(entity) ? registry.create() : registry.create(entity);
+        if (newEntity != entity) entity_mapping[entity] = newEntity;
+    }
+
+    auto& functions = GetSnapshotFunctions();
+    for (const auto& snapshot : m_storages)
+    {
+        const auto& restore = functions[snapshot.id].restore;
+        if (entity_mapping.empty())
+        {
+            restore(registry, snapshot);
+            continue;
+        }
+
+        Storage remapped = snapshot;
+        for (auto& entity : remapped.entities)
+        {
+            auto it = entity_mapping.find(entity);
+            if (it != entity_mapping.end()) entity = it->second;
+        }
+        restore(registry, remapped);
+    }
+
+    if (!entity_mapping.empty())
+    {
+        bee::Log::Warn("{} entities could not keep their id when restoring the snapshot", entity_mapping.size());
+        UpdateEntityMapping(entity_mapping, registry);
+    }
+}
+
+void bee::ecs::RegistrySnapshot::Clear()
+{
+    m_entities.clear();
+    m_storages.clear();
+}
+
+size_t bee::ecs::RegistrySnapshot::Bytes() const
+{
+    size_t bytes = m_entities.size() * sizeof(entt::entity);
+    for (const auto& storage : m_storages) bytes += storage.bytes;
+    return bytes;
+}
+
+std::vector<bee::benchmark::Result> bee::ecs::BenchmarkSnapshot()
+{
+    std::vector<benchmark::Result> results;
+    if (bee::Engine.IsPlaying())
+    {
+        bee::Log::Warn("Snapshot benchmark only runs outside of play mode");
+        return results;
+    }
+
+    auto& registry = bee::Engine.Registry();
+    RegistrySnapshot snapshot;
+    snapshot.Capture(registry);
+    const size_t entityCount = std::max<size_t>(snapshot.EntityCount(), 1);
+
+    results.push_back(benchmark::Measure("Snapshot Capture (" + std::to_string(snapshot.EntityCount()) + " entities)",
+                                         entityCount,
+                                         [&]() { snapshot.Capture(registry); }));
+
+    // unloading and restoring leaves the scene exactly as it was
+    results.push_back(benchmark::Measure("Snapshot Unload + Restore",
+                                         entityCount,
+                                         [&]()
+                                         {
+                                             UnloadScene();
+                                             snapshot.Restore(registry);
+                                         }));
+
+    bee::Log::Info("Scene snapshot uses {} bytes", snapshot.Bytes());
+    return results;
+}
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
@@ -0,0 +1,254 @@
+#include "ecs/stressScene.hpp"
+#include "core.hpp"
+
+namespace bee::internal
+{
+static const char* stressMeshes[] = {"models/cube.obj", "models/sphere.obj", "models/quad.obj"};
+static const char* stressTextures[] = {"textures/white.png",
+                                       "textures/checkerboard.png",
+                                       "textures/uv_test_image.png",
+                                       "textures/wood_0053_color_1k.jpg",
+                                       "textures/gray.png",
+                                       "textures/red.png",
+                                       "textures/blue.png",
+                                       "textures/smoke.png"};
+
+static bee::ecs::StressSceneDecorator registeredDecorator = nullptr;
+static void* registeredDecoratorContext = nullptr;
+
+// An entity that can still take children
+struct StressNode
+{
+    entt::entity entity = entt::null;
+    int level = 0;
+    int children = 0;
+};
+
+// Rejection sampling inside the unit 4D ball, there is no trigonometry that could round differently per platform
+static glm::quat RandomRotation(bee::Random& random)
+{
+    while (true)
+    {
+        const float w = random.Float(-1.0f, 1.0f);
+        const float x = random.Float(-1.0f, 1.0f);
+        const float y = random.Float(-1.0f, 1.0f);
+        const float z = random.Float(-1.0f, 1.0f);
+        const float lengthSquared = w * w + x * x + y * y + z * z;
+        if (lengthSquared < 1e-4f || lengthSquared > 1.0f) continue;
+
+        const float length = std::sqrt(lengthSquared);
+        return glm::quat(w / length, x / length, y / length, z / length);
+    }
+}
+
+// Drawn one channel at a time, the order of function arguments is not defined
+static glm::vec4 RandomColor(bee::Random& random, float min)
+{
+    const float r = random.Float(min, 1.0f);
+    const float g = random.Float(min, 1.0f);
+    const float b = random.Float(min, 1.0f);
+    return glm::vec4(r, g, b, 1.0f);
+}
+
+static entt::entity CreateStressEntity(entt::registry& registry, bee::Random& random, const std::string& name)
+{
+    const entt::entity entity = registry.create();
+    registry.emplace<bee::UUID>(entity, random.Next() | 1ull);  // 0 is not a valid id
+    registry.emplace<bee::HierarchyNode>(entity, name);
+    registry.emplace<bee::Saveable>(entity);
+    return entity;
+}
+}  // namespace bee::internal
+using namespace bee::internal;
+
+bee::ecs::StressSceneStats bee::ecs::GenerateStressScene(entt::registry& registry, const StressSceneSettings& settings)
+{
+    PROFILE_FUNCTION();
+
+    Random random(settings.seed);
+    StressSceneStats stats;
+
+    // loaded once and shared by every renderable, like the instances of a real scene
+    const int meshCount = std::clamp(settings.meshVariety, 1, static_cast<int>(std::size(stressMeshes)));
+    const int textureCount = std::clamp(settings.textureVariety, 1, static_cast<int>(std::size(stressTextures)));
+    std::vector<fs::path> meshPaths;
+    std::vector<Ref<resource::Mesh>> meshes;
+    for (int i = 0; i < meshCount; i++)
+    {
+        meshPaths.push_back(Engine.FileIO().GetPath(FileIO::Directory::SharedAssets, stressMeshes[i]));
+        meshes.push_back(resource::LoadResource<resource::Mesh>(meshPaths.back()));
+    }
+    std::vector<fs::path> texturePaths;
+    std::vector<Ref<resource::Texture>> textures;
+    for (int i = 0; i < textureCount; i++)
+    {
+        texturePaths.push_back(Engine.FileIO().GetPath(FileIO::Directory::SharedAssets, stressTextures[i]));
+        textures.push_back(resource::LoadResource<resource::Texture>(texturePaths.back()));
+    }
+
+    // every scene gets its sky and sun, they count towards the entities
+    const entt::entity sceneData = CreateStressEntity(registry, random, "Scene Data");
+    registry.emplace<Transform>(sceneData);
+    registry.emplace<SceneData>(sceneData);
+
+    // pitched 50 degrees down, written out instead of built from euler angles
+    const entt::entity sun = CreateStressEntity(registry, random, "Directional Light");
+    const glm::quat sunRotation(0.9063078f, -0.4226183f, 0.0f, 0.0f);
+    registry.emplace<Transform>(sun, glm::vec3(0.0f, 50.0f, 0.0f), sunRotation, glm::vec3(1.0f));
+    registry.emplace<DirectionalLight>(sun);
+    registry.emplace<EditorIcon>(sun, "icons/Directional_Light.png");
+    stats.entities = 2;
+    stats.roots = 2;
+
+    const int depth = std::max(settings.depth, 1);
+    const int fanOut = std::max(settings.fanOut, 1);
+    const float emitterEnd = settings.emitterFraction;
+    const float pointLightEnd = emitterEnd + settings.pointLightFraction;
+    const float renderableEnd = pointLightEnd + settings.renderableFraction;
+
+    std::vector<StressNode> open;  // in creation order, so the trees are filled breadth first
+    open.reserve(static_cast<size_t>(std::max(settings.entityCount, 0)));
+    size_t next = 0;
+
+    for (int i = static_cast<int>(stats.entities); i < settings.entityCount; i++)
+    {
+        // a tree is filled up to its depth and fan-out before the next root is started
+        while (next < open.size() && open[next].children >= fanOut) next++;
+        const bool isRoot = next == open.size();
+        const entt::entity parent = isRoot ? entt::null : open[next].entity;
+        const int level = isRoot ? 0 : open[next].level + 1;
+        if (!isRoot) open[next].children++;
+
+        const float offset = isRoot ? settings.extent : settings.childOffset;
+        const float x = random.Float(-offset, offset);
+        const float y = random.Float(-offset, offset);
+        const float z = random.Float(-offset, offset);
+        const glm::quat rotation = RandomRotation(random);
+        const float scale = random.Float(0.5f, 1.5f);
+        const float kind = random.Float();
+        const bool raycastable = random.Float() < settings.raycastableFraction;
+
+        const char* name = kind < emitterEnd      ? "Emitter "
+                           : kind < pointLightEnd ? "Point Light "
+                           : kind < renderableEnd ? "Mesh "
+                                                  : "Node ";
+        const entt::entity entity = CreateStressEntity(registry, random, name + std::to_string(i));
+        registry.emplace<Transform>(entity, glm::vec3(x, y, z), rotation, glm::vec3(scale));
+
+        if (kind < emitterEnd)
+        {
+            Emitter& emitter = registry.emplace<Emitter>(entity);
+            emitter.specs.spawnCountPerSecond = random.Float(5.0f, 50.0f);
+            emitter.specs.maxParticles = random.Int(20, 200);
+            emitter.id = random.Int(0, std::numeric_limits<int>::max());
+            registry.emplace<EditorIcon>(entity, "icons/Emitter.png");
+            stats.emitters++;
+        }
+        else if (kind < pointLightEnd)
+        {
+            PointLight& light = registry.emplace<PointLight>(entity);
+            light.color = RandomColor(random, 0.5f);
+            light.range = random.Float(5.0f, 25.0f);
+            stats.pointLights++;
+        }
+        else if (kind < renderableEnd)
+        {
+            const int mesh = random.Int(0, meshCount - 1);
+            const int texture = random.Int(0, textureCount - 1);
+            const glm::vec4 multiplier = RandomColor(random, 0.25f);
+            Renderable& renderable =
+                registry.emplace<Renderable>(entity, meshes[mesh], textures[texture], multiplier, DEFAULT_TINT_COLOR);
+            renderable.meshPath = meshPaths[mesh];
+            renderable.texturePath = texturePaths[texture];
+            stats.renderables++;
+        }
+
+        if (raycastable)
+        {
+            registry.emplace<Raycastable>(entity);
+            stats.raycastables++;
+        }
+
+        // linked directly, the generated transform already is the local one
+        if (isRoot)
+        {
+            stats.roots++;
+        }
+        else
+        {
+            registry.get<HierarchyNode>(entity).parent = parent;
+            registry.get<HierarchyNode>(parent).children.push_back(entity);
+        }
+        if (level + 1 < depth) open.push_back({entity, level, 0});
+
+        if (settings.decorate) settings.decorate(registry, entity, random, settings.decorateContext);
+        stats.entities++;
+    }
+
+    return stats;
+}
+
+void bee::ecs::RegisterStressSceneDecorator(StressSceneDecorator decorate, void* context)
+{
+    registeredDecorator = decorate;
+    registeredDecoratorContext = context;
+}
+
+void bee::ecs::UseRegisteredDecorator(StressSceneSettings& settings)
+{
+    if (!registeredDecorator) return;
+    settings.decorate = registeredDecorator;
+    settings.decorateContext = registeredDecoratorContext;
+}
+
+bee::ecs::StressSceneStats bee::ecs::SaveStressScene(const StressSceneSettings& settings, const fs::path& path)
+{
+    PROFILE_FUNCTION();
+
+    entt::registry registry;
+    const StressSceneStats stats = GenerateStressScene(registry, settings);
+    saveRegistry(registry, path);
+
+    bee::Log::Info("Wrote stress scene {} with seed {}: {} entities, {} roots, {} renderables, {} raycastables, "
+                   "{} emitters, {} point lights",
+                   path.string(),
+                   settings.seed,
+                   stats.entities,
+                   stats.roots,
+                   stats.renderables,
+                   stats.raycastables,
+                   stats.emitters,
+                   stats.pointLights);
+    return stats;
+}
+
+std::vector<bee::benchmark::Result> bee::ecs::BenchmarkStressScene()
+{
+    StressSceneSettings settings;
+    settings.entityCount = 10000;
+
+    std::vector<benchmark::Result> results;
+    results.push_back(benchmark::Measure("Generate stress scene",
+                                         static_cast<size_t>(settings.entityCount),
+                                         [&]()
+                                         {
+                                             entt::registry registry;
+                                             GenerateStressScene(registry, settings);
+                                         }));
+
+    // the same seed has to give the same entities with the same transforms
+    entt::registry first;
+    entt::registry second;
+    GenerateStressScene(first, settings);
+    GenerateStressScene(second, settings);
+    if (InputReplay::HashRegistry(first) != InputReplay::HashRegistry(second))
+        bee::benchmark::Fail("Generating a stress scene twice with seed {} gave two different scenes", settings.seed);
+
+    return results;
+}
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
@@ -0,0 +1,93 @@
+#include "ecs/uuidIndex.hpp"
+
+namespace bee::ecs::internal
+{
+void IndexUUID(entt::registry& registry, entt::entity entity)
+{
+    UUIDIndex& index = registry.ctx().get<UUIDIndex>();
+    UUID& uuid = registry.get<UUID>(entity);
+    while (!uuid.IsValid() || !index.Add(entity, uuid))
+    {
+        uuid = UUID();
+    }
+}
+
+void OnUUIDConstruct(entt::registry& registry, entt::entity entity) { IndexUUID(registry, entity); }
+
+void OnUUIDUpdate(entt::registry& registry, entt::entity entity)
+{
+    registry.ctx().get<UUIDIndex>().Remove(entity);
+    IndexUUID(registry, entity);
+}
+
+void OnUUIDDestroy(entt::registry& registry, entt::entity entity) { registry.ctx().get<UUIDIndex>().Remove(entity); }
+
+}  // namespace bee::ecs::internal
+
+using namespace bee::ecs::internal;
+
+entt::entity bee::ecs::UUIDIndex::Find(uint64_t uuid) const
+{
+    auto it = m_entities.find(uuid);
+    if (it == m_entities.end()) return entt::null;
+    return it->second;
+}
+
+bool bee::ecs::UUIDIndex::Add(entt::entity entity, uint64_t uuid)
+{
+    auto [it, inserted] = m_entities.try_emplace(uuid, entity);
+    if (!inserted && it->second != entity) return false;
+    m_uuids[entity] = uuid;
+    return true;
+}
+
+void bee::ecs::UUIDIndex::Remove(entt::entity entity)
+{
+    auto it = m_uuids.find(entity);
+    if (it == m_uuids.end()) return;
+
+    auto entityIt = m_entities.find(it->second);
+    if (entityIt != m_entities.end() && entityIt->second == entity) m_entities.erase(entityIt);
+    m_uuids.erase(it);
+}
+
+void bee::ecs::UUIDIndex::Rebuild(entt::registry& registry)
+{
+    m_entities.clear();
+    m_uuids.clear();
+    for (auto entity : registry.view<UUID>())
+    {
+        IndexUUID(registry, entity);
+    }
+}
+
+bee::ecs::UUIDIndex& bee::ecs::GetUUIDIndex(entt::registry& registry)
+{
+    if (auto* index = registry.ctx().find<UUIDIndex>()) return *index;
+
+    UUIDIndex& index = registry.ctx().emplace<UUIDIndex>();
+    registry.on_construct<UUID>().connect<&OnUUIDConstruct>();
+    registry.on_update<UUID>().connect<&OnUUIDUpdate>();
+    registry.on_destroy<UUID>().connect<&OnUUIDDestroy>();
+    index.Rebuild(registry);
+    return index;
+}
+
+entt::entity bee::ecs::FindEntityByUUID(entt::registry& registry, UUID uuid)
+{
+    if (!uuid.IsValid()) return entt::null;
+    return GetUUIDIndex(registry).Find(uuid);
+}
+
+bee::UUID bee::ecs::GetUUID(const entt::registry& registry, entt::entity entity)
+{
+    if (!registry.valid(entity)) return UUID(0);
+    if (const auto* uuid = registry.try_get<UUID>(entity)) return *uuid;
+    return UUID(0);
+}
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
@@ -362,14 +362,7 @@ void bee::EditorLayer::Viewport(const std::string& windowName, const entt::entit
             ImGui::PushFont(font);
             if (ImGui::Button(ICON_FA_STOP, ImVec2(30, 30)))
             {
-                bee::Engine.StopApplication();
-
-                if (!m_loadedSceneName.empty())
-                {
-                    auto& registry = bee::Engine.Registry();
-                    auto path = bee::Engine.FileIO().GetPath(bee::FileIO::Directory::SaveFiles, m_loadedSceneName);
-                    bee::LoadRegistry(registry, path);
-                }
+                ExitPlayMode();
             }
             ImGui::PopStyleColor();
             font->Scale = 1.0f;
@@ -399,8 +392,7 @@ void bee::EditorLayer::Viewport(const std::string& windowName, const entt::entit
                     }
                     else
                     {
-                        bee::ecs::UnloadScene();
-                        bee::Engine.StartApplication();
+                        EnterPlayMode();
                     }
                 }
             }
@@ -510,15 +502,13 @@ void bee::EditorLayer::Viewport(const std::string& windowName, const entt::entit
         {
             SaveScene();
         }
-        bee::ecs::UnloadScene();
         m_sceneChangedPopup = false;
-        bee::Engine.StartApplication();
+        EnterPlayMode();
     }
     else if (no)
     {
-        bee::ecs::UnloadScene();
         m_sceneChangedPopup = false;
-        bee::Engine.StartApplication();
+        EnterPlayMode();
     }
 
     if (m_openSaveAndPlayPopup)
@@ -530,15 +520,13 @@ void bee::EditorLayer::Viewport(const std::string& windowName, const entt::entit
             if (ImGui::Button("Yes"))
             {
                 SaveScene();
-                bee::ecs::UnloadScene();
-                bee::Engine.StartApplication();
+                EnterPlayMode();
                 m_openSaveAndPlayPopup = false;
             }
             ImGui::SameLine();
             if (ImGui::Button("No"))
             {
-                bee::ecs::UnloadScene();
-                bee::Engine.StartApplication();
+                EnterPlayMode();
                 m_openSaveAndPlayPopup = false;
             }
             ImGui::EndPopup();
@@ -546,6 +534,29 @@ void bee::EditorLayer::Viewport(const std::string& windowName, const entt::entit
     }
 }
 
+void bee::EditorLayer::EnterPlayMode()
+{
+    m_playSnapshot.Capture(bee::Engine.Registry());
+    bee::ecs::UnloadScene();
+    bee::Engine.StartApplication();
+
+    // a layer that failed to attach stops the application again, which unloads the scene; the snapshot is the only copy
+    // of the editor scene when it was not saved
+    if (!bee::Engine.IsPlaying())
+    {
+        m_playSnapshot.Restore(bee::Engine.Registry());
+        m_playSnapshot.Clear();
+    }
+}
+
+void bee::EditorLayer::ExitPlayMode()
+{
+    // stopping unloads whatever the game created, then the editor scene comes back from memory
+    bee::Engine.StopApplication();
+    m_playSnapshot.Restore(bee::Engine.Registry());
+    m_playSnapshot.Clear();
+}
+
 void bee::EditorLayer::UpdateCameraConfig(const entt::entity cameraEntity) const
 {
     switch (m_editorSettings.m_currentCamType)
@@ -705,7 +716,7 @@ void bee::EditorLayer::SceneHierarchy()
     {
         for (auto entity : m_selectedEntities)
         {
-            registry.get<HierarchyNode>(entity).name = entityName;
+            bee::ecs::SetName(registry, entity, entityName);
         }
         m_renameWindow = false;  // Reset the flag after renaming
     }
@@ -749,7 +760,7 @@ void bee::EditorLayer::DrawEntityNode(entt::entity entity)
     }
 
     // Draw a tree node that is also selectable
-    std::string label = ICON_FA_MINUS TAB_FA + node.name;
+    std::string label = ICON_FA_MINUS TAB_FA + node.name.str();
     bool nodeOpen = ImGui::TreeNodeEx(label.c_str(), flags);
 
     // Handle selection logic
@@ -1171,6 +1182,11 @@ void bee::EditorLayer::MenuBar()
                 }
             }
 
+            if (ImGui::MenuItem(ICON_FA_CUBES TAB_FA "Generate Stress Scene..."))
+            {
+                m_stressSceneWindow = true;
+            }
+
             // unload scene
             if (ImGui::MenuItem(ICON_FA_FILE_MINUS TAB_FA "Unload Scene"))
             {
@@ -1274,8 +1290,8 @@ void bee::EditorLayer::MenuBar()
             ImGui::Selectable(ICON_FA_TOOLBOX TAB_FA "Show Toolbar",
                               &m_editorSettings.m_showToolbar,
                               ImGuiSelectableFlags_DontClosePopups);
-            ImGui::Selectable(ICON_FA_CLONE TAB_FA "Interpolate Physics",
-                              &bee::Engine.Settings().interpolateParticles,
+            ImGui::Selectable(ICON_FA_CLONE TAB_FA "Interpolate Transforms",
+                              &bee::Engine.Settings().interpolateTransforms,
                               ImGuiSelectableFlags_DontClosePopups);
             // button that opens a window
             if (ImGui::MenuItem(ICON_FA_GEAR TAB_FA "Editor Settings"))
@@ -1327,6 +1343,62 @@ void bee::EditorLayer::MenuBar()
         ImGui::EndMainMenuBar();
     }
 
+    if (m_stressSceneWindow) ImGui::OpenPopup("Stress Scene Window");
+    if (ImGui::BeginPopupModal("Stress Scene Window", nullptr, ImGuiWindowFlags_AlwaysAutoResize))
+    {
+        bee::ecs::StressSceneSettings& stress = m_stressSceneSettings;
+        int seed = static_cast<int>(stress.seed);
+        ImGui::Text("Seed");
+        if (ImGui::InputInt("##stressSeed", &seed)) stress.seed = static_cast<uint64_t>(std::max(seed, 0));
+        ImGui::Text("Entities");
+        ImGui::SliderInt("##stressEntities", &stress.entityCount, 100, 200000);
+        ImGui::Text("Depth");
+        ImGui::SliderInt("##stressDepth", &stress.depth, 1, 10);
+        ImGui::Text("Fan-out");
+        ImGui::SliderInt("##stressFanOut", &stress.fanOut, 1, 64);
+        ImGui::Text("Extent");
+        ImGui::SliderFloat("##stressExtent", &stress.extent, 10.0f, 2000.0f, "%.0f");
+        if (ImGui::CollapsingHeader(ICON_FA_SHAPES TAB_FA "Components"))
+        {
+            ImGui::Text("Renderable");
+            ImGui::SliderFloat("##stressRenderable", &stress.renderableFraction, 0.0f, 1.0f, "%.3f");
+            ImGui::Text("Raycastable");
+            ImGui::SliderFloat("##stressRaycastable", &stress.raycastableFraction, 0.0f, 1.0f, "%.3f");
+            ImGui::Text("Emitter");
+            ImGui::SliderFloat("##stressEmitter", &stress.emitterFraction, 0.0f, 0.1f, "%.4f");
+            ImGui::Text("Point Light");
+            ImGui::SliderFloat("##stressPointLight", &stress.pointLightFraction, 0.0f, 0.1f, "%.4f");
+            ImGui::Text("Meshes");
+            ImGui::SliderInt("##stressMeshes", &stress.meshVariety, 1, 3);
+            ImGui::Text("Textures");
+            ImGui::SliderInt("##stressTextures", &stress.textureVariety, 1, 8);
+        }
+
+        if (ImGui::Button("Generate..."))
+        {
+            fs::path path = bee::FileDialog::SaveFile(FILE_FILTER("Scene Files", SCENE_EXTENSION));
+            if (!path.empty())
+            {
+                if (path.extension() != SCENE_EXTENSION) path += SCENE_EXTENSION;
+                // the game adds its own components, like colliders, on top of the engine ones
+                bee::ecs::UseRegisteredDecorator(stress);
+                bee::ecs::SaveStressScene(stress, path);
+                bee::ecs::UnloadScene();
+                bee::LoadRegistry(bee::Engine.Registry(), path);
+                m_loadedSceneName = path.filename().string();
+                m_stressSceneWindow = false;
+                ImGui::CloseCurrentPopup();
+            }
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Cancel"))
+        {
+            m_stressSceneWindow = false;
+            ImGui::CloseCurrentPopup();
+        }
+        ImGui::EndPopup();
+    }
+
     if (m_editorSettingsWindow) ImGui::OpenPopup("Editor Settings Window");
     // Settings window, but always set it in the center of the screen
 
@@ -1337,8 +1409,21 @@ void bee::EditorLayer::MenuBar()
         ImGui::SliderFloat("##fixedUpdateRate", &bee::Engine.Settings().fixedUpdateRate, 1.0f, 120.0f, "%.1f");
         ImGui::Text("Time Scale");
         ImGui::SliderFloat("##timeScale", &bee::Engine.Settings().timeScale, 0.001f, 2.0f, "%.3f");
-        ImGui::Text("Interpolate Physics");
-        ImGui::Checkbox("##interpolatePhysics", &bee::Engine.Settings().interpolateParticles);
+        ImGui::Text("Interpolate Transforms");
+        ImGui::Checkbox("##interpolateTransforms", &bee::Engine.Settings().interpolateTransforms);
+        if (ImGui::CollapsingHeader(ICON_FA_WAND_MAGIC_SPARKLES TAB_FA "Particle Budget"))
+        {
+            ParticleBudgetSettings& budget = bee::Engine.Settings().particleBudget;
+            ImGui::Text("Max Particles");
+            ImGui::SliderInt("##maxParticles", &budget.maxParticles, 100, 100000);
+            ImGui::Text("Full Detail Distance");
+            ImGui::SliderFloat("##fullDetailDistance", &budget.fullDetailDistance, 0.0f, 100.0f, "%.1f");
+            ImGui::Text("Cull Distance");
+            ImGui::SliderFloat("##cullDistance", &budget.cullDistance, 1.0f, 1000.0f, "%.1f");
+            ImGui::Text("Min Screen Size");
+            ImGui::SliderFloat("##minScreenSize", &budget.minScreenSize, 0.0f, 0.1f, "%.4f");
+            ImGui::Separator();
+        }
         ImGui::BeginTable("##SettingsTable", 4);
         ImGui::TableNextColumn();
         ImGui::Text("Show Hitboxes");
@@ -1502,8 +1587,8 @@ void bee::EditorLayer::MoveEditorCamera(float deltatime)
             glm::vec2 before = input.GetPreviousMousePosition();
             glm::vec2 after = input.GetMousePosition();
             glm::vec2 mouse_delta = after - before;
-            cameraTransform.SetRotation(cameraTransform.GetRotationEuler() -
-                                        glm::vec3(mouse_delta.y, mouse_delta.x, 0.0f) * m_editorSettings.m_cameraSensitivity);
+            cameraTransform.AddYawPitch(-mouse_delta.x * m_editorSettings.m_cameraSensitivity,
+                                        -mouse_delta.y * m_editorSettings.m_cameraSensitivity);
             break;
         }
         case CamType::Orbit:
@@ -1539,8 +1624,8 @@ void bee::EditorLayer::MoveEditorCamera(float deltatime)
             glm::vec2 before = input.GetPreviousMousePosition();
             glm::vec2 after = input.GetMousePosition();
             glm::vec2 mouse_delta = after - before;
-            cameraTransform.SetRotation(cameraTransform.GetRotationEuler() -
-                                        glm::vec3(mouse_delta.y, mouse_delta.x, 0.0f) * m_editorSettings.m_cameraSensitivity);
+            cameraTransform.AddYawPitch(-mouse_delta.x * m_editorSettings.m_cameraSensitivity,
+                                        -mouse_delta.y * m_editorSettings.m_cameraSensitivity);
             break;
         }
         case CamType::Up:
@@ -1760,52 +1845,38 @@ bool bee::EditorLayer::OnMouseButtonPressed(MouseButtonPressedEvent& e)
 bool bee::EditorLayer::CheckGridIntersections()
 {
     auto& registry = bee::Engine.Registry();
-    auto view = registry.view<Transform, Raycastable, Cell>();
+    auto onlyCells = [&](entt::entity entity) { return registry.all_of<Cell>(entity); };
+    raycasting::SceneHit sceneHit =
+        raycasting::GetSceneBVH(registry).Raycast(m_previousRay, std::numeric_limits<float>::max(), onlyCells);
+    if (sceneHit.entity == entt::null) return false;
 
-    for (auto entity : view)
-    {
-        auto& raycastable = view.get<Raycastable>(entity);
-        if (!raycastable.raycastable) continue;
+    bee::Log::Info("Hit Grid");
 
-        Cell& cell = view.get<Cell>(entity);
-        Grid& grid = registry.get<Grid>(cell.gridParent);
+    Cell& cell = registry.get<Cell>(sceneHit.entity);
+    Transform& cellTransform = registry.get<Transform>(sceneHit.entity);
 
-        Transform& cellTransform = view.get<Transform>(entity);
-
-        glm::mat4 modelMatrix = GetWorldModel(cell.gridParent, registry) * cellTransform.GetModelMatrix();
-
-        raycasting::HitInfo hitInfo = raycasting::IntersectRayWithEntity(m_previousRay, modelMatrix, glm::vec3(grid.tileSize));
-
-        if (hitInfo.hit)
-        {
-            bee::Log::Info("Hit Grid");
-
-            if (cell.entity != entt::null)
-            {
-                bee::ecs::DestroyEntity(cell.entity, registry);
-            }
-
-            // load gltf file from selected asset item
-            entt::entity selectedAssetEntity = m_assetBrowser.GetSelected();
-            if (selectedAssetEntity != entt::null)
-            {
-                AssetItem& assetItem = registry.get<AssetItem>(selectedAssetEntity);
-                auto path = assetItem.path;
-                entt::entity newEntity = bee::resource::LoadGLTF(path, bee::Engine.Registry());
+    if (cell.entity != entt::null)
+    {
+        bee::ecs::DestroyEntity(cell.entity, registry);
+    }
 
-                cell.entity = newEntity;
+    // load gltf file from selected asset item
+    entt::entity selectedAssetEntity = m_assetBrowser.GetSelected();
+    if (selectedAssetEntity != entt::null)
+    {
+        AssetItem& assetItem = registry.get<AssetItem>(selectedAssetEntity);
+        auto path = assetItem.path;
+        entt::entity newEntity = bee::resource::LoadGLTF(path, bee::Engine.Registry());
 
-                Transform& newEntityTransform = registry.get<Transform>(newEntity);
-                newEntityTransform.SetPosition(cellTransform.GetPosition());
+        cell.entity = newEntity;
 
-                bee::ecs::SetParentChildRelationship(newEntity, cell.gridParent, registry, true);
-            }
+        Transform& newEntityTransform = registry.get<Transform>(newEntity);
+        newEntityTransform.SetPosition(cellTransform.GetPosition());
 
-            return true;
-        }
+        bee::ecs::SetParentChildRelationship(newEntity, cell.gridParent, registry, true);
     }
 
-    return false;
+    return true;
 }
 
 void bee::EditorLayer::UpdateGrids()
@@ -1831,28 +1902,11 @@ void bee::EditorLayer::UpdateGrids()
 
 void bee::EditorLayer::CheckEntityIntersections()
 {
-    entt::entity closestEntity = entt::null;
-    float closestDistance = std::numeric_limits<float>::max();
-
     auto& registry = bee::Engine.Registry();
-    auto view = registry.view<Transform, Raycastable>(entt::exclude<Cell>);
-    for (auto entity : view)
-    {
-        glm::vec3 scaler = raycasting::GetEntityScaler(registry, entity);
-        glm::vec3 offset = raycasting::GetEntityOffset(registry, entity);
-
-        // check if it has a parent
-        glm::mat4 modelMatrix = GetWorldModel(entity, registry);
-        modelMatrix = glm::translate(modelMatrix, offset);
-
-        raycasting::HitInfo hitInfo = raycasting::IntersectRayWithEntity(m_previousRay, modelMatrix, scaler);
-
-        if (hitInfo.hit && hitInfo.distance < closestDistance)
-        {
-            closestDistance = hitInfo.distance;
-            closestEntity = entity;
-        }
-    }
+    // cells are picked by CheckGridIntersections
+    auto notCells = [&](entt::entity entity) { return !registry.all_of<Cell>(entity); };
+    entt::entity closestEntity =
+        raycasting::GetSceneBVH(registry).Raycast(m_previousRay, std::numeric_limits<float>::max(), notCells).entity;
 
     if (closestEntity != entt::null)
     {
@@ -1979,33 +2033,60 @@ void bee::EditorLayer::ShowRegistryStats()
     // Begin ImGui window for registry statistics
     if (ImGui::Begin(ICON_FA_CHART_BAR TAB_FA "Registry Stats"))
     {
+        bee::ecs::RegistryStats stats = bee::ecs::GetRegistryStats(registry);
+
         // Display total number of entities using the correct function
-        ImGui::Text("Total Entities: %d", static_cast<int>(registry.storage<entt::entity>().in_use()));
+        ImGui::Text("Total Entities: %zu (%zu released)", stats.entities, stats.releasedEntities);
+        ImGui::Text("Highest Version: %u", stats.maxVersion);
+        if (stats.nearVersionWrap > 0)
+        {
+            ImGui::SameLine();
+            ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.0f, 1.0f), "(%zu ids close to wrapping)", stats.nearVersionWrap);
+        }
+        ImGui::Text("Memory: %.1f KB (%.1f KB unused)", stats.TotalBytes() / 1024.0f, stats.UnusedBytes() / 1024.0f);
+        ImGui::SameLine();
+        if (ImGui::Button("Shrink"))
+        {
+            size_t reclaimed = bee::ecs::ShrinkRegistry(registry);
+            bee::Log::Info("Reclaimed {} bytes from the registry", reclaimed);
+        }
 
         // Iterate through each storage (i.e., each component type) in the registry
         ImGui::Separator();
         ImGui::Text("Component Breakdown:");
         ImGui::Separator();
 
-        // Go through all component storages to gather statistics
-        for (auto&& [component_id, storage] : registry.storage())
-        {
-            // Get the meta type for the component (this assumes you've registered components with entt::meta)
-            auto meta_type = entt::resolve(component_id);
-
-            if (!meta_type)
-            {
-                continue;
+        if (ImGui::BeginTable("Storages", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders))
+        {
+            ImGui::TableSetupColumn("Component");
+            ImGui::TableSetupColumn("Entities");
+            ImGui::TableSetupColumn("Capacity");
+            ImGui::TableSetupColumn("Components (KB)");
+            ImGui::TableSetupColumn("Sparse Set (KB)");
+            ImGui::TableHeadersRow();
+
+            for (const auto& storage : stats.storages)
+            {
+                // Get the name of the component and the number of entities that have it
+                std::string component_name = bee::ComponentManager::CleanTypeName(storage.name);
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(component_name.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%zu", storage.size);
+                ImGui::TableNextColumn();
+                ImGui::Text("%zu", storage.capacity);
+                ImGui::TableNextColumn();
+                if (storage.componentSize > 0)
+                    ImGui::Text("%.1f", storage.componentBytes / 1024.0f);
+                else
+                    ImGui::TextDisabled("-");
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", (storage.packedBytes + storage.sparseBytes) / 1024.0f);
             }
-
-            // Get the name of the component and the number of entities that have it
-            std::string component_name = bee::ComponentManager::CleanTypeName(meta_type.info().name().data());
-            size_t component_count = storage.size();
-
-            // Display component name and count
-            ImGui::Text("%s: %zu entities", component_name.c_str(), component_count);
+            ImGui::EndTable();
         }
-
         ImGui::Separator();
 
         // You could add additional stats here, like average components per entity, memory usage, etc.
@@ -0,0 +1,181 @@
+#include "managers/interpolation_manager.hpp"
+#include "core.hpp"
+
+namespace bee::internal
+{
+static std::vector<Interpolated*> blendTargets;
+static std::vector<glm::vec3> blendPositions;
+static std::vector<glm::quat> blendRotations;
+static std::vector<glm::vec3> blendScales;
+static std::vector<glm::mat4> blendModels;
+
+// Normalized lerp along the shortest arc, one fixed step of rotation is small enough that it matches slerp
+static glm::quat Nlerp(const glm::quat& from, const glm::quat& to, float t)
+{
+    const float sign = glm::dot(from, to) < 0.0f ? -1.0f : 1.0f;
+    return glm::normalize(glm::quat(from.w + (to.w * sign - from.w) * t,
+                                    from.x + (to.x * sign - from.x) * t,
+                                    from.y + (to.y * sign - from.y) * t,
+                                    from.z + (to.z * sign - from.z) * t));
+}
+}  // namespace bee::internal
+using namespace bee::internal;
+
+void bee::InterpolationManager::Snapshot(entt::registry& registry)
+{
+    PROFILE_FUNCTION();
+
+    // one pass over the packed Interpolated storage, the transforms are looked up through their sparse set
+    for (auto [entity, interpolated, transform] : registry.view<Interpolated, Transform>().each())
+    {
+        if (interpolated.initialized)
+        {
+            interpolated.previousPosition = interpolated.currentPosition;
+            interpolated.previousRotation = interpolated.currentRotation;
+            interpolated.previousScale = interpolated.currentScale;
+        }
+        else
+        {
+            interpolated.previousPosition = transform.GetPosition();
+            interpolated.previousRotation = transform.GetRotationQuat();
+            interpolated.previousScale = transform.GetScale();
+            interpolated.initialized = true;
+        }
+        interpolated.currentPosition = transform.GetPosition();
+        interpolated.currentRotation = transform.GetRotationQuat();
+        interpolated.currentScale = transform.GetScale();
+    }
+}
+
+void bee::InterpolationManager::Blend(entt::registry& registry, float alpha)
+{
+    PROFILE_FUNCTION();
+
+    blendTargets.clear();
+    blendPositions.clear();
+    blendRotations.clear();
+    blendScales.clear();
+
+    for (auto [entity, interpolated, transform] : registry.view<Interpolated, Transform>().each())
+    {
+        const glm::vec3 position = transform.GetPosition();
+        const glm::quat rotation = transform.GetRotationQuat();
+        const glm::vec3 scale = transform.GetScale();
+
+        // anything that differs from the last snapshot was set outside the fixed step, it is drawn without blending
+        if (!interpolated.initialized || position != interpolated.currentPosition)
+            interpolated.previousPosition = interpolated.currentPosition = position;
+        if (!interpolated.initialized || rotation != interpolated.currentRotation)
+            interpolated.previousRotation = interpolated.currentRotation = rotation;
+        if (!interpolated.initialized || scale != interpolated.currentScale)
+            interpolated.previousScale = interpolated.currentScale = scale;
+        interpolated.initialized = true;
+
+        blendTargets.push_back(&interpolated);
+        blendPositions.push_back(glm::mix(interpolated.previousPosition, interpolated.currentPosition, alpha));
+        blendRotations.push_back(Nlerp(interpolated.previousRotation, interpolated.currentRotation, alpha));
+        blendScales.push_back(glm::mix(interpolated.previousScale, interpolated.currentScale, alpha));
+    }
+
+    bee::profiler::SetCounter("Interpolated entities", static_cast<float>(blendTargets.size()));
+    if (blendTargets.empty()) return;
+
+    blendModels.resize(blendTargets.size());
+    ComposeTRS(blendPositions.data(), blendRotations.data(), blendScales.data(), blendModels.data(), blendTargets.size());
+    for (size_t i = 0; i < blendTargets.size(); i++) blendTargets[i]->model = blendModels[i];
+}
+
+glm::mat4 bee::InterpolationManager::GetLocalModel(entt::entity entity, entt::registry& registry)
+{
+    if (const auto* interpolated = registry.try_get<Interpolated>(entity)) return interpolated->model;
+    return bee::GetLocalModel(entity, registry);
+}
+
+glm::mat4 bee::InterpolationManager::GetWorldModel(entt::entity entity, entt::registry& registry)
+{
+    if (registry.storage<Interpolated>().empty()) return bee::GetWorldModel(entity, registry);
+
+    const auto* hierarchy = registry.try_get<HierarchyNode>(entity);
+    const bool hasParent = hierarchy && hierarchy->parent != entt::null && hierarchy->parent != entity;
+
+    // canvas elements are placed by their camera, GetWorldModel knows how
+    if (!registry.all_of<Interpolated>(entity) && (!hasParent || registry.all_of<CanvasElement>(entity)))
+        return bee::GetWorldModel(entity, registry);
+
+    const glm::mat4& local = GetLocalModel(entity, registry);
+    return hasParent ? GetWorldModel(hierarchy->parent, registry) * local : local;
+}
+
+std::vector<bee::benchmark::Result> bee::BenchmarkInterpolation()
+{
+    // a local registry, the running scene is not touched
+    constexpr size_t count = 10000;
+    constexpr float dt = 1.0f / 60.0f;
+
+    entt::registry registry;
+    std::vector<glm::vec3> velocities(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        const auto entity = registry.create();
+        registry.emplace<Transform>(entity,
+                                    glm::linearRand(glm::vec3(-100.0f), glm::vec3(100.0f)),
+                                    glm::quat(glm::radians(glm::linearRand(glm::vec3(-180.0f), glm::vec3(180.0f)))),
+                                    glm::vec3(1.0f));
+        registry.emplace<Interpolated>(entity);
+        velocities[i] = glm::linearRand(glm::vec3(-5.0f), glm::vec3(5.0f));
+    }
+
+    // moves every transform like a fixed step of particles would
+    auto step = [&](float stepDt)
+    {
+        size_t i = 0;
+        for (auto& transform : registry.storage<Transform>())
+            transform.SetPosition(transform.GetPosition() + velocities[i++] * stepDt);
+    };
+
+    std::vector<benchmark::Result> results;
+
+    // what the engine did before: step the particles forward by the accumulator before drawing and back after it
+    results.push_back(benchmark::Measure("Step forward and back around drawing",
+                                         count,
+                                         [&]()
+                                         {
+                                             step(dt * 0.5f);
+                                             UpdateModelMatrices(registry);
+                                             step(-dt * 0.5f);
+                                         }));
+
+    results.push_back(
+        benchmark::Measure("Snapshot interpolated transforms", count, [&]() { InterpolationManager::Snapshot(registry); }));
+    results.push_back(
+        benchmark::Measure("Blend interpolated transforms", count, [&]() { InterpolationManager::Blend(registry, 0.5f); }));
+
+    // halfway between two steps has to be where the transform was half a step ago
+    InterpolationManager::Snapshot(registry);
+    step(dt);
+    InterpolationManager::Snapshot(registry);
+    InterpolationManager::Blend(registry, 0.5f);
+    step(-dt * 0.5f);
+    size_t wrong = 0;
+    for (auto [entity, interpolated, transform] : registry.view<Interpolated, Transform>().each())
+    {
+        const glm::mat4 expected = transform.GetModelMatrix();
+        for (int column = 0; column < 4; column++)
+        {
+            if (glm::any(glm::greaterThan(glm::abs(interpolated.model[column] - expected[column]), glm::vec4(1e-3f))))
+            {
+                wrong++;
+                break;
+            }
+        }
+    }
+    if (wrong > 0) bee::benchmark::Fail("{} interpolated transforms are not halfway between their steps", wrong);
+
+    return results;
+}
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
@@ -29,7 +29,7 @@ void bee::RenderManager::SubmitRenderables(entt::registry& registry)
         if (!renderable.visible) continue;
         if (renderable.billboard) continue;
 
-        glm::mat4 model = GetWorldModel(entity, registry);
+        glm::mat4 model = InterpolationManager::GetWorldModel(entity, registry);
 
         bool succes = xsr::render_mesh(glm::value_ptr(model),
                                        renderable.mesh->GetHandle(),
@@ -71,7 +71,7 @@ void bee::RenderManager::SubmitUIRenderables(entt::registry& registry)
 
 void bee::RenderManager::SubmitBillboards(const entt::entity cameraEntity, entt::registry& registry)
 {
-    const glm::mat4 cameraModel = GetWorldModel(cameraEntity, registry);
+    const glm::mat4 cameraModel = InterpolationManager::GetWorldModel(cameraEntity, registry);
     const glm::vec3 cameraPosition = cameraModel[3];
 
     const auto view = registry.view<Renderable, Transform>();
@@ -151,7 +151,7 @@ void bee::RenderManager::Render(const entt::entity cameraEntity, entt::registry&
     PROFILE_FUNCTION();
     const bee::Camera& camera = registry.get<bee::Camera>(cameraEntity);
 
-    const glm::mat4 cameraModel = GetWorldModel(cameraEntity, registry);
+    const glm::mat4 cameraModel = InterpolationManager::GetWorldModel(cameraEntity, registry);
     const glm::vec3 cameraPosition = cameraModel[3];
     const glm::quat cameraRotation = glm::quat_cast(cameraModel);
 
@@ -187,7 +187,7 @@ void bee::RenderManager::RenderUI(const entt::entity cameraEntity, entt::registr
     PROFILE_FUNCTION();
     const bee::Camera& camera = registry.get<bee::Camera>(cameraEntity);
 
-    const glm::mat4 cameraModel = GetWorldModel(cameraEntity, registry);
+    const glm::mat4 cameraModel = InterpolationManager::GetWorldModel(cameraEntity, registry);
     const glm::vec3 cameraPosition = cameraModel[3];
     const glm::quat cameraRotation = glm::quat_cast(cameraModel);
 
@@ -211,7 +211,7 @@ void bee::RenderManager::RenderUI(const entt::entity cameraEntity, entt::registr
 
 const glm::mat4& bee::RenderManager::GetWorldModelCache(const entt::entity entity, entt::registry& registry)
 {
-    auto& transform = registry.get<Transform>(entity);
+    const glm::mat4& local = InterpolationManager::GetLocalModel(entity, registry);
 
     // try to get parent transform
     if (registry.all_of<HierarchyNode>(entity))
@@ -220,12 +220,12 @@ const glm::mat4& bee::RenderManager::GetWorldModelCache(const entt::entity entit
         if (hierarchy.parent != entt::null && entity != hierarchy.parent)
         {
             glm::mat4 parentTransform = GetWorldModelCache(hierarchy.parent, registry);
-            m_worldModelCache[entity] = parentTransform * transform.GetModelMatrix();
+            m_worldModelCache[entity] = parentTransform * local;
             return m_worldModelCache[entity];
         }
     }
 
-    m_worldModelCache[entity] = transform.GetModelMatrix();
+    m_worldModelCache[entity] = local;
     return m_worldModelCache[entity];
 }
 
@@ -679,6 +679,31 @@ void main()
     return shader;
 }
 
+std::vector<bee::benchmark::Result> bee::RenderManager::Benchmark()
+{
+    std::vector<benchmark::Result> results;
+    for (const int count : {1000, 10000, 100000})
+    {
+        ecs::StressSceneSettings settings;
+        settings.entityCount = count;
+        settings.emitterFraction = 0.0f;
+        settings.pointLightFraction = 0.0f;
+
+        entt::registry registry;
+        const ecs::StressSceneStats stats = ecs::GenerateStressScene(registry, settings);
+        results.push_back(benchmark::MeasureSize("xsr::render_mesh submission",
+                                                 stats.entities,
+                                                 stats.renderables,
+                                                 [&]()
+                                                 {
+                                                     SubmitRenderables(registry);
+                                                     ClearEntries();
+                                                 },
+                                                 3));
+    }
+    return results;
+}
+
 
 
 /*
@@ -3,7 +3,6 @@
 
 std::stack<Ref<bee::Command>> bee::UndoRedoManager::m_undoStack;
 std::stack<Ref<bee::Command>> bee::UndoRedoManager::m_redoStack;
-std::unordered_map<entt::entity, entt::entity> bee::UndoRedoManager::EntityMap;
 
 void traverse_stack(std::stack<Ref<bee::Command>>& st, const std::function<void(const Ref<bee::Command>&, size_t index)>& f)
 {
@@ -59,6 +58,14 @@ void bee::UndoRedoManager::Redo()
     }
 }
 
+entt::entity bee::UndoRedoManager::ResolveEntity(entt::entity entity, UUID uuid)
+{
+    auto& registry = bee::Engine.Registry();
+    // without a UUID the entity id is all there is
+    if (!uuid.IsValid()) return registry.valid(entity) ? entity : entt::null;
+    return bee::ecs::FindEntityByUUID(registry, uuid);
+}
+
 void bee::UndoRedoManager::OnImGuiRender()
 {
     ImGui::Begin(ICON_FA_ARROWS_ROTATE TAB_FA "Undo/Redo Manager");
@@ -155,6 +162,7 @@ bee::ModelMatrixCommand::ModelMatrixCommand(entt::entity target, const glm::mat4
 {
     auto& registry = bee::Engine.Registry();
     if (!registry.valid(target)) return;
+    m_targetUUID = bee::ecs::GetUUID(registry, target);
     m_previousModelMatrix = GetWorldModel(target, registry);
 }
 
@@ -163,6 +171,7 @@ bee::ModelMatrixCommand::ModelMatrixCommand(entt::entity target,
                                             const glm::mat4& newModelMatrix)
 {
     this->m_target = target;
+    this->m_targetUUID = bee::ecs::GetUUID(bee::Engine.Registry(), target);
     this->m_previousModelMatrix = previousModelMatrix;
     this->m_newModelMatrix = newModelMatrix;
 
@@ -174,78 +183,46 @@ bee::ModelMatrixCommand::ModelMatrixCommand(entt::entity target,
 void bee::ModelMatrixCommand::Execute()
 {
     auto& registry = bee::Engine.Registry();
-    if (!registry.valid(m_target))
-    {
-        // check the undo redo mapping to see if the entity was deleted
-        if (bee::UndoRedoManager::EntityMap.find(m_target) != bee::UndoRedoManager::EntityMap.end())
-        {
-            m_target = bee::UndoRedoManager::EntityMap[m_target];
-        }
-        else
-        {
-            return;
-        }
-    }
+    m_target = UndoRedoManager::ResolveEntity(m_target, m_targetUUID);
+    if (m_target == entt::null) return;
     SetWorldModel(m_target, m_newModelMatrix, registry);
 }
 
 void bee::ModelMatrixCommand::Undo()
 {
     auto& registry = bee::Engine.Registry();
-    if (!registry.valid(m_target))
-    {
-        // check the undo redo mapping to see if the entity was deleted
-        if (bee::UndoRedoManager::EntityMap.find(m_target) != bee::UndoRedoManager::EntityMap.end())
-        {
-            m_target = bee::UndoRedoManager::EntityMap[m_target];
-        }
-        else
-        {
-            return;
-        }
-    }
+    m_target = UndoRedoManager::ResolveEntity(m_target, m_targetUUID);
+    if (m_target == entt::null) return;
     SetWorldModel(m_target, m_previousModelMatrix, registry);
 }
 
 void bee::ModelMatrixCommand::OnImGuiRender() { ImGui::Text("Model Matrix Command"); }
 
 // ======= CreateEntityCommand =======
-bee::CreateEntityCommand::CreateEntityCommand(entt::entity entity) : m_entity(entity) {}
+bee::CreateEntityCommand::CreateEntityCommand(entt::entity entity)
+    : m_entity(entity), m_entityUUID(bee::ecs::GetUUID(bee::Engine.Registry(), entity))
+{
+}
 
 void bee::CreateEntityCommand::Execute()
 {
     auto& registry = bee::Engine.Registry();
     // this check is here to prevent the command from being executed if the entity already exists
-    if (registry.valid(m_entity)) return;
+    if (UndoRedoManager::ResolveEntity(m_entity, m_entityUUID) != entt::null) return;
     std::unordered_map<entt::entity, entt::entity> entity_mapping;
+    bee::LoadedLinks links;
 
-    deserializeEntityString<cereal::JSONInputArchive>(m_entityData, registry, entity_mapping);
-    bee::ecs::UpdateEntityMapping(entity_mapping, registry);
+    deserializeEntityString<cereal::JSONInputArchive>(m_entityData, registry, entity_mapping, links);
+    bee::ResolveHierarchyLinks(registry, entity_mapping, links);
 
     m_entity = entity_mapping[m_entity];
-
-    // add the entity mapping to the undo redo manager mapping
-    for (auto& [oldEntity, newEntity] : entity_mapping)
-    {
-        bee::UndoRedoManager::EntityMap[oldEntity] = newEntity;
-    }
 }
 
 void bee::CreateEntityCommand::Undo()
 {
     auto& registry = bee::Engine.Registry();
-    if (!registry.valid(m_entity))
-    {
-        // check the undo redo mapping to see if the entity was deleted
-        if (bee::UndoRedoManager::EntityMap.find(m_entity) != bee::UndoRedoManager::EntityMap.end())
-        {
-            m_entity = bee::UndoRedoManager::EntityMap[m_entity];
-        }
-        else
-        {
-            return;
-        }
-    }
+    m_entity = UndoRedoManager::ResolveEntity(m_entity, m_entityUUID);
+    if (m_entity == entt::null) return;
     m_entityData = serializeEntityString<cereal::JSONOutputArchive>(registry, m_entity);
     bee::ecs::DestroyEntity(m_entity, registry);
 }
@@ -253,23 +230,16 @@ void bee::CreateEntityCommand::Undo()
 void bee::CreateEntityCommand::OnImGuiRender() { ImGui::Text("Create Entity Command"); }
 
 // ======= DeleteEntityCommand =======
-bee::DeleteEntityCommand::DeleteEntityCommand(entt::entity entity) : m_entity(entity) {}
+bee::DeleteEntityCommand::DeleteEntityCommand(entt::entity entity)
+    : m_entity(entity), m_entityUUID(bee::ecs::GetUUID(bee::Engine.Registry(), entity))
+{
+}
 
 void bee::DeleteEntityCommand::Execute()
 {
     auto& registry = bee::Engine.Registry();
-    if (!registry.valid(m_entity))
-    {
-        // check the undo redo mapping to see if the entity was deleted
-        if (bee::UndoRedoManager::EntityMap.find(m_entity) != bee::UndoRedoManager::EntityMap.end())
-        {
-            m_entity = bee::UndoRedoManager::EntityMap[m_entity];
-        }
-        else
-        {
-            return;
-        }
-    }
+    m_entity = UndoRedoManager::ResolveEntity(m_entity, m_entityUUID);
+    if (m_entity == entt::null) return;
     m_entityData = serializeEntityString<cereal::JSONOutputArchive>(registry, m_entity);
     bee::ecs::DestroyEntity(m_entity, bee::Engine.Registry());
 }
@@ -277,19 +247,14 @@ void bee::DeleteEntityCommand::Execute()
 void bee::DeleteEntityCommand::Undo()
 {
     auto& registry = bee::Engine.Registry();
-    if (registry.valid(m_entity)) return;
+    if (UndoRedoManager::ResolveEntity(m_entity, m_entityUUID) != entt::null) return;
     std::unordered_map<entt::entity, entt::entity> entity_mapping;
+    bee::LoadedLinks links;
 
-    deserializeEntityString<cereal::JSONInputArchive>(m_entityData, registry, entity_mapping);
-    bee::ecs::UpdateEntityMapping(entity_mapping, registry);
+    deserializeEntityString<cereal::JSONInputArchive>(m_entityData, registry, entity_mapping, links);
+    bee::ResolveHierarchyLinks(registry, entity_mapping, links);
 
     m_entity = entity_mapping[m_entity];
-
-    // add the entity mapping to the undo redo manager mapping
-    for (auto& [oldEntity, newEntity] : entity_mapping)
-    {
-        bee::UndoRedoManager::EntityMap[oldEntity] = newEntity;
-    }
 }
 
 void bee::DeleteEntityCommand::OnImGuiRender() { ImGui::Text("Delete Entity Command"); }
@@ -0,0 +1,299 @@
+#include "math/aabbTree.hpp"
+
+bool bee::AABB::IntersectsSegment(const glm::vec3& start, const glm::vec3& end) const
+{
+    glm::vec3 dir = end - start;
+    float tmin = 0.0f;
+    float tmax = 1.0f;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        if (std::abs(dir[i]) < 1e-8f)
+        {
+            if (start[i] < min[i] || start[i] > max[i]) return false;
+            continue;
+        }
+
+        float invD = 1.0f / dir[i];
+        float t1 = (min[i] - start[i]) * invD;
+        float t2 = (max[i] - start[i]) * invD;
+        if (t1 > t2) std::swap(t1, t2);
+
+        tmin = std::max(tmin, t1);
+        tmax = std::min(tmax, t2);
+        if (tmin > tmax) return false;
+    }
+    return true;
+}
+
+int bee::AABBTree::AllocateNode()
+{
+    if (m_freeList == Null)
+    {
+        m_nodes.emplace_back();
+        return static_cast<int>(m_nodes.size() - 1);
+    }
+
+    int node = m_freeList;
+    m_freeList = m_nodes[node].parent;
+    m_nodes[node] = Node();
+    return node;
+}
+
+void bee::AABBTree::FreeNode(int node)
+{
+    m_nodes[node].parent = m_freeList;
+    m_nodes[node].height = -1;
+    m_freeList = node;
+}
+
+int bee::AABBTree::CreateProxy(const AABB& aabb, entt::entity entity)
+{
+    int proxy = AllocateNode();
+    glm::vec3 margin(m_margin);
+    m_nodes[proxy].aabb = AABB(aabb.min - margin, aabb.max + margin);
+    m_nodes[proxy].entity = entity;
+    m_nodes[proxy].height = 0;
+
+    InsertLeaf(proxy);
+    m_proxyCount++;
+    return proxy;
+}
+
+void bee::AABBTree::DestroyProxy(int proxy)
+{
+    assert(proxy >= 0 && proxy < static_cast<int>(m_nodes.size()) && m_nodes[proxy].IsLeaf());
+    RemoveLeaf(proxy);
+    FreeNode(proxy);
+    m_proxyCount--;
+}
+
+bool bee::AABBTree::MoveProxy(int proxy, const AABB& aabb, const glm::vec3& displacement)
+{
+    Node& node = m_nodes[proxy];
+    if (node.aabb.Contains(aabb))
+    {
+        // still inside, unless the fat bounds got way too big for the object (it stopped moving fast)
+        glm::vec3 margin(m_margin * 4.0f);
+        AABB huge(aabb.min - margin - glm::abs(displacement) * 4.0f, aabb.max + margin + glm::abs(displacement) * 4.0f);
+        if (huge.Contains(node.aabb)) return false;
+    }
+
+    RemoveLeaf(proxy);
+
+    glm::vec3 margin(m_margin);
+    AABB fat(aabb.min - margin, aabb.max + margin);
+    // predict the movement so the proxy stays inside its bounds for the next steps
+    glm::vec3 predicted = displacement * 2.0f;
+    fat.min += glm::min(predicted, glm::vec3(0.0f));
+    fat.max += glm::max(predicted, glm::vec3(0.0f));
+    m_nodes[proxy].aabb = fat;
+
+    InsertLeaf(proxy);
+    m_reinserts++;
+    return true;
+}
+
+void bee::AABBTree::Clear()
+{
+    m_nodes.clear();
+    m_root = Null;
+    m_freeList = Null;
+    m_proxyCount = 0;
+    m_reinserts = 0;
+}
+
+void bee::AABBTree::InsertLeaf(int leaf)
+{
+    if (m_root == Null)
+    {
+        m_root = leaf;
+        m_nodes[leaf].parent = Null;
+        return;
+    }
+
+    // walk down to the sibling that increases the total surface area the least
+    const AABB leafAABB = m_nodes[leaf].aabb;
+    int index = m_root;
+    while (!m_nodes[index].IsLeaf())
+    {
+        const Node& node = m_nodes[index];
+        float area = node.aabb.Area();
+        float combinedArea = AABB::Merge(node.aabb, leafAABB).Area();
+
+        // cost of making a new parent for this node and the leaf
+        float cost = 2.0f * combinedArea;
+        // minimum cost of pushing the leaf further down the tree
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto ChildCost = [&](int child)
+        {
+            const Node& childNode = m_nodes[child];
+            float merged = AABB::Merge(leafAABB, childNode.aabb).Area();
+            if (childNode.IsLeaf()) return merged + inheritanceCost;
+            return (merged - childNode.aabb.Area()) + inheritanceCost;
+        };
+
+        float cost1 = ChildCost(node.child1);
+        float cost2 = ChildCost(node.child2);
+
+        if (cost < cost1 && cost < cost2) break;
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    int sibling = index;
+    int oldParent = m_nodes[sibling].parent;
+    int newParent = AllocateNode();
+    m_nodes[newParent].parent = oldParent;
+    m_nodes[newParent].aabb = AABB::Merge(leafAABB, m_nodes[sibling].aabb);
+    m_nodes[newParent].height = m_nodes[sibling].height + 1;
+    m_nodes[newParent].child1 = sibling;
+    m_nodes[newParent].child2 = leaf;
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent = newParent;
+
+    if (oldParent == Null)
+    {
+        m_root = newParent;
+    }
+    else if (m_nodes[oldParent].child1 == sibling)
+    {
+        m_nodes[oldParent].child1 = newParent;
+    }
+    else
+    {
+        m_nodes[oldParent].child2 = newParent;
+    }
+
+    Refit(m_nodes[leaf].parent);
+}
+
+void bee::AABBTree::RemoveLeaf(int leaf)
+{
+    if (leaf == m_root)
+    {
+        m_root = Null;
+        return;
+    }
+
+    int parent = m_nodes[leaf].parent;
+    int grandParent = m_nodes[parent].parent;
+    int sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+    if (grandParent == Null)
+    {
+        m_root = sibling;
+        m_nodes[sibling].parent = Null;
+        FreeNode(parent);
+        return;
+    }
+
+    // the sibling takes the place of the parent
+    if (m_nodes[grandParent].child1 == parent)
+        m_nodes[grandParent].child1 = sibling;
+    else
+        m_nodes[grandParent].child2 = sibling;
+    m_nodes[sibling].parent = grandParent;
+    FreeNode(parent);
+
+    Refit(grandParent);
+}
+
+void bee::AABBTree::Refit(int index)
+{
+    while (index != Null)
+    {
+        index = Balance(index);
+
+        Node& node = m_nodes[index];
+        const Node& child1 = m_nodes[node.child1];
+        const Node& child2 = m_nodes[node.child2];
+        node.height = 1 + std::max(child1.height, child2.height);
+        node.aabb = AABB::Merge(child1.aabb, child2.aabb);
+
+        index = node.parent;
+    }
+}
+
+// Performs a left or right rotation if node A is imbalanced, returns the new root of the subtree
+int bee::AABBTree::Balance(int iA)
+{
+    Node* A = &m_nodes[iA];
+    if (A->IsLeaf() || A->height < 2) return iA;
+
+    int iB = A->child1;
+    int iC = A->child2;
+    Node* B = &m_nodes[iB];
+    Node* C = &m_nodes[iC];
+
+    int balance = C->height - B->height;
+
+    // rotate C up, or B up, the code is the same with the roles swapped
+    auto Rotate = [&](int iUp, Node* up, Node* other, bool upIsChild2)
+    {
+        int iF = up->child1;
+        int iG = up->child2;
+        Node* F = &m_nodes[iF];
+        Node* G = &m_nodes[iG];
+
+        // swap A and up
+        up->child1 = iA;
+        up->parent = A->parent;
+        A->parent = iUp;
+
+        if (up->parent != Null)
+        {
+            if (m_nodes[up->parent].child1 == iA)
+                m_nodes[up->parent].child1 = iUp;
+            else
+                m_nodes[up->parent].child2 = iUp;
+        }
+        else
+        {
+            m_root = iUp;
+        }
+
+        // the taller grandchild stays with up, the other one moves to A
+        int iKeep = iF;
+        int iMove = iG;
+        Node* keep = F;
+        Node* move = G;
+        if (F->height <= G->height)
+        {
+            iKeep = iG;
+            iMove = iF;
+            keep = G;
+            move = F;
+        }
+
+        up->child2 = iKeep;
+        if (upIsChild2)
+            A->child2 = iMove;
+        else
+            A->child1 = iMove;
+        move->parent = iA;
+
+        A->aabb = AABB::Merge(other->aabb, move->aabb);
+        up->aabb = AABB::Merge(A->aabb, keep->aabb);
+        A->height = 1 + std::max(other->height, move->height);
+        up->height = 1 + std::max(A->height, keep->height);
+    };
+
+    if (balance > 1)
+    {
+        Rotate(iC, C, B, true);
+        return iC;
+    }
+    if (balance < -1)
+    {
+        Rotate(iB, B, C, false);
+        return iB;
+    }
+    return iA;
+}
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
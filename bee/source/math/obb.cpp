@@ -0,0 +1,527 @@
+#include "math/obb.hpp"
+#include "core.hpp"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define BEE_OBB_SSE 1
+#else
+#define BEE_OBB_SSE 0
+#endif
+
+namespace bee::internal
+{
+constexpr float obbEpsilon = 1e-6f;
+
+// Face normal of the box at a point on its surface, shared by the scalar and batch segment tests
+glm::vec3 SurfaceNormal(const glm::vec3& point, const OBB& obb)
+{
+    glm::vec3 localPoint = point - obb.center;
+    int closest = 0;
+    float closestDistance = FLT_MAX;
+    for (int i = 0; i < 3; ++i)
+    {
+        float projection = glm::dot(localPoint, obb.axes[i]);
+        float extent = obb.halfSizes[i];
+        if (std::abs(projection) >= extent - 1e-3f) return obb.axes[i] * (projection > 0 ? 1.0f : -1.0f);
+
+        // the start of the segment was inside the box, fall back to the closest face
+        float distance = extent - std::abs(projection);
+        if (distance < closestDistance)
+        {
+            closestDistance = distance;
+            closest = i;
+        }
+    }
+    return obb.axes[closest] * (glm::dot(localPoint, obb.axes[closest]) > 0 ? 1.0f : -1.0f);
+}
+
+#if BEE_OBB_SSE
+inline __m128 Abs(__m128 v) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), v); }
+
+// mask ? a : b
+inline __m128 Select(__m128 mask, __m128 a, __m128 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+
+inline __m128 Dot(const glm::vec3& a, const __m128 b[3])
+{
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(a.x), b[0]), _mm_mul_ps(_mm_set1_ps(a.y), b[1])),
+                      _mm_mul_ps(_mm_set1_ps(a.z), b[2]));
+}
+#endif
+}  // namespace bee::internal
+
+using namespace bee::internal;
+
+void bee::OBB4::Set(int lane, const OBB& obb)
+{
+    for (int c = 0; c < 3; ++c)
+    {
+        center[c][lane] = obb.center[c];
+        halfSizes[c][lane] = obb.halfSizes[c];
+        for (int axis = 0; axis < 3; ++axis) axes[axis][c][lane] = obb.axes[axis][c];
+    }
+}
+
+bee::OBB bee::OBB4::Get(int lane) const
+{
+    OBB obb;
+    for (int c = 0; c < 3; ++c)
+    {
+        obb.center[c] = center[c][lane];
+        obb.halfSizes[c] = halfSizes[c][lane];
+        for (int axis = 0; axis < 3; ++axis) obb.axes[axis][c] = axes[axis][c][lane];
+    }
+    return obb;
+}
+
+void bee::PackOBBs(const OBB* obbs, size_t count, std::vector<OBB4>& out)
+{
+    out.resize((count + 3) / 4);
+    for (size_t i = 0; i < count; i++)
+    {
+        OBB4& block = out[i / 4];
+        if (i % 4 == 0) block.count = 0;
+        block.Set(block.count++, obbs[i]);
+    }
+}
+
+// Written by ChatGPT, moved here from the PaintGame physics
+bool bee::OBBOverlap(const OBB& A, const OBB& B, float& penetrationDepth, glm::vec3& collisionNormal)
+{
+    float ra, rb;
+    glm::mat3 R, AbsR;
+
+    float minPenetration = FLT_MAX;
+    glm::vec3 axis;
+    bool invertNormal = false;
+
+    // Compute rotation matrix expressing B in A's coordinate frame
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            R[i][j] = glm::dot(A.axes[i], B.axes[j]);
+        }
+    }
+
+    // Compute translation vector T
+    glm::vec3 t = B.center - A.center;
+    // Bring translation into A's coordinate frame
+    t = glm::vec3(glm::dot(t, A.axes[0]), glm::dot(t, A.axes[1]), glm::dot(t, A.axes[2]));
+
+    // Compute common subexpressions and add in an epsilon term
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            AbsR[i][j] = std::abs(R[i][j]) + obbEpsilon;
+        }
+    }
+
+    float penetration;
+
+    // Test axes L = A0, A1, A2
+    for (int i = 0; i < 3; ++i)
+    {
+        ra = A.halfSizes[i];
+        rb = B.halfSizes[0] * AbsR[i][0] + B.halfSizes[1] * AbsR[i][1] + B.halfSizes[2] * AbsR[i][2];
+        penetration = (ra + rb) - std::abs(t[i]);
+        if (penetration < 0)
+            return false;  // No collision
+        else if (penetration < minPenetration)
+        {
+            minPenetration = penetration;
+            axis = A.axes[i];
+            invertNormal = t[i] < 0;
+        }
+    }
+
+    // Now test the 9 cross products of the axes
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            glm::vec3 currentAxis = glm::cross(A.axes[i], B.axes[j]);
+            if (glm::length2(currentAxis) < obbEpsilon) continue;  // Skip near-zero axes
+
+            currentAxis = glm::normalize(currentAxis);
+
+            // the axes are normalized, so no need to scale the half sizes by their length
+            ra = A.halfSizes[(i + 1) % 3] * AbsR[(i + 2) % 3][j] + A.halfSizes[(i + 2) % 3] * AbsR[(i + 1) % 3][j];
+            rb = B.halfSizes[(j + 1) % 3] * AbsR[i][(j + 2) % 3] + B.halfSizes[(j + 2) % 3] * AbsR[i][(j + 1) % 3];
+            float tValue = t[(i + 2) % 3] * R[(i + 1) % 3][j] - t[(i + 1) % 3] * R[(i + 2) % 3][j];
+            penetration = (ra + rb) - std::abs(tValue);
+            if (penetration < 0)
+                return false;  // No collision
+            else if (penetration < minPenetration)
+            {
+                minPenetration = penetration;
+                axis = currentAxis;
+                invertNormal = tValue < 0;
+            }
+        }
+    }
+
+    // If no separating axis is found, the OBBs must be intersecting
+    penetrationDepth = minPenetration;
+    collisionNormal = invertNormal ? -axis : axis;
+    return true;
+}
+
+int bee::OBBOverlap4(const OBB& a, const OBB4& b, float penetration[4], glm::vec3 normal[4])
+{
+    const int laneMask = (1 << b.count) - 1;
+
+#if BEE_OBB_SSE
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 epsilon = _mm_set1_ps(obbEpsilon);
+
+    __m128 bAxes[3][3];
+    __m128 bHalfSizes[3];
+    __m128 d[3];
+    for (int c = 0; c < 3; ++c)
+    {
+        for (int axis = 0; axis < 3; ++axis) bAxes[axis][c] = _mm_load_ps(b.axes[axis][c]);
+        bHalfSizes[c] = _mm_load_ps(b.halfSizes[c]);
+        d[c] = _mm_sub_ps(_mm_load_ps(b.center[c]), _mm_set1_ps(a.center[c]));
+    }
+
+    // rotation of every B in A's frame, and the translation in A's frame
+    __m128 R[3][3], AbsR[3][3], t[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            R[i][j] = Dot(a.axes[i], bAxes[j]);
+            AbsR[i][j] = _mm_add_ps(Abs(R[i][j]), epsilon);
+        }
+        t[i] = Dot(a.axes[i], d);
+    }
+
+    __m128 minPenetration = _mm_set1_ps(FLT_MAX);
+    __m128 axis[3] = {zero, zero, zero};
+    __m128 invert = zero;
+    __m128 separated = zero;
+
+    auto Track = [&](__m128 valid, __m128 pen, const __m128 candidate[3], __m128 tValue)
+    {
+        separated = _mm_or_ps(separated, _mm_and_ps(valid, _mm_cmplt_ps(pen, zero)));
+        __m128 better = _mm_and_ps(valid, _mm_cmplt_ps(pen, minPenetration));
+        minPenetration = Select(better, pen, minPenetration);
+        for (int c = 0; c < 3; ++c) axis[c] = Select(better, candidate[c], axis[c]);
+        invert = Select(better, _mm_cmplt_ps(tValue, zero), invert);
+    };
+
+    const __m128 allLanes = _mm_cmpeq_ps(zero, zero);
+
+    // face axes of A
+    for (int i = 0; i < 3; ++i)
+    {
+        __m128 ra = _mm_set1_ps(a.halfSizes[i]);
+        __m128 rb = _mm_add_ps(_mm_add_ps(_mm_mul_ps(bHalfSizes[0], AbsR[i][0]), _mm_mul_ps(bHalfSizes[1], AbsR[i][1])),
+                               _mm_mul_ps(bHalfSizes[2], AbsR[i][2]));
+        __m128 pen = _mm_sub_ps(_mm_add_ps(ra, rb), Abs(t[i]));
+        const __m128 candidate[3] = {_mm_set1_ps(a.axes[i].x), _mm_set1_ps(a.axes[i].y), _mm_set1_ps(a.axes[i].z)};
+        Track(allLanes, pen, candidate, t[i]);
+    }
+    if ((_mm_movemask_ps(separated) & laneMask) == laneMask) return 0;
+
+    // the 9 cross products
+    for (int i = 0; i < 3; ++i)
+    {
+        const int i1 = (i + 1) % 3;
+        const int i2 = (i + 2) % 3;
+        const __m128 ax = _mm_set1_ps(a.axes[i].x);
+        const __m128 ay = _mm_set1_ps(a.axes[i].y);
+        const __m128 az = _mm_set1_ps(a.axes[i].z);
+
+        for (int j = 0; j < 3; ++j)
+        {
+            const int j1 = (j + 1) % 3;
+            const int j2 = (j + 2) % 3;
+
+            __m128 cross[3] = {_mm_sub_ps(_mm_mul_ps(ay, bAxes[j][2]), _mm_mul_ps(az, bAxes[j][1])),
+                               _mm_sub_ps(_mm_mul_ps(az, bAxes[j][0]), _mm_mul_ps(ax, bAxes[j][2])),
+                               _mm_sub_ps(_mm_mul_ps(ax, bAxes[j][1]), _mm_mul_ps(ay, bAxes[j][0]))};
+            __m128 length2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cross[0], cross[0]), _mm_mul_ps(cross[1], cross[1])),
+                                        _mm_mul_ps(cross[2], cross[2]));
+            __m128 valid = _mm_cmpge_ps(length2, epsilon);
+
+            __m128 invLength = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(_mm_max_ps(length2, epsilon)));
+            for (int c = 0; c < 3; ++c) cross[c] = _mm_mul_ps(cross[c], invLength);
+
+            __m128 ra = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a.halfSizes[i1]), AbsR[i2][j]),
+                                   _mm_mul_ps(_mm_set1_ps(a.halfSizes[i2]), AbsR[i1][j]));
+            __m128 rb = _mm_add_ps(_mm_mul_ps(bHalfSizes[j1], AbsR[i][j2]), _mm_mul_ps(bHalfSizes[j2], AbsR[i][j1]));
+            __m128 tValue = _mm_sub_ps(_mm_mul_ps(t[i2], R[i1][j]), _mm_mul_ps(t[i1], R[i2][j]));
+            __m128 pen = _mm_sub_ps(_mm_add_ps(ra, rb), Abs(tValue));
+            Track(valid, pen, cross, tValue);
+        }
+        if ((_mm_movemask_ps(separated) & laneMask) == laneMask) return 0;
+    }
+
+    const int mask = ~_mm_movemask_ps(separated) & laneMask;
+    if (mask == 0) return 0;
+
+    alignas(16) float penetrations[4], x[4], y[4], z[4];
+    const __m128 sign = _mm_and_ps(invert, _mm_set1_ps(-0.0f));
+    _mm_store_ps(penetrations, minPenetration);
+    _mm_store_ps(x, _mm_xor_ps(axis[0], sign));
+    _mm_store_ps(y, _mm_xor_ps(axis[1], sign));
+    _mm_store_ps(z, _mm_xor_ps(axis[2], sign));
+    for (int lane = 0; lane < 4; ++lane)
+    {
+        if (!(mask & (1 << lane))) continue;
+        penetration[lane] = penetrations[lane];
+        normal[lane] = glm::vec3(x[lane], y[lane], z[lane]);
+    }
+    return mask;
+#else
+    int mask = 0;
+    for (int lane = 0; lane < b.count; ++lane)
+    {
+        if (OBBOverlap(a, b.Get(lane), penetration[lane], normal[lane])) mask |= 1 << lane;
+    }
+    return mask & laneMask;
+#endif
+}
+
+// Written by ChatGPT, moved here from the PaintGame physics
+bool bee::SegmentOBBIntersection(const glm::vec3& start, const glm::vec3& end, const OBB& obb, float& t, glm::vec3& normal)
+{
+    // Transform the line segment into the OBB's local space
+    glm::vec3 dir = end - start;
+    glm::vec3 localStart = start - obb.center;
+
+    // Initialize variables for tracking the interval of intersection
+    float tmin = 0.0f;
+    float tmax = 1.0f;
+
+    // For each OBB axis
+    for (int i = 0; i < 3; ++i)
+    {
+        glm::vec3 axis = obb.axes[i];
+        float e = glm::dot(axis, localStart);
+        float f = glm::dot(axis, dir);
+        float h = obb.halfSizes[i];
+
+        if (std::abs(f) > obbEpsilon)
+        {
+            float t1 = (-h - e) / f;
+            float t2 = (h - e) / f;
+
+            if (t1 > t2) std::swap(t1, t2);
+
+            if (t1 > tmin) tmin = t1;
+            if (t2 < tmax) tmax = t2;
+
+            if (tmin > tmax) return false;
+            if (tmax < 0.0f) return false;
+        }
+        else
+        {
+            if (-e - h > 0.0f || -e + h < 0.0f) return false;
+        }
+    }
+
+    t = glm::clamp(tmin, 0.0f, 1.0f);
+    normal = SurfaceNormal(start + dir * t, obb);
+    return true;
+}
+
+int bee::SegmentOBBIntersection4(const glm::vec3& start, const glm::vec3& end, const OBB4& b, float t[4], glm::vec3 normal[4])
+{
+    const int laneMask = (1 << b.count) - 1;
+    const glm::vec3 dir = end - start;
+
+#if BEE_OBB_SSE
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 epsilon = _mm_set1_ps(obbEpsilon);
+
+    __m128 localStart[3];
+    for (int c = 0; c < 3; ++c) localStart[c] = _mm_sub_ps(_mm_set1_ps(start[c]), _mm_load_ps(b.center[c]));
+
+    __m128 tmin = zero;
+    __m128 tmax = _mm_set1_ps(1.0f);
+    __m128 miss = zero;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        const __m128 axis[3] = {_mm_load_ps(b.axes[i][0]), _mm_load_ps(b.axes[i][1]), _mm_load_ps(b.axes[i][2])};
+        __m128 e = _mm_add_ps(_mm_add_ps(_mm_mul_ps(axis[0], localStart[0]), _mm_mul_ps(axis[1], localStart[1])),
+                              _mm_mul_ps(axis[2], localStart[2]));
+        __m128 f = Dot(dir, axis);
+        __m128 h = _mm_load_ps(b.halfSizes[i]);
+
+        // parallel to the slab, only a miss if the start is outside of it
+        __m128 parallel = _mm_cmple_ps(Abs(f), epsilon);
+        __m128 outside = _mm_or_ps(_mm_cmpgt_ps(_mm_sub_ps(_mm_sub_ps(zero, e), h), zero),
+                                   _mm_cmplt_ps(_mm_add_ps(_mm_sub_ps(zero, e), h), zero));
+        miss = _mm_or_ps(miss, _mm_and_ps(parallel, outside));
+
+        __m128 invF = _mm_div_ps(_mm_set1_ps(1.0f), Select(parallel, _mm_set1_ps(1.0f), f));
+        __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(zero, h), e), invF);
+        __m128 t2 = _mm_mul_ps(_mm_sub_ps(h, e), invF);
+        tmin = Select(parallel, tmin, _mm_max_ps(tmin, _mm_min_ps(t1, t2)));
+        tmax = Select(parallel, tmax, _mm_min_ps(tmax, _mm_max_ps(t1, t2)));
+    }
+    miss = _mm_or_ps(miss, _mm_or_ps(_mm_cmpgt_ps(tmin, tmax), _mm_cmplt_ps(tmax, zero)));
+
+    const int mask = ~_mm_movemask_ps(miss) & laneMask;
+    if (mask == 0) return 0;
+
+    alignas(16) float hits[4];
+    _mm_store_ps(hits, tmin);
+    for (int lane = 0; lane < 4; ++lane)
+    {
+        if (!(mask & (1 << lane))) continue;
+        t[lane] = glm::clamp(hits[lane], 0.0f, 1.0f);
+        normal[lane] = SurfaceNormal(start + dir * t[lane], b.Get(lane));
+    }
+    return mask;
+#else
+    int mask = 0;
+    for (int lane = 0; lane < b.count; ++lane)
+    {
+        if (SegmentOBBIntersection(start, end, b.Get(lane), t[lane], normal[lane])) mask |= 1 << lane;
+    }
+    return mask & laneMask;
+#endif
+}
+
+std::vector<bee::benchmark::Result> bee::BenchmarkOBB()
+{
+    constexpr size_t count = 4096;
+
+    auto RandomOBB = []()
+    {
+        OBB obb;
+        glm::quat rotation = glm::quat(glm::radians(glm::linearRand(glm::vec3(-180.0f), glm::vec3(180.0f))));
+        // some boxes stay axis aligned, those hit the near-zero cross product path
+        if (glm::linearRand(0.0f, 1.0f) < 0.25f) rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        obb.center = glm::linearRand(glm::vec3(-10.0f), glm::vec3(10.0f));
+        obb.axes[0] = rotation * glm::vec3(1.0f, 0.0f, 0.0f);
+        obb.axes[1] = rotation * glm::vec3(0.0f, 1.0f, 0.0f);
+        obb.axes[2] = rotation * glm::vec3(0.0f, 0.0f, 1.0f);
+        obb.halfSizes = glm::linearRand(glm::vec3(0.1f), glm::vec3(3.0f));
+        return obb;
+    };
+
+    std::vector<OBB> obbs(count);
+    for (auto& obb : obbs) obb = RandomOBB();
+    std::vector<OBB4> blocks;
+    PackOBBs(obbs.data(), obbs.size(), blocks);
+
+    const OBB probe = RandomOBB();
+    const glm::vec3 start = glm::linearRand(glm::vec3(-10.0f), glm::vec3(10.0f));
+    const glm::vec3 end = glm::linearRand(glm::vec3(-10.0f), glm::vec3(10.0f));
+
+    // every box against every box, the batch results have to match the scalar ones
+    size_t mismatches = 0;
+    size_t overlaps = 0;
+    float maxError = 0.0f;
+    for (size_t i = 0; i < count; i += 16)
+    {
+        for (const auto& block : blocks)
+        {
+            float penetration[4];
+            glm::vec3 normal[4];
+            const int mask = OBBOverlap4(obbs[i], block, penetration, normal);
+            for (int lane = 0; lane < block.count; ++lane)
+            {
+                float scalarPenetration;
+                glm::vec3 scalarNormal;
+                const bool scalarHit = OBBOverlap(obbs[i], block.Get(lane), scalarPenetration, scalarNormal);
+                const bool batchHit = (mask & (1 << lane)) != 0;
+                if (scalarHit != batchHit)
+                {
+                    // boxes that just touch can go either way
+                    if (scalarHit && scalarPenetration > 1e-4f) mismatches++;
+                    if (batchHit && penetration[lane] > 1e-4f) mismatches++;
+                    continue;
+                }
+                if (!scalarHit) continue;
+
+                overlaps++;
+                maxError = std::max(maxError, std::abs(scalarPenetration - penetration[lane]));
+            }
+        }
+    }
+
+    for (int s = 0; s < 256; ++s)
+    {
+        glm::vec3 segmentStart = glm::linearRand(glm::vec3(-10.0f), glm::vec3(10.0f));
+        glm::vec3 segmentEnd = glm::linearRand(glm::vec3(-10.0f), glm::vec3(10.0f));
+        for (const auto& block : blocks)
+        {
+            float t[4];
+            glm::vec3 normal[4];
+            const int mask = SegmentOBBIntersection4(segmentStart, segmentEnd, block, t, normal);
+            for (int lane = 0; lane < block.count; ++lane)
+            {
+                float scalarT;
+                glm::vec3 scalarNormal;
+                const bool scalarHit = SegmentOBBIntersection(segmentStart, segmentEnd, block.Get(lane), scalarT, scalarNormal);
+                if (scalarHit != ((mask & (1 << lane)) != 0))
+                {
+                    mismatches++;
+                    continue;
+                }
+                if (scalarHit) maxError = std::max(maxError, std::abs(scalarT - t[lane]));
+            }
+        }
+    }
+
+    if (mismatches > 0 || maxError > 1e-3f)
+        bee::benchmark::Fail("OBB batch tests differ from the scalar tests: {} mismatches, max error {}", mismatches, maxError);
+    else
+        bee::Log::Info("OBB batch tests match the scalar tests ({} overlaps checked)", overlaps);
+
+    std::vector<benchmark::Result> results;
+    results.push_back(benchmark::Measure("OBBOverlap",
+                                         count,
+                                         [&]()
+                                         {
+                                             float penetration;
+                                             glm::vec3 normal;
+                                             int hits = 0;
+                                             for (const auto& obb : obbs) hits += OBBOverlap(probe, obb, penetration, normal);
+                                             benchmark::DoNotOptimize(&hits);
+                                         }));
+    results.push_back(benchmark::Measure("OBBOverlap4",
+                                         count,
+                                         [&]()
+                                         {
+                                             float penetration[4];
+                                             glm::vec3 normal[4];
+                                             int hits = 0;
+                                             for (const auto& block : blocks) hits += OBBOverlap4(probe, block, penetration, normal);
+                                             benchmark::DoNotOptimize(&hits);
+                                         }));
+    results.push_back(benchmark::Measure("SegmentOBBIntersection",
+                                         count,
+                                         [&]()
+                                         {
+                                             float t;
+                                             glm::vec3 normal;
+                                             int hits = 0;
+                                             for (const auto& obb : obbs) hits += SegmentOBBIntersection(start, end, obb, t, normal);
+                                             benchmark::DoNotOptimize(&hits);
+                                         }));
+    results.push_back(benchmark::Measure("SegmentOBBIntersection4",
+                                         count,
+                                         [&]()
+                                         {
+                                             float t[4];
+                                             glm::vec3 normal[4];
+                                             int hits = 0;
+                                             for (const auto& block : blocks) hits += SegmentOBBIntersection4(start, end, block, t, normal);
+                                             benchmark::DoNotOptimize(&hits);
+                                         }));
+    return results;
+}
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
@@ -0,0 +1,224 @@
+#include "math/random.hpp"
+#include "core.hpp"
+#include <atomic>
+
+namespace bee::internal
+{
+static std::atomic<uint64_t> randomSeed{0x9E3779B97F4A7C15ull};
+static std::atomic<uint32_t> randomEpoch{0};  // bumped by SeedRandom, threads reseed when theirs is behind
+
+// streams of one seed are far apart because splitmix64 scrambles the combined seed
+static uint64_t StreamSeed(uint64_t seed, uint32_t stream) { return seed + 0xD1B54A32D192ED03ull * stream; }
+
+static uint64_t SplitMix64(uint64_t& state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Orthonormal basis around a unit vector without branching on the axis it is closest to (Duff et al. 2017)
+static void OrthonormalBasis(const glm::vec3& n, glm::vec3& tangent, glm::vec3& bitangent)
+{
+    const float sign = std::copysign(1.0f, n.z);
+    const float a = -1.0f / (sign + n.z);
+    const float b = n.x * n.y * a;
+    tangent = glm::vec3(1.0f + sign * n.x * n.x * a, sign * b, -sign * n.x);
+    bitangent = glm::vec3(b, sign + n.y * n.y * a, -n.y);
+}
+
+// Point on the unit sphere for height z and angle u * 2 pi around the z axis
+static glm::vec3 SpherePoint(float z, float u)
+{
+    const float radius = std::sqrt(std::max(0.0f, 1.0f - z * z));
+    const float angle = u * glm::two_pi<float>();
+    return glm::vec3(radius * std::cos(angle), radius * std::sin(angle), z);
+}
+}  // namespace bee::internal
+using namespace bee::internal;
+
+void bee::Random::Seed(uint64_t seed)
+{
+    uint64_t state = seed;
+    for (auto& word : m_state) word = SplitMix64(state);
+}
+
+int bee::Random::Int(int min, int max)
+{
+    if (max < min) std::swap(min, max);
+    const uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(max) - min) + 1;
+    return static_cast<int>(min + static_cast<int64_t>(((Next() >> 32) * range) >> 32));
+}
+
+glm::vec3 bee::Random::UnitVector()
+{
+    const float z = Float(-1.0f, 1.0f);
+    return SpherePoint(z, Float());
+}
+
+glm::vec3 bee::Random::DirectionInCone(const glm::vec3& direction, float angle)
+{
+    glm::vec3 result;
+    DirectionsInCone(&result, 1, direction, angle);
+    return result;
+}
+
+void bee::Random::Floats(float* out, size_t count, float min, float max)
+{
+    const float scale = (max - min) * (1.0f / 16777216.0f);
+    for (size_t i = 0; i < count; i++) out[i] = min + static_cast<float>(Next() >> 40) * scale;
+}
+
+void bee::Random::UnitVectors(glm::vec3* out, size_t count)
+{
+    // both numbers come from one draw, 24 bits each
+    for (size_t i = 0; i < count; i++)
+    {
+        const uint64_t bits = Next();
+        const float z = static_cast<float>(bits >> 40) * (2.0f / 16777216.0f) - 1.0f;
+        const float u = static_cast<float>((bits >> 16) & 0xFFFFFF) * (1.0f / 16777216.0f);
+        out[i] = SpherePoint(z, u);
+    }
+}
+
+void bee::Random::DirectionsInCone(glm::vec3* out, size_t count, const glm::vec3& direction, float angle)
+{
+    const float length = glm::length(direction);
+    const glm::vec3 axis = length > 0.0f ? direction / length : glm::vec3(0.0f, 0.0f, 1.0f);
+    glm::vec3 tangent;
+    glm::vec3 bitangent;
+    OrthonormalBasis(axis, tangent, bitangent);
+
+    // heights on the cap are uniform between the cosine of the angle and 1, which makes the directions uniform
+    const float minZ = std::cos(glm::radians(std::clamp(angle, 0.0f, 180.0f)));
+    const float zScale = (1.0f - minZ) * (1.0f / 16777216.0f);
+    for (size_t i = 0; i < count; i++)
+    {
+        const uint64_t bits = Next();
+        const float z = 1.0f - static_cast<float>(bits >> 40) * zScale;
+        const float u = static_cast<float>((bits >> 16) & 0xFFFFFF) * (1.0f / 16777216.0f);
+        const glm::vec3 local = SpherePoint(z, u);
+        out[i] = tangent * local.x + bitangent * local.y + axis * local.z;
+    }
+}
+
+bee::Random& bee::ThreadRandom()
+{
+    thread_local Random random;
+    thread_local uint32_t epoch = std::numeric_limits<uint32_t>::max();
+    const uint32_t current = randomEpoch.load(std::memory_order_acquire);
+    if (epoch != current)
+    {
+        const uint32_t stream = static_cast<uint32_t>(JobSystem::WorkerIndex());
+        random.Seed(StreamSeed(randomSeed.load(std::memory_order_relaxed), stream));
+        epoch = current;
+    }
+    return random;
+}
+
+void bee::SeedRandom(uint64_t seed)
+{
+    randomSeed.store(seed, std::memory_order_relaxed);
+    randomEpoch.fetch_add(1, std::memory_order_release);
+    ThreadRandom();
+}
+
+uint64_t bee::GetRandomSeed() { return randomSeed.load(std::memory_order_relaxed); }
+
+std::vector<bee::benchmark::Result> bee::BenchmarkRandom()
+{
+    constexpr size_t count = 100000;
+    std::vector<float> floats(count);
+    std::vector<glm::vec3> directions(count);
+    Random random(1234);
+    const glm::vec3 direction = glm::normalize(glm::vec3(0.3f, 1.0f, -0.2f));
+
+    std::vector<benchmark::Result> results;
+    results.push_back(benchmark::Measure("glm::linearRand floats",
+                                         count,
+                                         [&]()
+                                         {
+                                             for (auto& value : floats) value = glm::linearRand(0.0f, 1.0f);
+                                             benchmark::DoNotOptimize(floats.data());
+                                         }));
+    results.push_back(benchmark::Measure("Random::Floats",
+                                         count,
+                                         [&]()
+                                         {
+                                             random.Floats(floats.data(), count);
+                                             benchmark::DoNotOptimize(floats.data());
+                                         }));
+
+    // what RandomDirectionInCone did before, two glm::linearRand calls and a quaternion per direction
+    results.push_back(benchmark::Measure("glm::linearRand cone directions",
+                                         count,
+                                         [&]()
+                                         {
+                                             const glm::quat rotation = glm::rotation(glm::vec3(0.0f, 0.0f, 1.0f), direction);
+                                             for (auto& out : directions)
+                                             {
+                                                 const float theta = glm::linearRand(0.0f, glm::two_pi<float>());
+                                                 const float phi = glm::linearRand(0.0f, glm::radians(30.0f));
+                                                 const glm::vec3 local(std::sin(phi) * std::cos(theta),
+                                                                       std::sin(phi) * std::sin(theta),
+                                                                       std::cos(phi));
+                                                 out = glm::normalize(rotation * local);
+                                             }
+                                             benchmark::DoNotOptimize(directions.data());
+                                         }));
+    results.push_back(benchmark::Measure("Random::DirectionsInCone",
+                                         count,
+                                         [&]()
+                                         {
+                                             random.DirectionsInCone(directions.data(), count, direction, 30.0f);
+                                             benchmark::DoNotOptimize(directions.data());
+                                         }));
+    results.push_back(benchmark::Measure("Random::UnitVectors",
+                                         count,
+                                         [&]()
+                                         {
+                                             random.UnitVectors(directions.data(), count);
+                                             benchmark::DoNotOptimize(directions.data());
+                                         }));
+
+    // every direction has to stay in the cone and be unit length
+    const float minDot = std::cos(glm::radians(30.0f)) - 1e-4f;
+    random.DirectionsInCone(directions.data(), count, direction, 30.0f);
+    size_t outside = 0;
+    for (const auto& out : directions)
+    {
+        if (glm::dot(out, direction) < minDot || std::abs(glm::length(out) - 1.0f) > 1e-4f) outside++;
+    }
+    if (outside > 0) bee::benchmark::Fail("{} random directions are outside the cone", outside);
+
+    // Every thread has to draw the stream of its worker, in the order it ran the chunks. Reseeding with the same seed
+    // restarts the streams, so this also restarts the numbers of the running game.
+    const uint64_t seed = GetRandomSeed();
+    SeedRandom(seed);
+    constexpr size_t chunkCount = 256;
+    std::vector<std::pair<int, uint64_t>> draws(chunkCount);
+    Engine.Jobs().ParallelFor(chunkCount,
+                              1,
+                              [&](size_t, size_t, size_t chunk)
+                              { draws[chunk] = {JobSystem::WorkerIndex(), ThreadRandom().Next()}; });
+
+    std::vector<Random> streams;
+    size_t mismatches = 0;
+    for (const auto& [worker, value] : draws)
+    {
+        while (streams.size() <= static_cast<size_t>(worker))
+            streams.emplace_back(StreamSeed(seed, static_cast<uint32_t>(streams.size())));
+        if (streams[static_cast<size_t>(worker)].Next() != value) mismatches++;
+    }
+    if (mismatches > 0)
+        bee::benchmark::Fail("{} of {} random draws on the workers are not from their worker stream", mismatches, chunkCount);
+
+    return results;
+}
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
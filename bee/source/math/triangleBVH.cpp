@@ -0,0 +1,496 @@
+#include "math/triangleBVH.hpp"
+#include "core.hpp"
+
+namespace bee::internal
+{
+constexpr int binCount = 12;
+
+// Moller-Trumbore, u and v are the barycentric weights of the second and third corner
+bool IntersectTriangle(const glm::vec3& v0,
+                       const glm::vec3& edge1,
+                       const glm::vec3& edge2,
+                       const glm::vec3& origin,
+                       const glm::vec3& direction,
+                       float& t,
+                       float& u,
+                       float& v)
+{
+    const glm::vec3 p = glm::cross(direction, edge2);
+    const float determinant = glm::dot(edge1, p);
+    if (std::abs(determinant) < 1e-12f) return false;  // parallel to the triangle
+
+    const float inverseDeterminant = 1.0f / determinant;
+    const glm::vec3 s = origin - v0;
+    u = glm::dot(s, p) * inverseDeterminant;
+    if (u < 0.0f || u > 1.0f) return false;
+
+    const glm::vec3 q = glm::cross(s, edge1);
+    v = glm::dot(direction, q) * inverseDeterminant;
+    if (v < 0.0f || u + v > 1.0f) return false;
+
+    t = glm::dot(edge2, q) * inverseDeterminant;
+    return t >= 0.0f;
+}
+
+// Distance along the ray where it enters the box, infinity when it misses
+float SlabDistance(const glm::vec3& min,
+                   const glm::vec3& max,
+                   const glm::vec3& origin,
+                   const glm::vec3& inverseDirection,
+                   float maxT)
+{
+    const glm::vec3 t1 = (min - origin) * inverseDirection;
+    const glm::vec3 t2 = (max - origin) * inverseDirection;
+    const glm::vec3 tNear = glm::min(t1, t2);
+    const glm::vec3 tFar = glm::max(t1, t2);
+    const float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+    const float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxT));
+    return enter <= exit ? enter : std::numeric_limits<float>::infinity();
+}
+}  // namespace bee::internal
+
+using namespace bee::internal;
+
+void bee::TriangleBVH::Clear()
+{
+    m_nodes.clear();
+    m_triangles.clear();
+    m_normals.clear();
+    m_uvs.clear();
+    m_sourceTriangles.clear();
+}
+
+void bee::TriangleBVH::GetTriangle(uint32_t triangle, glm::vec3& a, glm::vec3& b, glm::vec3& c) const
+{
+    const Triangle& corners = m_triangles[triangle];
+    a = corners.v0;
+    b = corners.v0 + corners.edge1;
+    c = corners.v0 + corners.edge2;
+}
+
+void bee::TriangleBVH::Build(const std::vector<glm::vec3>& positions,
+                             const std::vector<glm::vec3>& normals,
+                             const std::vector<glm::vec2>& uvs,
+                             const std::vector<uint32_t>& indices)
+{
+    PROFILE_FUNCTION();
+    Clear();
+
+    // bounds and centroids of the valid triangles
+    std::vector<uint32_t> order;
+    std::vector<AABB> bounds;
+    std::vector<glm::vec3> centroids;
+    order.reserve(indices.size() / 3);
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        if (indices[i] >= positions.size() || indices[i + 1] >= positions.size() || indices[i + 2] >= positions.size())
+            continue;
+
+        const glm::vec3& a = positions[indices[i]];
+        const glm::vec3& b = positions[indices[i + 1]];
+        const glm::vec3& c = positions[indices[i + 2]];
+        order.push_back(static_cast<uint32_t>(i / 3));
+        bounds.emplace_back(glm::min(a, glm::min(b, c)), glm::max(a, glm::max(b, c)));
+        centroids.push_back((a + b + c) / 3.0f);
+    }
+    if (order.empty()) return;
+
+    // the tree is built over positions in order, partitioning only moves these around
+    std::vector<uint32_t> items(order.size());
+    for (uint32_t i = 0; i < static_cast<uint32_t>(order.size()); i++) items[i] = i;
+
+    struct Task
+    {
+        uint32_t node;
+        uint32_t begin;
+        uint32_t end;
+        int depth;
+    };
+    std::vector<Task> tasks;
+    tasks.push_back({0, 0, static_cast<uint32_t>(items.size()), 0});
+    m_nodes.reserve(items.size() * 2);
+    m_nodes.push_back(Node());
+
+    struct Bin
+    {
+        AABB bounds = AABB(glm::vec3(std::numeric_limits<float>::max()), glm::vec3(-std::numeric_limits<float>::max()));
+        uint32_t count = 0;
+    };
+
+    while (!tasks.empty())
+    {
+        const Task task = tasks.back();
+        tasks.pop_back();
+
+        glm::vec3 nodeMin(std::numeric_limits<float>::max());
+        glm::vec3 nodeMax(-std::numeric_limits<float>::max());
+        glm::vec3 centroidMin = nodeMin;
+        glm::vec3 centroidMax = nodeMax;
+        for (uint32_t i = task.begin; i < task.end; i++)
+        {
+            nodeMin = glm::min(nodeMin, bounds[items[i]].min);
+            nodeMax = glm::max(nodeMax, bounds[items[i]].max);
+            centroidMin = glm::min(centroidMin, centroids[items[i]]);
+            centroidMax = glm::max(centroidMax, centroids[items[i]]);
+        }
+        m_nodes[task.node].min = nodeMin;
+        m_nodes[task.node].max = nodeMax;
+
+        const uint32_t count = task.end - task.begin;
+        auto MakeLeaf = [&]()
+        {
+            m_nodes[task.node].leftFirst = task.begin;
+            m_nodes[task.node].count = count;
+        };
+        if (count <= maxLeafSize || task.depth >= maxDepth - 1)
+        {
+            MakeLeaf();
+            continue;
+        }
+
+        // binned surface area heuristic, the cost of a leaf is one test per triangle
+        float bestCost = static_cast<float>(count);
+        int bestAxis = -1;
+        int bestSplit = 0;
+        const glm::vec3 extent = centroidMax - centroidMin;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            if (extent[axis] <= 0.0f) continue;
+
+            Bin bins[binCount];
+            const float scale = static_cast<float>(binCount) / extent[axis];
+            for (uint32_t i = task.begin; i < task.end; i++)
+            {
+                const float offset = centroids[items[i]][axis] - centroidMin[axis];
+                const int bin = std::min(binCount - 1, static_cast<int>(offset * scale));
+                bins[bin].count++;
+                bins[bin].bounds = AABB::Merge(bins[bin].bounds, bounds[items[i]]);
+            }
+
+            // sweep from the right first so the left sweep can evaluate every split
+            float rightArea[binCount - 1];
+            uint32_t rightCount[binCount - 1];
+            Bin right;
+            for (int split = binCount - 1; split > 0; split--)
+            {
+                right.count += bins[split].count;
+                right.bounds = AABB::Merge(right.bounds, bins[split].bounds);
+                rightArea[split - 1] = right.count > 0 ? right.bounds.Area() : 0.0f;
+                rightCount[split - 1] = right.count;
+            }
+
+            Bin left;
+            const float nodeArea = AABB(nodeMin, nodeMax).Area();
+            for (int split = 0; split < binCount - 1; split++)
+            {
+                left.count += bins[split].count;
+                left.bounds = AABB::Merge(left.bounds, bins[split].bounds);
+                if (left.count == 0 || rightCount[split] == 0) continue;
+
+                const float cost = 1.0f + (left.bounds.Area() * static_cast<float>(left.count) +
+                                           rightArea[split] * static_cast<float>(rightCount[split])) /
+                                              std::max(nodeArea, 1e-12f);
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = split;
+                }
+            }
+        }
+
+        if (bestAxis < 0)
+        {
+            MakeLeaf();
+            continue;
+        }
+
+        const float scale = static_cast<float>(binCount) / extent[bestAxis];
+        auto* middle = std::partition(items.data() + task.begin,
+                                      items.data() + task.end,
+                                      [&](uint32_t item)
+                                      {
+                                          const float offset = centroids[item][bestAxis] - centroidMin[bestAxis];
+                                          return std::min(binCount - 1, static_cast<int>(offset * scale)) <= bestSplit;
+                                      });
+        const uint32_t split = static_cast<uint32_t>(middle - items.data());
+        if (split == task.begin || split == task.end)
+        {
+            MakeLeaf();
+            continue;
+        }
+
+        const uint32_t leftChild = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.push_back(Node());
+        m_nodes.push_back(Node());
+        m_nodes[task.node].leftFirst = leftChild;
+        m_nodes[task.node].count = 0;
+        tasks.push_back({leftChild + 1, split, task.end, task.depth + 1});
+        tasks.push_back({leftChild, task.begin, split, task.depth + 1});
+    }
+
+    // store the triangles in leaf order
+    m_triangles.resize(items.size());
+    m_normals.resize(items.size() * 3);
+    m_uvs.resize(items.size() * 3, glm::vec2(0.0f));
+    m_sourceTriangles.resize(items.size());
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        const uint32_t source = order[items[i]];
+        const glm::vec3& a = positions[indices[source * 3]];
+        const glm::vec3& b = positions[indices[source * 3 + 1]];
+        const glm::vec3& c = positions[indices[source * 3 + 2]];
+        m_triangles[i] = {a, b - a, c - a};
+        m_sourceTriangles[i] = source;
+
+        const glm::vec3 cross = glm::cross(b - a, c - a);
+        const float length = glm::length(cross);
+        const glm::vec3 faceNormal = length > 0.0f ? cross / length : glm::vec3(0.0f, 1.0f, 0.0f);
+        for (size_t corner = 0; corner < 3; corner++)
+        {
+            const uint32_t index = indices[source * 3 + corner];
+            m_normals[i * 3 + corner] = index < normals.size() ? normals[index] : faceNormal;
+            if (index < uvs.size()) m_uvs[i * 3 + corner] = uvs[index];
+        }
+    }
+    m_nodes.shrink_to_fit();
+}
+
+bool bee::TriangleBVH::Intersect(const glm::vec3& origin, const glm::vec3& direction, float maxT, TriangleHit& hit) const
+{
+    if (m_nodes.empty()) return false;
+
+    const glm::vec3 inverseDirection = 1.0f / direction;
+    float closest = maxT;
+    uint32_t closestTriangle = std::numeric_limits<uint32_t>::max();
+    float closestU = 0.0f;
+    float closestV = 0.0f;
+
+    struct StackEntry
+    {
+        uint32_t node;
+        float distance;
+    };
+    StackEntry stack[maxDepth];
+    int stackSize = 0;
+
+    const Node& root = m_nodes[0];
+    float rootDistance = SlabDistance(root.min, root.max, origin, inverseDirection, closest);
+    if (rootDistance == std::numeric_limits<float>::infinity()) return false;
+    stack[stackSize++] = {0, rootDistance};
+
+    while (stackSize > 0)
+    {
+        const StackEntry entry = stack[--stackSize];
+        if (entry.distance > closest) continue;  // a closer hit was found after this node was pushed
+
+        const Node& node = m_nodes[entry.node];
+        if (node.count > 0)
+        {
+            for (uint32_t i = node.leftFirst; i < node.leftFirst + node.count; i++)
+            {
+                const Triangle& triangle = m_triangles[i];
+                float t;
+                float u;
+                float v;
+                if (IntersectTriangle(triangle.v0, triangle.edge1, triangle.edge2, origin, direction, t, u, v) && t <= closest)
+                {
+                    closest = t;
+                    closestTriangle = i;
+                    closestU = u;
+                    closestV = v;
+                }
+            }
+            continue;
+        }
+
+        // visit the nearest child first, the far one is skipped if the near one has a closer hit
+        StackEntry nearChild = {node.leftFirst, 0.0f};
+        StackEntry farChild = {node.leftFirst + 1, 0.0f};
+        nearChild.distance =
+            SlabDistance(m_nodes[nearChild.node].min, m_nodes[nearChild.node].max, origin, inverseDirection, closest);
+        farChild.distance =
+            SlabDistance(m_nodes[farChild.node].min, m_nodes[farChild.node].max, origin, inverseDirection, closest);
+        if (farChild.distance < nearChild.distance) std::swap(nearChild, farChild);
+        if (farChild.distance != std::numeric_limits<float>::infinity()) stack[stackSize++] = farChild;
+        if (nearChild.distance != std::numeric_limits<float>::infinity()) stack[stackSize++] = nearChild;
+    }
+
+    if (closestTriangle == std::numeric_limits<uint32_t>::max()) return false;
+
+    const Triangle& triangle = m_triangles[closestTriangle];
+    hit.t = closest;
+    hit.position = origin + direction * closest;
+    hit.normal = glm::normalize(glm::cross(triangle.edge1, triangle.edge2));
+    if (glm::dot(hit.normal, direction) > 0.0f) hit.normal = -hit.normal;
+    const glm::vec2* uv = &m_uvs[closestTriangle * 3];
+    hit.uv = uv[0] * (1.0f - closestU - closestV) + uv[1] * closestU + uv[2] * closestV;
+    hit.triangle = m_sourceTriangles[closestTriangle];
+    return true;
+}
+
+std::vector<bee::benchmark::Result> bee::BenchmarkTriangleBVH()
+{
+    struct Geometry
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> normals;
+        std::vector<glm::vec2> uvs;
+        std::vector<uint32_t> indices;
+    };
+    std::vector<Geometry> meshes;
+
+    // every primitive of every glTF file in the assets folder
+    const fs::path assets = bee::Engine.FileIO().GetPath(bee::FileIO::Directory::Assets, "");
+    std::error_code error;
+    for (const auto& file : fs::recursive_directory_iterator(assets, error))
+    {
+        const auto extension = file.path().extension();
+        if (extension != ".gltf" && extension != ".glb") continue;
+
+        resource::GltfModel gltf;
+        if (!gltf.Load(file.path())) continue;
+        const tinygltf::Model& model = gltf.GetModel();
+        for (const auto& mesh : model.meshes)
+        {
+            for (const auto& primitive : mesh.primitives)
+            {
+                Geometry geometry;
+                if (resource::GetPrimitiveGeometry(model,
+                                                   primitive,
+                                                   geometry.positions,
+                                                   geometry.normals,
+                                                   geometry.uvs,
+                                                   geometry.indices))
+                    meshes.push_back(std::move(geometry));
+            }
+        }
+    }
+    if (meshes.empty())
+    {
+        bee::Log::Warn("No glTF meshes found in {} for the triangle BVH benchmark", assets.string());
+        return {};
+    }
+
+    size_t triangleCount = 0;
+    for (const auto& mesh : meshes) triangleCount += mesh.indices.size() / 3;
+
+    std::vector<TriangleBVH> bvhs(meshes.size());
+    for (size_t i = 0; i < meshes.size(); i++)
+        bvhs[i].Build(meshes[i].positions, meshes[i].normals, meshes[i].uvs, meshes[i].indices);
+
+    // rays from around every mesh towards a random point inside it
+    struct Probe
+    {
+        size_t mesh;
+        glm::vec3 origin;
+        glm::vec3 direction;
+    };
+    constexpr size_t raysPerMesh = 256;
+    std::vector<Probe> probes;
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+        const AABB bounds = bvhs[i].Bounds();
+        const float radius = glm::length(bounds.max - bounds.min) + 1e-3f;
+        for (size_t r = 0; r < raysPerMesh; r++)
+        {
+            const glm::vec3 origin = bounds.Center() + glm::sphericalRand(radius);
+            const glm::vec3 target = glm::linearRand(bounds.min, bounds.max);
+            probes.push_back({i, origin, glm::normalize(target - origin)});
+        }
+    }
+
+    auto BruteForce = [&](const Probe& probe, float& closest)
+    {
+        const Geometry& mesh = meshes[probe.mesh];
+        bool hit = false;
+        closest = std::numeric_limits<float>::max();
+        for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+        {
+            const glm::vec3& a = mesh.positions[mesh.indices[i]];
+            float t;
+            float u;
+            float v;
+            if (IntersectTriangle(a, mesh.positions[mesh.indices[i + 1]] - a, mesh.positions[mesh.indices[i + 2]] - a,
+                                  probe.origin, probe.direction, t, u, v) &&
+                t < closest)
+            {
+                closest = t;
+                hit = true;
+            }
+        }
+        return hit;
+    };
+
+    // the BVH has to find the same closest hits as testing every triangle
+    size_t mismatches = 0;
+    size_t hits = 0;
+    for (const auto& probe : probes)
+    {
+        float bruteT;
+        TriangleHit hit;
+        const bool bruteHit = BruteForce(probe, bruteT);
+        const bool bvhHit = bvhs[probe.mesh].Intersect(probe.origin, probe.direction, std::numeric_limits<float>::max(), hit);
+        if (bruteHit != bvhHit || (bruteHit && std::abs(bruteT - hit.t) > 1e-4f * std::max(1.0f, bruteT)))
+            mismatches++;
+        hits += bvhHit;
+    }
+
+    size_t nodeCount = 0;
+    for (const auto& bvh : bvhs) nodeCount += bvh.NodeCount();
+    if (mismatches > 0)
+        bee::benchmark::Fail("Triangle BVH raycasts differ from testing every triangle: {} of {} rays",
+                             mismatches,
+                             probes.size());
+    else
+        bee::Log::Info("Triangle BVH: {} meshes, {} triangles, {} nodes, {} of {} rays hit",
+                       meshes.size(),
+                       triangleCount,
+                       nodeCount,
+                       hits,
+                       probes.size());
+
+    std::vector<benchmark::Result> results;
+    results.push_back(benchmark::Measure("TriangleBVH build (per triangle)",
+                                         triangleCount,
+                                         [&]()
+                                         {
+                                             TriangleBVH bvh;
+                                             for (const auto& mesh : meshes)
+                                             {
+                                                 bvh.Build(mesh.positions, mesh.normals, mesh.uvs, mesh.indices);
+                                                 benchmark::DoNotOptimize(&bvh);
+                                             }
+                                         },
+                                         3));
+    results.push_back(benchmark::Measure("TriangleBVH raycast",
+                                         probes.size(),
+                                         [&]()
+                                         {
+                                             TriangleHit hit;
+                                             size_t count = 0;
+                                             for (const auto& probe : probes)
+                                                 count += bvhs[probe.mesh].Intersect(probe.origin,
+                                                                                     probe.direction,
+                                                                                     std::numeric_limits<float>::max(),
+                                                                                     hit);
+                                             benchmark::DoNotOptimize(&count);
+                                         }));
+    results.push_back(benchmark::Measure("Raycast every triangle",
+                                         probes.size(),
+                                         [&]()
+                                         {
+                                             float t;
+                                             size_t count = 0;
+                                             for (const auto& probe : probes) count += BruteForce(probe, t);
+                                             benchmark::DoNotOptimize(&count);
+                                         },
+                                         1));
+    return results;
+}
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
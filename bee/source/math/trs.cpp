@@ -0,0 +1,217 @@
+#include "math/trs.hpp"
+#include "core.hpp"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define BEE_TRS_SSE 1
+#else
+#define BEE_TRS_SSE 0
+#endif
+
+namespace bee::internal
+{
+inline void ComposeTRS1(const glm::vec3& p, const glm::quat& q, const glm::vec3& s, glm::mat4& out)
+{
+    const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+    out[0] = glm::vec4((1.0f - 2.0f * (yy + zz)) * s.x, 2.0f * (xy + wz) * s.x, 2.0f * (xz - wy) * s.x, 0.0f);
+    out[1] = glm::vec4(2.0f * (xy - wz) * s.y, (1.0f - 2.0f * (xx + zz)) * s.y, 2.0f * (yz + wx) * s.y, 0.0f);
+    out[2] = glm::vec4(2.0f * (xz + wy) * s.z, 2.0f * (yz - wx) * s.z, (1.0f - 2.0f * (xx + yy)) * s.z, 0.0f);
+    out[3] = glm::vec4(p, 1.0f);
+}
+
+#if BEE_TRS_SSE
+// Composes 4 transforms, the rotation math runs with one transform per lane and is transposed back to columns at the end
+inline void ComposeTRS4(const glm::vec3* p, const glm::quat* q, const glm::vec3* s, glm::mat4* out)
+{
+    const __m128 qx = _mm_set_ps(q[3].x, q[2].x, q[1].x, q[0].x);
+    const __m128 qy = _mm_set_ps(q[3].y, q[2].y, q[1].y, q[0].y);
+    const __m128 qz = _mm_set_ps(q[3].z, q[2].z, q[1].z, q[0].z);
+    const __m128 qw = _mm_set_ps(q[3].w, q[2].w, q[1].w, q[0].w);
+    const __m128 sx = _mm_set_ps(s[3].x, s[2].x, s[1].x, s[0].x);
+    const __m128 sy = _mm_set_ps(s[3].y, s[2].y, s[1].y, s[0].y);
+    const __m128 sz = _mm_set_ps(s[3].z, s[2].z, s[1].z, s[0].z);
+
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+
+    const __m128 xx = _mm_mul_ps(qx, qx), yy = _mm_mul_ps(qy, qy), zz = _mm_mul_ps(qz, qz);
+    const __m128 xy = _mm_mul_ps(qx, qy), xz = _mm_mul_ps(qx, qz), yz = _mm_mul_ps(qy, qz);
+    const __m128 wx = _mm_mul_ps(qw, qx), wy = _mm_mul_ps(qw, qy), wz = _mm_mul_ps(qw, qz);
+
+    __m128 c0x = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+    __m128 c0y = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+    __m128 c0z = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+    __m128 c0w = _mm_setzero_ps();
+
+    __m128 c1x = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+    __m128 c1y = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+    __m128 c1z = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+    __m128 c1w = _mm_setzero_ps();
+
+    __m128 c2x = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+    __m128 c2y = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+    __m128 c2z = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+    __m128 c2w = _mm_setzero_ps();
+
+    _MM_TRANSPOSE4_PS(c0x, c0y, c0z, c0w);
+    _MM_TRANSPOSE4_PS(c1x, c1y, c1z, c1w);
+    _MM_TRANSPOSE4_PS(c2x, c2y, c2z, c2w);
+
+    // after the transpose every register holds one column of one transform
+    const __m128 column0[4] = {c0x, c0y, c0z, c0w};
+    const __m128 column1[4] = {c1x, c1y, c1z, c1w};
+    const __m128 column2[4] = {c2x, c2y, c2z, c2w};
+    for (int i = 0; i < 4; ++i)
+    {
+        float* m = glm::value_ptr(out[i]);
+        _mm_storeu_ps(m + 0, column0[i]);
+        _mm_storeu_ps(m + 4, column1[i]);
+        _mm_storeu_ps(m + 8, column2[i]);
+        _mm_storeu_ps(m + 12, _mm_set_ps(1.0f, p[i].z, p[i].y, p[i].x));
+    }
+}
+#endif
+
+}  // namespace bee::internal
+
+using namespace bee::internal;
+
+void bee::ComposeTRS(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales, glm::mat4* out, size_t count)
+{
+    size_t i = 0;
+#if BEE_TRS_SSE
+    for (; i + 4 <= count; i += 4)
+    {
+        ComposeTRS4(positions + i, rotations + i, scales + i, out + i);
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        ComposeTRS1(positions[i], rotations[i], scales[i], out[i]);
+    }
+}
+
+void bee::ComposeTRSScalar(const glm::vec3* positions,
+                           const glm::quat* rotations,
+                           const glm::vec3* scales,
+                           glm::mat4* out,
+                           size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        ComposeTRS1(positions[i], rotations[i], scales[i], out[i]);
+    }
+}
+
+void bee::UpdateModelMatrices(entt::registry& registry)
+{
+    PROFILE_FUNCTION();
+    static std::vector<LocalModel*> stale;
+    static std::vector<uint64_t> versions;
+    static std::vector<glm::vec3> positions;
+    static std::vector<glm::quat> rotations;
+    static std::vector<glm::vec3> scales;
+    static std::vector<glm::mat4> models;
+
+    stale.clear();
+    versions.clear();
+    positions.clear();
+    rotations.clear();
+    scales.clear();
+
+    // every transform gets its matrix, added the first time it is seen. Done up front, adding can move the matrices.
+    auto& localModels = registry.storage<LocalModel>();
+    for (auto entity : registry.view<Transform>())
+    {
+        if (!localModels.contains(entity)) localModels.emplace(entity);
+    }
+
+    for (auto [entity, transform, local] : registry.view<Transform, LocalModel>().each())
+    {
+        if (local.version == transform.GetVersion()) continue;
+        stale.push_back(&local);
+        versions.push_back(transform.GetVersion());
+        positions.push_back(transform.GetPosition());
+        rotations.push_back(transform.GetRotationQuat());
+        scales.push_back(transform.GetScale());
+    }
+
+    if (stale.empty()) return;
+
+    models.resize(stale.size());
+    ComposeTRS(positions.data(), rotations.data(), scales.data(), models.data(), stale.size());
+
+    for (size_t i = 0; i < stale.size(); ++i)
+    {
+        stale[i]->model = models[i];
+        stale[i]->version = versions[i];
+    }
+}
+
+std::vector<bee::benchmark::Result> bee::BenchmarkComposeTRS()
+{
+    constexpr size_t count = 10000;
+
+    std::vector<glm::vec3> positions(count);
+    std::vector<glm::quat> rotations(count);
+    std::vector<glm::vec3> scales(count);
+    std::vector<glm::mat4> batchModels(count);
+    std::vector<glm::mat4> scalarModels(count);
+    std::vector<Transform> transforms(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        positions[i] = glm::linearRand(glm::vec3(-100.0f), glm::vec3(100.0f));
+        rotations[i] = glm::quat(glm::radians(glm::linearRand(glm::vec3(-180.0f), glm::vec3(180.0f))));
+        scales[i] = glm::linearRand(glm::vec3(0.1f), glm::vec3(10.0f));
+        transforms[i] = Transform(positions[i], rotations[i], scales[i]);
+    }
+
+    std::vector<benchmark::Result> results;
+    results.push_back(benchmark::Measure("Transform::GetModelMatrix",
+                                         count,
+                                         [&]()
+                                         {
+                                             for (size_t i = 0; i < count; ++i)
+                                                 scalarModels[i] = transforms[i].GetModelMatrix();
+                                             benchmark::DoNotOptimize(scalarModels.data());
+                                         }));
+    results.push_back(benchmark::Measure("ComposeTRSScalar",
+                                         count,
+                                         [&]()
+                                         {
+                                             ComposeTRSScalar(positions.data(), rotations.data(), scales.data(), scalarModels.data(), count);
+                                             benchmark::DoNotOptimize(scalarModels.data());
+                                         }));
+    results.push_back(benchmark::Measure("ComposeTRS",
+                                         count,
+                                         [&]()
+                                         {
+                                             ComposeTRS(positions.data(), rotations.data(), scales.data(), batchModels.data(), count);
+                                             benchmark::DoNotOptimize(batchModels.data());
+                                         }));
+
+    // the batch kernel has to match the matrices the Transform builds itself
+    float maxError = 0.0f;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const glm::mat4 reference = transforms[i].GetModelMatrix();
+        for (int c = 0; c < 4; ++c)
+        {
+            glm::vec4 difference = glm::abs(reference[c] - batchModels[i][c]);
+            maxError = std::max(maxError, glm::max(glm::max(difference.x, difference.y), glm::max(difference.z, difference.w)));
+        }
+    }
+    if (maxError > 1e-3f) bee::benchmark::Fail("ComposeTRS differs from Transform::GetModelMatrix by {}", maxError);
+
+    return results;
+}
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
@@ -223,6 +223,50 @@ bool InputPc::GetKeyboardKeyOnce(KeyboardKey key) const
     return keys_down[k] && !prev_keys_down[k];
 }
 
+static_assert(nr_keys == Input::State::keyCount && nr_mousebuttons == Input::State::mouseButtonCount);
+static_assert(max_nr_gamepads == Input::State::gamepadCount && GLFW_GAMEPAD_AXIS_LAST + 1 == Input::State::gamepadAxisCount);
+static_assert(GLFW_GAMEPAD_BUTTON_LAST < 16, "gamepad buttons are stored in 16 bits");
+
+void InputPc::GetState(State& state) const
+{
+    for (int i = 0; i < nr_keys; ++i) state.keys[i] = keys_down[i];
+
+    state.mouseButtons = 0;
+    for (int i = 0; i < nr_mousebuttons; ++i)
+        if (mousebuttons_down[i]) state.mouseButtons |= static_cast<uint8_t>(1 << i);
+    state.mousePosition = mousepos;
+    state.mouseWheel = mousewheel;
+
+    state.gamepadsConnected = 0;
+    for (int i = 0; i < max_nr_gamepads; ++i)
+    {
+        state.gamepadButtons[i] = 0;
+        if (!gamepad_connected[i]) continue;
+
+        state.gamepadsConnected |= static_cast<uint8_t>(1 << i);
+        for (int b = 0; b <= GLFW_GAMEPAD_BUTTON_LAST; ++b)
+            if (gamepad_state[i].buttons[b]) state.gamepadButtons[i] |= static_cast<uint16_t>(1 << b);
+        for (int a = 0; a <= GLFW_GAMEPAD_AXIS_LAST; ++a) state.gamepadAxes[i][a] = gamepad_state[i].axes[a];
+    }
+}
+
+void InputPc::SetState(const State& state)
+{
+    for (int i = 0; i < nr_keys; ++i) keys_down[i] = state.keys[i];
+
+    for (int i = 0; i < nr_mousebuttons; ++i) mousebuttons_down[i] = (state.mouseButtons >> i) & 1;
+    mousepos = state.mousePosition;
+    mousewheel = state.mouseWheel;
+
+    for (int i = 0; i < max_nr_gamepads; ++i)
+    {
+        gamepad_connected[i] = (state.gamepadsConnected >> i) & 1;
+        for (int b = 0; b <= GLFW_GAMEPAD_BUTTON_LAST; ++b)
+            gamepad_state[i].buttons[b] = static_cast<unsigned char>((state.gamepadButtons[i] >> b) & 1);
+        for (int a = 0; a <= GLFW_GAMEPAD_AXIS_LAST; ++a) gamepad_state[i].axes[a] = state.gamepadAxes[i][a];
+    }
+}
+
 // NOLINTEND(readability-convert-member-functions-to-static, misc-unused-parameters)
 
 
@@ -325,77 +325,89 @@ std::vector<unsigned int> bee::resource::ConvertIndicesToUnsignedInt(const tinyg
     return indices;
 }
 
-// Updated mesh creation process using safe conversions and component verification
-Ref<bee::resource::Mesh> bee::resource::CreateMeshHandle(const tinygltf::Model& model,
-                                                         const tinygltf::Primitive& primitive,
-                                                         const std::string& name)
+bool bee::resource::GetPrimitiveGeometry(const tinygltf::Model& model,
+                                         const tinygltf::Primitive& primitive,
+                                         std::vector<glm::vec3>& positions,
+                                         std::vector<glm::vec3>& normals,
+                                         std::vector<glm::vec2>& texCoords,
+                                         std::vector<unsigned int>& indices)
 {
-    // Create mesh
-    Ref<bee::resource::Mesh> mesh = bee::resource::CreateResource<bee::resource::Mesh>(name);
-
-    if (mesh->is_valid())
-    {
-        return mesh;
-    }
+    const auto position = primitive.attributes.find("POSITION");
+    if (position == primitive.attributes.end()) return false;
 
-    // Handle positions
-    std::vector<float> positionBuffer;
-    if (primitive.attributes.find("POSITION") == primitive.attributes.end())
-    {
-        bee::Log::Error("No position attribute found in GLTF primitive");
-        return nullptr;
-    }
-    const auto& posAccessor = model.accessors[primitive.attributes.find("POSITION")->second];
+    const auto& posAccessor = model.accessors[position->second];
     const auto& posBufferView = model.bufferViews[posAccessor.bufferView];
-    const auto* positions = GetAttributeData<float>(posAccessor, model, TINYGLTF_TYPE_VEC3);
-
+    const auto* positionData = GetAttributeData<float>(posAccessor, model, TINYGLTF_TYPE_VEC3);
     size_t posStride = posBufferView.byteStride == 0 ? sizeof(glm::vec3) : posBufferView.byteStride;
 
+    positions.resize(posAccessor.count);
     for (size_t i = 0; i < posAccessor.count; i++)
     {
-        const auto* pos = (const float*)((const char*)positions + i * posStride);
-        positionBuffer.push_back(pos[0]);
-        positionBuffer.push_back(pos[1]);
-        positionBuffer.push_back(pos[2]);
+        const auto* pos = (const float*)((const char*)positionData + i * posStride);
+        positions[i] = glm::vec3(pos[0], pos[1], pos[2]);
     }
 
-    // Handle normals
-    std::vector<float> normalBuffer;
-    if (primitive.attributes.find("NORMAL") != primitive.attributes.end())
+    normals.clear();
+    const auto normal = primitive.attributes.find("NORMAL");
+    if (normal != primitive.attributes.end())
     {
-        const auto& normalAccessor = model.accessors[primitive.attributes.find("NORMAL")->second];
+        const auto& normalAccessor = model.accessors[normal->second];
         const auto& normalBufferView = model.bufferViews[normalAccessor.bufferView];
-        const auto* normals = GetAttributeData<float>(normalAccessor, model, TINYGLTF_TYPE_VEC3);
-
+        const auto* normalData = GetAttributeData<float>(normalAccessor, model, TINYGLTF_TYPE_VEC3);
         size_t normalStride = normalBufferView.byteStride == 0 ? sizeof(glm::vec3) : normalBufferView.byteStride;
 
+        normals.resize(normalAccessor.count);
         for (size_t i = 0; i < normalAccessor.count; i++)
         {
-            const auto* norm = (const float*)((const char*)normals + i * normalStride);
-            normalBuffer.push_back(norm[0]);
-            normalBuffer.push_back(norm[1]);
-            normalBuffer.push_back(norm[2]);
+            const auto* norm = (const float*)((const char*)normalData + i * normalStride);
+            normals[i] = glm::vec3(norm[0], norm[1], norm[2]);
         }
     }
 
-    // Handle texture coordinates
-    std::vector<float> texCoordBuffer;
-    if (primitive.attributes.find("TEXCOORD_0") != primitive.attributes.end())
+    texCoords.clear();
+    const auto texCoord = primitive.attributes.find("TEXCOORD_0");
+    if (texCoord != primitive.attributes.end())
     {
-        const auto& texAccessor = model.accessors[primitive.attributes.find("TEXCOORD_0")->second];
+        const auto& texAccessor = model.accessors[texCoord->second];
         const auto& texBufferView = model.bufferViews[texAccessor.bufferView];
-        const auto* texCoords = GetAttributeData<float>(texAccessor, model, TINYGLTF_TYPE_VEC2);
-
+        const auto* texData = GetAttributeData<float>(texAccessor, model, TINYGLTF_TYPE_VEC2);
         size_t texStride = texBufferView.byteStride == 0 ? sizeof(glm::vec2) : texBufferView.byteStride;
 
+        texCoords.resize(texAccessor.count);
         for (size_t i = 0; i < texAccessor.count; i++)
         {
-            const auto* tex = (const float*)((const char*)texCoords + i * texStride);
-            texCoordBuffer.push_back(tex[0]);
-            texCoordBuffer.push_back(tex[1]);
+            const auto* tex = (const float*)((const char*)texData + i * texStride);
+            texCoords[i] = glm::vec2(tex[0], tex[1]);
         }
     }
 
+    indices = ConvertIndicesToUnsignedInt(model.accessors[primitive.indices], model);
+    return true;
+}
+
+// Updated mesh creation process using safe conversions and component verification
+Ref<bee::resource::Mesh> bee::resource::CreateMeshHandle(const tinygltf::Model& model,
+                                                         const tinygltf::Primitive& primitive,
+                                                         const std::string& name)
+{
+    // Create mesh
+    Ref<bee::resource::Mesh> mesh = bee::resource::CreateResource<bee::resource::Mesh>(name);
+
+    if (mesh->is_valid())
+    {
+        return mesh;
+    }
+
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec2> texCoords;
+    std::vector<unsigned int> indices;
+    if (!GetPrimitiveGeometry(model, primitive, positions, normals, texCoords, indices))
+    {
+        bee::Log::Error("No position attribute found in GLTF primitive");
+        return nullptr;
+    }
+
     // handle vertex colors
     std::vector<float> colorBuffer;
     if (primitive.attributes.find("COLOR_0") != primitive.attributes.end())
@@ -415,18 +427,16 @@ Ref<bee::resource::Mesh> bee::resource::CreateMeshHandle(const tinygltf::Model&
         }
     }
 
-    // Handle indices
-    const auto& indexAccessor = model.accessors[primitive.indices];
-    std::vector<unsigned int> indices = ConvertIndicesToUnsignedInt(indexAccessor, model);
-
     // Pass corrected buffers to xsr::create_mesh
     mesh->GetHandle() = xsr::create_mesh(indices.data(),
-                                               (int)indexAccessor.count,
-                                               positionBuffer.data(),
-                                               normalBuffer.data(),
-                                               texCoordBuffer.data(),
-                                               colorBuffer.data(),
-                                               (int)posAccessor.count);
+                                         static_cast<unsigned int>(indices.size()),
+                                         reinterpret_cast<const float*>(positions.data()),
+                                         reinterpret_cast<const float*>(normals.data()),
+                                         reinterpret_cast<const float*>(texCoords.data()),
+                                         colorBuffer.data(),
+                                         static_cast<unsigned int>(positions.size()));
+    // kept on the CPU for exact raycasts
+    mesh->SetGeometry(std::move(positions), std::move(normals), std::move(texCoords), std::move(indices));
     return mesh;
 }
 
@@ -21,6 +21,47 @@ void bee::resource::Mesh::Unload()
 {
     xsr::unload_mesh(m_handle);
     m_handle = xsr::mesh_handle();
+
+    std::lock_guard<std::mutex> lock(m_bvhMutex);
+    m_triangleBVH.reset();
+    m_positions.clear();
+    m_normals.clear();
+    m_uvs.clear();
+    m_indices.clear();
+}
+
+void bee::resource::Mesh::SetGeometry(std::vector<glm::vec3> positions,
+                                      std::vector<glm::vec3> normals,
+                                      std::vector<glm::vec2> uvs,
+                                      std::vector<uint32_t> indices)
+{
+    std::lock_guard<std::mutex> lock(m_bvhMutex);
+    m_triangleBVH.reset();
+    m_positions = std::move(positions);
+    m_normals = std::move(normals);
+    m_uvs = std::move(uvs);
+    m_indices = std::move(indices);
+}
+
+bool bee::resource::Mesh::HasGeometry() const
+{
+    std::lock_guard<std::mutex> lock(m_bvhMutex);
+    return m_triangleBVH || !m_indices.empty();
+}
+
+const bee::TriangleBVH* bee::resource::Mesh::GetTriangleBVH() const
+{
+    std::lock_guard<std::mutex> lock(m_bvhMutex);
+    if (!m_triangleBVH && !m_indices.empty())
+    {
+        m_triangleBVH = std::make_unique<TriangleBVH>();
+        m_triangleBVH->Build(m_positions, m_normals, m_uvs, m_indices);
+        m_positions = {};
+        m_normals = {};
+        m_uvs = {};
+        m_indices = {};
+    }
+    return m_triangleBVH.get();
 }
 
 const char* bee::resource::Mesh::ToString() const { return "Mesh"; }
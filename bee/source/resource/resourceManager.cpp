@@ -3,6 +3,7 @@
 #include "resource/mesh.hpp"
 #include "resource/texture.hpp"
 #include "resource/gltfModel.hpp"
+#include "core.hpp"
 
 #if defined(EDITOR_MODE)
 #define USE_WEAK_PTR 0
@@ -225,6 +226,42 @@ void bee::resource::UnloadResources()
     }
 }
 
+std::vector<bee::benchmark::Result> bee::resource::BenchmarkLoading()
+{
+    static const char* meshes[] = {"models/quad.obj", "models/cube.obj", "models/sphere.obj"};
+    static const char* textures[] = {"textures/white.png", "textures/checkerboard.png", "textures/uv_test_image.png"};
+
+    // read once up front, the benchmark is about parsing and uploading and not about the disk
+    std::vector<benchmark::Result> results;
+    for (const char* mesh : meshes)
+    {
+        const std::string data = Engine.FileIO().ReadTextFile(FileIO::Directory::SharedAssets, mesh);
+        if (data.empty()) continue;
+        results.push_back(benchmark::MeasureSize(std::string("load_obj_mesh ") + mesh,
+                                                 data.size(),
+                                                 1,
+                                                 [&]()
+                                                 {
+                                                     xsr::mesh_handle handle = xsr::tools::load_obj_mesh(data);
+                                                     xsr::unload_mesh(handle);
+                                                 }));
+    }
+    for (const char* texture : textures)
+    {
+        const std::vector<char> data = Engine.FileIO().ReadBinaryFile(FileIO::Directory::SharedAssets, texture);
+        if (data.empty()) continue;
+        results.push_back(benchmark::MeasureSize(std::string("load_png_texture ") + texture,
+                                                 data.size(),
+                                                 1,
+                                                 [&]()
+                                                 {
+                                                     xsr::texture_handle handle = xsr::tools::load_png_texture(data);
+                                                     xsr::unload_texture(handle);
+                                                 }));
+    }
+    return results;
+}
+
 // Explicit instantiation for Mesh and Texture types
 template Ref<bee::resource::Mesh> bee::resource::LoadResource<bee::resource::Mesh>(const fs::path& path);
 template Ref<bee::resource::Texture> bee::resource::LoadResource<bee::resource::Texture>(const fs::path& path);
@@ -27,11 +27,14 @@ std::deque<fpsEntry> fpsHistory;
 
 time_t timer{};
 std::unordered_map<std::string, entry> entries;
+std::map<std::string, float> counters;
 }  // namespace bee::profiler::internal
 
 using namespace bee::profiler;
 using namespace bee::profiler::internal;
 
+void bee::profiler::SetCounter(const std::string& name, float value) { counters[name] = value; }
+
 bee::profiler::ProfilerSection::ProfilerSection(std::string _name) : name(std::move(_name)) { BeginSection(name); }
 
 bee::profiler::ProfilerSection::~ProfilerSection() { EndSection(name); }
@@ -135,6 +138,13 @@ void bee::profiler::OnImGuiRender()
         ImPlot::EndPlot();
     }
 
+    if (!counters.empty() && ImGui::CollapsingHeader("Counters"))
+    {
+        for (const auto& [name, value] : counters) ImGui::Text("%s: %.2f", name.c_str(), value);
+    }
+
+    if (ImGui::CollapsingHeader("Benchmarks")) bee::benchmark::OnImGuiRender();
+
     ImGui::End();
 
     // Reset durations and counts after plotting
@@ -2,37 +2,123 @@
 
 namespace bee::tween::internal
 {
-std::vector<TweenRef> tweens;
+std::vector<std::unique_ptr<ITweenPool>> pools;
 }
 
 using namespace bee::tween::internal;
 
 void bee::Tweener::Update(float dt)
 {
-    // for each tween in tweens
-    for (auto it = tweens.begin(); it != tweens.end();)
+    PROFILE_FUNCTION();
+
+    size_t active = 0;
+    // by index, a callback that tweens a new value type adds a pool and can move the vector
+    for (size_t i = 0; i < pools.size(); i++)
     {
-        (*it)->Update(dt);
-        if ((*it)->IsFinished())
-        {
-            it = tweens.erase(it);
-        }
-        else
-        {
-            ++it;
-        }
+        pools[i]->Update(dt);
+        active += pools[i]->Size();
     }
+    bee::profiler::SetCounter("Tweens active", static_cast<float>(active));
+}
+
+bool bee::Tweener::RemoveTween(const TweenHandle& handle)
+{
+    if (handle.pool >= pools.size()) return false;
+    return pools[handle.pool]->Remove(handle);
+}
+
+bool bee::Tweener::IsActive(const TweenHandle& handle)
+{
+    if (handle.pool >= pools.size()) return false;
+    return pools[handle.pool]->IsActive(handle);
+}
+
+void bee::Tweener::Clear()
+{
+    for (auto& pool : pools) pool->Clear();
 }
 
-void bee::Tweener::AddTween(const TweenRef& tween) { tweens.push_back(tween); }
+size_t bee::Tweener::Size()
+{
+    size_t size = 0;
+    for (auto& pool : pools) size += pool->Size();
+    return size;
+}
 
-void bee::Tweener::RemoveTween(const TweenRef& tween)
+std::vector<std::unique_ptr<bee::ITweenPool>>& bee::Tweener::Pools() { return pools; }
+
+std::vector<bee::benchmark::Result> bee::BenchmarkTween()
 {
-    tweens.erase(std::remove(tweens.begin(), tweens.end(), tween), tweens.end());
+    // local pools, the tweens of the running game are not touched
+    constexpr size_t count = 10000;
+    constexpr float dt = 1.0f / 60.0f;
+
+    std::vector<benchmark::Result> results;
+
+    // none of these finish during the benchmark, run from fitting in the cache to well outside of it
+    for (const size_t size : {size_t(1000), count, size_t(100000)})
+    {
+        TweenPool<float> values;
+        size_t updates = 0;
+        for (size_t i = 0; i < size; i++)
+        {
+            const auto ease = static_cast<EaseType>(i % static_cast<size_t>(EaseType::Count));
+            values.Add(Tween<float>(0.0f, 1.0f, 1e6f)
+                           .SetEase(ease)
+                           .OnUpdate([](void* context, const float&, float) { (*static_cast<size_t*>(context))++; },
+                                     &updates));
+        }
+        results.push_back(benchmark::MeasureSize("Update float tweens", size, size, [&]() { values.Update(dt); }));
+        benchmark::DoNotOptimize(&updates);
+
+        std::vector<glm::vec3> targets(size, glm::vec3(0.0f));
+        TweenPool<glm::vec3> vectors;
+        for (auto& target : targets) vectors.Add(CREATE_REF_TWEEN(glm::vec3, target, glm::vec3(1.0f), 1e6f));
+        results.push_back(benchmark::MeasureSize("Update vec3 tweens with target",
+                                                 size,
+                                                 size,
+                                                 [&]()
+                                                 {
+                                                     vectors.Update(dt);
+                                                     benchmark::DoNotOptimize(targets.data());
+                                                 }));
+    }
+
+    // all of them finish in the same frame, the old vector erased every finished tween from the middle
+    TweenPool<float> finishing;
+    size_t finished = 0;
+    results.push_back(benchmark::Measure(
+        "Add and finish tweens in one frame",
+        count,
+        [&]()
+        {
+            for (size_t i = 0; i < count; i++)
+                finishing.Add(Tween<float>(0.0f, 1.0f, dt)
+                                  .OnFinish([](void* context, const float&) { (*static_cast<size_t*>(context))++; },
+                                            &finished));
+            finishing.Update(dt);
+        }));
+    if (finishing.Size() != 0) bee::benchmark::Fail("{} tweens did not finish", finishing.Size());
+
+    TweenPool<float> removing;
+    std::vector<TweenHandle> handles(count);
+    results.push_back(benchmark::Measure("Add and remove tweens",
+                                         count,
+                                         [&]()
+                                         {
+                                             for (size_t i = 0; i < count; i++)
+                                                 handles[i] = removing.Add(Tween<float>(0.0f, 1.0f, 1.0f));
+                                             // every other one from the front, then the rest from the back
+                                             for (size_t i = 0; i < count; i += 2) removing.Remove(handles[i]);
+                                             for (size_t i = count; i-- > 0;) removing.Remove(handles[i]);
+                                         }));
+    if (removing.Size() != 0) bee::benchmark::Fail("{} tweens were not removed", removing.Size());
+
+    return results;
 }
 
 
 
 /*
 Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
-*/
\ No newline at end of file
+*/
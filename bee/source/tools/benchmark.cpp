@@ -0,0 +1,252 @@
+#include "tools/benchmark.hpp"
+#include "core.hpp"
+#include <limits>
+
+namespace bee::benchmark::internal
+{
+struct Entry
+{
+    std::string name;
+    BenchmarkFunction function;
+};
+
+std::vector<Entry> benchmarks;
+std::vector<Result> results;
+std::vector<std::string> failures;
+volatile const void* sink = nullptr;
+
+// allocations of the thread that runs Measure, reported by the operator new of bee_bench
+thread_local bool countAllocations = false;
+thread_local size_t allocatedBytes = 0;
+thread_local size_t allocationCount = 0;
+
+#ifdef BEE_DEBUG
+constexpr const char* buildType = "Debug";
+#else
+constexpr const char* buildType = "Release";
+#endif
+#ifdef EDITOR_MODE
+constexpr const char* buildMode = "Editor";
+#else
+constexpr const char* buildMode = "";
+#endif
+}  // namespace bee::benchmark::internal
+
+using namespace bee::benchmark;
+using namespace bee::benchmark::internal;
+
+void bee::benchmark::CountAllocation(size_t size)
+{
+    if (!countAllocations) return;
+    allocatedBytes += size;
+    allocationCount++;
+}
+
+Result bee::benchmark::Measure(const std::string& name,
+                               size_t operations,
+                               const std::function<void()>& function,
+                               int repeats)
+{
+    // warm up caches and branch predictors first
+    function();
+
+    auto best = std::chrono::nanoseconds::max();
+    size_t leastBytes = std::numeric_limits<size_t>::max();
+    size_t leastAllocations = std::numeric_limits<size_t>::max();
+    for (int i = 0; i < repeats; ++i)
+    {
+        allocatedBytes = 0;
+        allocationCount = 0;
+        countAllocations = true;
+        auto start = std::chrono::high_resolution_clock::now();
+        function();
+        auto elapsed = std::chrono::high_resolution_clock::now() - start;
+        countAllocations = false;
+
+        best = std::min(best, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+        leastBytes = std::min(leastBytes, allocatedBytes);
+        leastAllocations = std::min(leastAllocations, allocationCount);
+    }
+
+    Result result;
+    result.name = name;
+    result.operations = operations;
+    if (repeats <= 0) return result;
+
+    const double ops = static_cast<double>(operations);
+    result.totalMs = static_cast<double>(best.count()) / 1000000.0;
+    result.nsPerOp = operations > 0 ? static_cast<double>(best.count()) / ops : 0.0;
+    result.bytesPerOp = operations > 0 ? static_cast<double>(leastBytes) / ops : 0.0;
+    result.allocationsPerOp = operations > 0 ? static_cast<double>(leastAllocations) / ops : 0.0;
+    return result;
+}
+
+Result bee::benchmark::MeasureSize(const std::string& name,
+                                   size_t size,
+                                   size_t operations,
+                                   const std::function<void()>& function,
+                                   int repeats)
+{
+    Result result = Measure(name, operations, function, repeats);
+    result.size = size;
+    return result;
+}
+
+void bee::benchmark::AddFailure(const std::string& message)
+{
+    bee::Log::Error("Benchmark check failed: {}", message);
+    failures.push_back(message);
+}
+
+void bee::benchmark::DoNotOptimize(const void* value) { sink = value; }
+
+void bee::benchmark::Register(const std::string& name, BenchmarkFunction function)
+{
+    auto it = std::find_if(benchmarks.begin(), benchmarks.end(), [&](const Entry& entry) { return entry.name == name; });
+    if (it != benchmarks.end())
+    {
+        it->function = std::move(function);
+        return;
+    }
+    benchmarks.push_back({name, std::move(function)});
+}
+
+const std::vector<Result>& bee::benchmark::RunAll()
+{
+    results.clear();
+    failures.clear();
+    for (auto& benchmark : benchmarks)
+    {
+        try
+        {
+            auto benchmarkResults = benchmark.function();
+            for (auto& result : benchmarkResults) result.group = benchmark.name;
+            results.insert(results.end(), benchmarkResults.begin(), benchmarkResults.end());
+        }
+        catch (const std::exception& e)
+        {
+            Fail("Benchmark {} threw: {}", benchmark.name, e.what());
+        }
+    }
+    return results;
+}
+
+const std::vector<Result>& bee::benchmark::GetResults() { return results; }
+const std::vector<std::string>& bee::benchmark::GetFailures() { return failures; }
+
+bool bee::benchmark::WriteJson(const std::filesystem::path& path)
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        bee::Log::Error("Could not write benchmark results to {}", path.string());
+        return false;
+    }
+
+    rapidjson::OStreamWrapper stream(file);
+    rapidjson::PrettyWriter<rapidjson::OStreamWrapper> writer(stream);
+    writer.StartObject();
+    writer.Key("build");
+    writer.String(fmt::format("{}{}", buildType, buildMode).c_str());
+#if defined(_MSC_VER)
+    writer.Key("compiler");
+    writer.String(fmt::format("MSVC {}", _MSC_FULL_VER).c_str());
+#elif defined(__VERSION__)
+    writer.Key("compiler");
+    writer.String(__VERSION__);
+#endif
+    writer.Key("threads");
+    writer.Int(bee::Engine.Jobs().ThreadCount());
+    writer.Key("results");
+    writer.StartArray();
+    for (const auto& result : results)
+    {
+        writer.StartObject();
+        writer.Key("group");
+        writer.String(result.group.c_str());
+        writer.Key("name");
+        writer.String(result.name.c_str());
+        writer.Key("size");
+        writer.Uint64(result.size);
+        writer.Key("operations");
+        writer.Uint64(result.operations);
+        writer.Key("nsPerOp");
+        writer.Double(result.nsPerOp);
+        writer.Key("totalMs");
+        writer.Double(result.totalMs);
+        writer.Key("bytesPerOp");
+        writer.Double(result.bytesPerOp);
+        writer.Key("allocationsPerOp");
+        writer.Double(result.allocationsPerOp);
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.Key("failures");
+    writer.StartArray();
+    for (const auto& failure : failures) writer.String(failure.c_str());
+    writer.EndArray();
+    writer.EndObject();
+    file << '\n';
+
+    if (!file)
+    {
+        bee::Log::Error("Could not write benchmark results to {}", path.string());
+        return false;
+    }
+    bee::Log::Info("Wrote {} benchmark results and {} failed checks to {}", results.size(), failures.size(), path.string());
+    return true;
+}
+
+void bee::benchmark::OnImGuiRender()
+{
+    if (ImGui::Button(ICON_FA_PLAY TAB_FA "Run Benchmarks")) RunAll();
+    ImGui::SameLine();
+    ImGui::Text("%zu registered", benchmarks.size());
+
+    if (results.empty()) return;
+
+    ImGui::SameLine();
+    if (ImGui::Button(ICON_FA_FLOPPY_DISK TAB_FA "Save JSON..."))
+    {
+        const fs::path path = bee::FileDialog::SaveFile(FILE_FILTER("JSON Files", ".json"));
+        if (!path.empty()) WriteJson(path);
+    }
+
+    for (const auto& failure : failures) ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "%s", failure.c_str());
+
+    ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg;
+    if (ImGui::BeginTable("BenchmarkTable", 6, flags))
+    {
+        ImGui::TableSetupColumn("Benchmark", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Size");
+        ImGui::TableSetupColumn("Operations");
+        ImGui::TableSetupColumn("ns/op");
+        ImGui::TableSetupColumn("B/op");
+        ImGui::TableSetupColumn("Total (ms)");
+        ImGui::TableHeadersRow();
+
+        for (const auto& result : results)
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", result.name.c_str());
+            ImGui::TableNextColumn();
+            if (result.size > 0) ImGui::Text("%s", bee::FormatWithCommas(static_cast<int>(result.size)).c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", bee::FormatWithCommas(static_cast<int>(result.operations)).c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", result.nsPerOp);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", result.bytesPerOp);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", result.totalMs);
+        }
+        ImGui::EndTable();
+    }
+}
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
@@ -0,0 +1,133 @@
+#include "tools/ease.hpp"
+#include "core.hpp"
+#include "tools/imguiHelper.hpp"
+
+namespace bee::internal
+{
+// The lambdas ease curves were evaluated with before the compile time dispatch, kept as the reference the kernels are
+// checked against and as the baseline they are timed against
+static std::function<float(float)> referenceEaseFunction(EaseType easeType)
+{
+    switch (easeType)
+    {
+        case EaseType::Linear:
+            return [](float t) { return t; };
+        case EaseType::EaseInQuad:
+            return [](float t) { return t * t; };
+        case EaseType::EaseOutQuad:
+            return [](float t) { return t * (2 - t); };
+        case EaseType::EaseInOutQuad:
+            return [](float t) { return t < 0.5f ? 2 * t * t : -1 + (4 - 2 * t) * t; };
+        case EaseType::EaseInCubic:
+            return [](float t) { return t * t * t; };
+        case EaseType::EaseOutCubic:
+            return [](float t)
+            {
+                t -= 1;
+                return t * t * t + 1;
+            };
+        case EaseType::EaseInOutCubic:
+            return [](float t) { return t < 0.5f ? 4 * t * t * t : (t - 1) * (2 * t - 2) * (2 * t - 2) + 1; };
+        case EaseType::EaseInQuart:
+            return [](float t) { return t * t * t * t; };
+        case EaseType::EaseOutQuart:
+            return [](float t)
+            {
+                t -= 1;
+                return 1 - t * t * t * t;
+            };
+        case EaseType::EaseInOutQuart:
+            return [](float t)
+            {
+                if (t < 0.5f)
+                {
+                    return 8 * t * t * t * t;
+                }
+                else
+                {
+                    t -= 1;
+                    return 1 - 8 * t * t * t * t;
+                }
+            };
+        case EaseType::EaseInQuint:
+            return [](float t) { return t * t * t * t * t; };
+        case EaseType::EaseOutQuint:
+            return [](float t)
+            {
+                t -= 1;
+                return 1 + t * t * t * t * t;
+            };
+        case EaseType::EaseInOutQuint:
+            return [](float t) { return t < 0.5f ? 16 * t * t * t * t * t : (t -= 1, 1 + 16 * t * t * t * t * t); };
+        default:
+            throw std::invalid_argument("Unsupported m_ease type.");
+    }
+}
+}  // namespace bee::internal
+
+using namespace bee::internal;
+
+std::vector<bee::benchmark::Result> bee::BenchmarkEase()
+{
+    constexpr size_t count = 10000;
+
+    std::vector<float> values(count);
+    for (auto& value : values) value = glm::linearRand(0.0f, 1.0f);
+    std::vector<float> reference(count);
+    std::vector<float> out(count);
+
+    // ease, easeBatch and getEaseFunction have to give the same curves as the old lambdas
+    float maxError = 0.0f;
+    std::vector<benchmark::Result> results;
+    for (int type = 0; type < static_cast<int>(EaseType::Count); type++)
+    {
+        const EaseType easeType = static_cast<EaseType>(type);
+        const std::string name = ImGuiHelper::EnumToString(easeType);
+
+        const auto referenceFunc = referenceEaseFunction(easeType);
+        const auto easeFunc = getEaseFunction(easeType);
+        for (size_t i = 0; i < count; i++) reference[i] = referenceFunc(values[i]);
+        easeBatch(easeType, values.data(), out.data(), count);
+        for (size_t i = 0; i < count; i++)
+        {
+            const float error = std::max({std::abs(reference[i] - out[i]),
+                                          std::abs(reference[i] - ease(easeType, values[i])),
+                                          std::abs(reference[i] - easeFunc(values[i]))});
+            maxError = std::max(maxError, error);
+        }
+
+        // the old easeLerp built the std::function for every value
+        results.push_back(benchmark::Measure(name + " old getEaseFunction",
+                                             count,
+                                             [&]()
+                                             {
+                                                 for (size_t i = 0; i < count; i++)
+                                                     out[i] = referenceEaseFunction(easeType)(values[i]);
+                                                 benchmark::DoNotOptimize(out.data());
+                                             }));
+        results.push_back(benchmark::Measure(name + " ease",
+                                             count,
+                                             [&]()
+                                             {
+                                                 for (size_t i = 0; i < count; i++) out[i] = ease(easeType, values[i]);
+                                                 benchmark::DoNotOptimize(out.data());
+                                             }));
+        results.push_back(benchmark::Measure(name + " easeBatch",
+                                             count,
+                                             [&]()
+                                             {
+                                                 easeBatch(easeType, values.data(), out.data(), count);
+                                                 benchmark::DoNotOptimize(out.data());
+                                             }));
+    }
+
+    // the curves are written with the same operations, only contracting them differently could change the last bit
+    if (maxError > 1e-6f) bee::benchmark::Fail("Ease kernels differ from the old ease functions by {}", maxError);
+
+    return results;
+}
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
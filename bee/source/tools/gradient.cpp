@@ -2,16 +2,25 @@
 #include "core.hpp"
 #include "tools/imguiHelper.hpp"
 
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define BEE_GRADIENT_SSE 1
+#else
+#define BEE_GRADIENT_SSE 0
+#endif
+
 void bee::ColorGradient::addColor(const float position, const glm::vec4& color)
 {
     positions.push_back(position);
     colors.push_back(color);
+    bake();
 }
 
 void bee::ColorGradient::clear()
 {
     positions.clear();
     colors.clear();
+    bake();
 }
 
 glm::vec4 bee::ColorGradient::getColor(const float position) const
@@ -33,6 +42,61 @@ glm::vec4 bee::ColorGradient::getColor(const float position) const
     return color(0, 0, 0, 1);
 }
 
+glm::vec4 bee::ColorGradient::sample(const float position) const
+{
+    // NaN counts as 0 so it can't index outside the table
+    const float x = (position > 0.0f ? std::min(position, 1.0f) : 0.0f) * static_cast<float>(lutSize - 1);
+    const int i = std::min(static_cast<int>(x), lutSize - 2);
+    return m_lut[i] + (m_lut[i + 1] - m_lut[i]) * (x - static_cast<float>(i));
+}
+
+void bee::ColorGradient::sample(const float* samplePositions, glm::vec4* out, size_t count) const
+{
+    size_t i = 0;
+#if BEE_GRADIENT_SSE
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(static_cast<float>(lutSize - 1));
+    const __m128 lastIndex = _mm_set1_ps(static_cast<float>(lutSize - 2));
+    for (; i + 4 <= count; i += 4)
+    {
+        // the index and fraction of 4 samples at once, max returns zero for NaN
+        const __m128 x = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(samplePositions + i), zero), one), scale);
+        const __m128i index = _mm_cvttps_epi32(_mm_min_ps(x, lastIndex));
+        alignas(16) int indices[4];
+        alignas(16) float fractions[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(indices), index);
+        _mm_store_ps(fractions, _mm_sub_ps(x, _mm_cvtepi32_ps(index)));
+
+        for (int lane = 0; lane < 4; lane++)
+        {
+            const __m128 a = _mm_loadu_ps(&m_lut[indices[lane]].x);
+            const __m128 b = _mm_loadu_ps(&m_lut[indices[lane] + 1].x);
+            _mm_storeu_ps(&out[i + lane].x, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), _mm_set1_ps(fractions[lane]))));
+        }
+    }
+#endif
+    for (; i < count; i++) out[i] = sample(samplePositions[i]);
+}
+
+void bee::ColorGradient::bake()
+{
+    m_lut.resize(lutSize);
+    for (int i = 0; i < lutSize; i++) m_lut[i] = getColor(static_cast<float>(i) / static_cast<float>(lutSize - 1));
+
+    // the difference with the exact gradient is zero at the entries and changes at most twice as fast as the gradient
+    // itself, so half a cell away it's at most the steepest slope times the spacing
+    m_lutErrorBound = 0.0f;
+    for (size_t i = 0; i + 1 < positions.size(); i++)
+    {
+        const glm::vec4 change = glm::abs(colors[i + 1] - colors[i]);
+        const float largestChange = glm::max(glm::max(change.x, change.y), glm::max(change.z, change.w));
+        const float width = positions[i + 1] - positions[i];
+        const float error = width > 0.0f ? largestChange / width / static_cast<float>(lutSize - 1) : largestChange;
+        m_lutErrorBound = std::max(m_lutErrorBound, error);
+    }
+}
+
 bool bee::ColorGradient::OnImGuiRender()
 {
     bool changed = false;  // Flag to track changes
@@ -135,9 +199,126 @@ bool bee::ColorGradient::OnImGuiRender()
 
     ImGui::Separator();
 
+    if (changed) bake();
     return changed;  // Return the change flag
 }
 
+std::vector<bee::benchmark::Result> bee::BenchmarkGradient()
+{
+    constexpr size_t count = 10000;
+
+    // random gradients with stops in [0, 1], the table has to stay within the bound of the exact colors
+    std::vector<float> samplePositions(count);
+    for (auto& position : samplePositions) position = glm::linearRand(0.0f, 1.0f);
+
+    ColorGradient gradient;
+    size_t violations = 0;
+    float maxError = 0.0f;
+    float maxBound = 0.0f;
+    std::vector<glm::vec4> batch(count);
+    for (int g = 0; g < 64; g++)
+    {
+        std::vector<float> stops(glm::linearRand(2, 8));
+        for (auto& stop : stops) stop = glm::linearRand(0.0f, 1.0f);
+        std::sort(stops.begin(), stops.end());
+        stops.erase(std::unique(stops.begin(), stops.end()), stops.end());
+
+        gradient.clear();
+        for (float stop : stops) gradient.addColor(stop, glm::linearRand(glm::vec4(0.0f), glm::vec4(1.0f)));
+        gradient.sample(samplePositions.data(), batch.data(), count);
+
+        // a little slack for the float math in the interpolation
+        const float bound = gradient.getLutErrorBound() + 1e-5f;
+        maxBound = std::max(maxBound, bound);
+        for (size_t i = 0; i < count; i++)
+        {
+            const glm::vec4 exact = gradient.getColor(samplePositions[i]);
+            const glm::vec4 difference = glm::max(glm::abs(exact - gradient.sample(samplePositions[i])),
+                                                  glm::abs(exact - batch[i]));
+            const float error = glm::max(glm::max(difference.x, difference.y), glm::max(difference.z, difference.w));
+            maxError = std::max(maxError, error);
+            if (error > bound) violations++;
+        }
+    }
+
+    float maxEaseError = 0.0f;
+    for (int type = 0; type < static_cast<int>(EaseType::Count); type++)
+    {
+        const auto easeFunc = getEaseFunction(static_cast<EaseType>(type));
+        for (float position : samplePositions)
+        {
+            const float error = std::abs(easeFunc(position) - sampleEase(static_cast<EaseType>(type), position));
+            maxEaseError = std::max(maxEaseError, error);
+        }
+    }
+
+    if (violations > 0 || maxEaseError > easeTableMaxError)
+        bee::benchmark::Fail("Gradient tables out of bounds: {} samples over the bound, max ease error {}",
+                             violations,
+                             maxEaseError);
+    else
+        bee::Log::Info("Gradient tables within bounds: max error {} (largest bound {}), max ease error {}",
+                       maxError,
+                       maxBound,
+                       maxEaseError);
+
+    // from fitting in the cache to well outside of it
+    std::vector<benchmark::Result> results;
+    for (const size_t size : {size_t(1000), count, size_t(100000)})
+    {
+        std::vector<float> positions(size);
+        for (auto& position : positions) position = glm::linearRand(0.0f, 1.0f);
+        std::vector<glm::vec4> colors(size);
+        std::vector<float> eased(size);
+
+        results.push_back(benchmark::MeasureSize("ColorGradient::getColor",
+                                                 size,
+                                                 size,
+                                                 [&]()
+                                                 {
+                                                     for (size_t i = 0; i < size; i++)
+                                                         colors[i] = gradient.getColor(positions[i]);
+                                                     benchmark::DoNotOptimize(colors.data());
+                                                 }));
+        results.push_back(benchmark::MeasureSize("ColorGradient::sample",
+                                                 size,
+                                                 size,
+                                                 [&]()
+                                                 {
+                                                     for (size_t i = 0; i < size; i++)
+                                                         colors[i] = gradient.sample(positions[i]);
+                                                     benchmark::DoNotOptimize(colors.data());
+                                                 }));
+        results.push_back(benchmark::MeasureSize("ColorGradient::sample batch",
+                                                 size,
+                                                 size,
+                                                 [&]()
+                                                 {
+                                                     gradient.sample(positions.data(), colors.data(), size);
+                                                     benchmark::DoNotOptimize(colors.data());
+                                                 }));
+        results.push_back(benchmark::MeasureSize("easeLerp",
+                                                 size,
+                                                 size,
+                                                 [&]()
+                                                 {
+                                                     for (size_t i = 0; i < size; i++)
+                                                         eased[i] =
+                                                             easeLerp(0.0f, 1.0f, positions[i], EaseType::EaseInOutCubic);
+                                                     benchmark::DoNotOptimize(eased.data());
+                                                 }));
+        results.push_back(benchmark::MeasureSize("sampleEase batch",
+                                                 size,
+                                                 size,
+                                                 [&]()
+                                                 {
+                                                     sampleEase(EaseType::EaseInOutCubic, positions.data(), eased.data(), size);
+                                                     benchmark::DoNotOptimize(eased.data());
+                                                 }));
+    }
+    return results;
+}
+
 
 /*
 Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
@@ -3,8 +3,14 @@
 
 bee::raycasting::HitInfo bee::raycasting::Ray::IntersectTransform(glm::mat4 transform, glm::vec3 min, glm::vec3 max) const
 {
-    glm::mat4 invTransform = glm::inverse(transform);
+    return IntersectTransform(transform, glm::inverse(transform), min, max);
+}
 
+bee::raycasting::HitInfo bee::raycasting::Ray::IntersectTransform(const glm::mat4& transform,
+                                                                  const glm::mat4& invTransform,
+                                                                  glm::vec3 min,
+                                                                  glm::vec3 max) const
+{
     glm::vec3 localOrigin = glm::vec3(invTransform * glm::vec4(origin, 1.0f));
     glm::vec3 localDirection = glm::normalize(glm::vec3(invTransform * glm::vec4(direction, 0.0f)));
 
@@ -93,6 +99,238 @@ bee::raycasting::HitInfo bee::raycasting::IntersectRayWithEntity(const Ray& ray,
     return ray.IntersectTransform(transform, glm::vec3(-0.5f) * scaler, glm::vec3(0.5f) * scaler);
 }
 
+namespace bee::raycasting::internal
+{
+HitInfo IntersectTriangles(const Ray& ray, const glm::mat4& inverse, const TriangleBVH& bvh, float maxDistance)
+{
+    // t is the same along the local ray, the transform is affine
+    const glm::vec3 origin(inverse * glm::vec4(ray.origin, 1.0f));
+    const glm::vec3 direction(inverse * glm::vec4(ray.direction, 0.0f));
+
+    TriangleHit triangleHit;
+    if (!bvh.Intersect(origin, direction, maxDistance, triangleHit)) return {false, 0.0f, glm::vec3(0.0f), glm::vec3(0.0f)};
+
+    const glm::vec3 normal = glm::normalize(glm::transpose(glm::mat3(inverse)) * triangleHit.normal);
+    return {true, triangleHit.t, ray.GetPoint(triangleHit.t), normal, triangleHit.uv};
+}
+
+uint64_t CombineVersions(uint64_t a, uint64_t b) { return (a ^ b) * 1099511628211ull; }
+
+// World bounds of the box [-0.5, 0.5] * scaler transformed by the model matrix
+bee::AABB TransformedBounds(const glm::mat4& model, const glm::vec3& halfSize)
+{
+    const glm::vec3 center(model[3]);
+    const glm::vec3 extent = glm::abs(glm::vec3(model[0])) * halfSize.x + glm::abs(glm::vec3(model[1])) * halfSize.y +
+                             glm::abs(glm::vec3(model[2])) * halfSize.z;
+    return bee::AABB(center - extent, center + extent);
+}
+}  // namespace bee::raycasting::internal
+
+using namespace bee::raycasting::internal;
+
+bee::raycasting::HitInfo bee::raycasting::IntersectRayWithMesh(const Ray& ray,
+                                                               const glm::mat4& transform,
+                                                               const resource::Mesh& mesh)
+{
+    const TriangleBVH* bvh = mesh.GetTriangleBVH();
+    if (!bvh || bvh->Empty())
+    {
+        const auto& handle = mesh.GetHandle();
+        HitInfo hit = IntersectRayWithEntity(ray, glm::translate(transform, handle.meshCenter), handle.meshSize);
+        // the box test measures in the local space of the box
+        if (hit.hit) hit.distance = glm::dot(hit.position - ray.origin, ray.direction) / glm::dot(ray.direction, ray.direction);
+        return hit;
+    }
+    return IntersectTriangles(ray, glm::inverse(transform), *bvh, std::numeric_limits<float>::max());
+}
+
+bee::raycasting::Frustum bee::raycasting::Frustum::FromViewProjection(const glm::mat4& viewProjection)
+{
+    // Gribb and Hartmann, the planes are combinations of the rows of the matrix
+    const glm::mat4 m = glm::transpose(viewProjection);
+    Frustum frustum;
+    frustum.planes[0] = m[3] + m[0];  // left
+    frustum.planes[1] = m[3] - m[0];  // right
+    frustum.planes[2] = m[3] + m[1];  // bottom
+    frustum.planes[3] = m[3] - m[1];  // top
+    frustum.planes[4] = m[3] + m[2];  // near
+    frustum.planes[5] = m[3] - m[2];  // far
+    for (auto& plane : frustum.planes) plane /= glm::length(glm::vec3(plane));
+    return frustum;
+}
+
+bee::raycasting::Frustum bee::raycasting::Frustum::FromScreenRect(const glm::mat4& viewProjection,
+                                                                  const glm::vec2& ndcMin,
+                                                                  const glm::vec2& ndcMax)
+{
+    // stretch the rectangle over the whole clip space, like gluPickMatrix
+    const glm::vec2 rectMin = glm::min(ndcMin, ndcMax);
+    const glm::vec2 rectMax = glm::max(ndcMin, ndcMax);
+    const glm::vec2 size = glm::max(rectMax - rectMin, glm::vec2(1e-6f));
+    const glm::vec2 center = (rectMin + rectMax) * 0.5f;
+
+    glm::mat4 pick(1.0f);
+    pick[0][0] = 2.0f / size.x;
+    pick[1][1] = 2.0f / size.y;
+    pick[3][0] = -center.x * 2.0f / size.x;
+    pick[3][1] = -center.y * 2.0f / size.y;
+    return FromViewProjection(pick * viewProjection);
+}
+
+bool bee::raycasting::Frustum::Intersects(const AABB& aabb) const
+{
+    const glm::vec3 center = aabb.Center();
+    const glm::vec3 extent = (aabb.max - aabb.min) * 0.5f;
+    for (const auto& plane : planes)
+    {
+        const glm::vec3 normal(plane);
+        // the box is outside if even its corner furthest along the normal is behind the plane
+        const float radius = glm::dot(extent, glm::abs(normal));
+        if (glm::dot(normal, center) + plane.w + radius < 0.0f) return false;
+    }
+    return true;
+}
+
+bool bee::raycasting::SceneBVH::RayHitsBounds(const AABB& aabb,
+                                              const glm::vec3& origin,
+                                              const glm::vec3& inverseDirection,
+                                              float maxDistance)
+{
+    // slab test, infinities from axis aligned directions work out
+    const glm::vec3 t1 = (aabb.min - origin) * inverseDirection;
+    const glm::vec3 t2 = (aabb.max - origin) * inverseDirection;
+    const glm::vec3 tNear = glm::min(t1, t2);
+    const glm::vec3 tFar = glm::max(t1, t2);
+    const float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+    const float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+    return enter <= exit;
+}
+
+bool bee::raycasting::SceneBVH::IntersectEntry(const Entry& entry, const Ray& ray, float maxDistance, HitInfo& hit) const
+{
+    const TriangleBVH* bvh = m_exactMeshes && entry.mesh ? entry.mesh->GetTriangleBVH() : nullptr;
+    if (bvh && !bvh->Empty())
+    {
+        // the entry matrices include the offset to the mesh center, the triangles don't
+        const glm::mat4 meshInverse = glm::translate(glm::mat4(1.0f), entry.offset) * entry.inverse;
+        hit = IntersectTriangles(ray, meshInverse, *bvh, maxDistance);
+        return hit.hit;
+    }
+
+    hit = ray.IntersectTransform(entry.model, entry.inverse, -entry.halfSize, entry.halfSize);
+    if (!hit.hit) return false;
+
+    // IntersectTransform measures in the local space of the box
+    hit.distance = glm::dot(hit.position - ray.origin, ray.direction);
+    return hit.distance <= maxDistance;
+}
+
+bee::raycasting::SceneHit bee::raycasting::SceneBVH::Raycast(const Ray& ray, float maxDistance) const
+{
+    return Raycast(ray, maxDistance, [](entt::entity) { return true; });
+}
+
+bool bee::raycasting::SceneBVH::Linecast(const glm::vec3& start, const glm::vec3& end) const
+{
+    return Linecast(start, end, [](entt::entity) { return true; });
+}
+
+void bee::raycasting::SceneBVH::QueryFrustum(const Frustum& frustum, std::vector<entt::entity>& out) const
+{
+    QueryFrustum(frustum, out, [](entt::entity) { return true; });
+}
+
+void bee::raycasting::SceneBVH::Clear()
+{
+    m_tree.Clear();
+    m_entries.clear();
+    m_changed = 0;
+}
+
+void bee::raycasting::SceneBVH::Rebuild(entt::registry& registry)
+{
+    Clear();
+    Update(registry);
+}
+
+void bee::raycasting::SceneBVH::Update(entt::registry& registry)
+{
+    PROFILE_FUNCTION();
+    m_stamp++;
+    m_changed = 0;
+
+    auto view = registry.view<Transform, Raycastable>();
+    for (auto entity : view)
+    {
+        if (!view.get<Raycastable>(entity).raycastable) continue;
+
+        // grid cells are boxes of the tile size placed relative to their grid
+        const Cell* cell = registry.try_get<Cell>(entity);
+        glm::vec3 scaler;
+        glm::vec3 offset(0.0f);
+        Ref<resource::Mesh> mesh;
+        uint64_t version = GetWorldVersion(entity, registry);
+        if (cell)
+        {
+            scaler = glm::vec3(registry.get<Grid>(cell->gridParent).tileSize);
+            version = CombineVersions(version, GetWorldVersion(cell->gridParent, registry));
+        }
+        else
+        {
+            scaler = GetEntityScaler(registry, entity);
+            offset = GetEntityOffset(registry, entity);
+            const Renderable* renderable = registry.try_get<Renderable>(entity);
+            if (renderable && renderable->visible) mesh = renderable->mesh;
+        }
+
+        auto [it, inserted] = m_entries.try_emplace(entity);
+        Entry& entry = it->second;
+        entry.stamp = m_stamp;
+        if (!inserted && entry.version == version && entry.scaler == scaler && entry.offset == offset &&
+            entry.mesh == mesh)
+            continue;
+
+        glm::mat4 model;
+        if (cell)
+            model = GetWorldModel(cell->gridParent, registry) * view.get<Transform>(entity).GetModelMatrix();
+        else
+            model = glm::translate(GetWorldModel(entity, registry), offset);
+
+        const glm::vec3 previousCenter = entry.bounds.Center();
+        entry.model = model;
+        entry.inverse = glm::inverse(model);
+        entry.halfSize = scaler * 0.5f;
+        entry.scaler = scaler;
+        entry.offset = offset;
+        entry.mesh = std::move(mesh);
+        entry.version = version;
+        entry.bounds = TransformedBounds(model, entry.halfSize);
+
+        if (inserted)
+            entry.proxy = m_tree.CreateProxy(entry.bounds, entity);
+        else
+            m_tree.MoveProxy(entry.proxy, entry.bounds, entry.bounds.Center() - previousCenter);
+        m_changed++;
+    }
+
+    for (auto it = m_entries.begin(); it != m_entries.end();)
+    {
+        if (it->second.stamp == m_stamp)
+        {
+            ++it;
+            continue;
+        }
+        m_tree.DestroyProxy(it->second.proxy);
+        it = m_entries.erase(it);
+        m_changed++;
+    }
+}
+
+bee::raycasting::SceneBVH& bee::raycasting::GetSceneBVH(entt::registry& registry)
+{
+    if (auto* bvh = registry.ctx().find<SceneBVH>()) return *bvh;
+    return registry.ctx().emplace<SceneBVH>();
+}
 
 /*
 Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
@@ -0,0 +1,112 @@
+#include "tools/stringTable.hpp"
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+
+namespace bee::strings::internal
+{
+struct Entry
+{
+    std::string str;
+    size_t hash = 0;
+};
+
+// Entries live in fixed size chunks that are never moved, so references to the strings stay valid when the table
+// grows and readers don't need the lock. An entry is written before the count that makes it visible is published.
+constexpr size_t chunkSize = 1024;
+constexpr size_t maxChunks = 4096;
+struct Entries
+{
+    std::unique_ptr<Entry[]> chunks[maxChunks];
+    std::atomic<size_t> count = 0;
+
+    Entries()
+    {
+        chunks[0] = std::make_unique<Entry[]>(chunkSize);
+        chunks[0][0] = Entry{std::string(), std::hash<std::string_view>{}(std::string_view())};
+        count.store(1, std::memory_order_release);
+    }
+
+    const Entry& operator[](size_t id) const { return chunks[id / chunkSize][id % chunkSize]; }
+};
+
+Entries& GetEntries()
+{
+    static Entries entries;
+    return entries;
+}
+
+// the keys point into the strings owned by the entries
+std::unordered_map<std::string_view, StringId>& GetLookup()
+{
+    static std::unordered_map<std::string_view, StringId> lookup = {{std::string_view(), 0}};
+    return lookup;
+}
+
+std::mutex& GetMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+}  // namespace bee::strings::internal
+
+using namespace bee::strings::internal;
+
+bee::StringId bee::strings::Intern(std::string_view str)
+{
+    if (str.empty()) return 0;
+
+    std::lock_guard<std::mutex> lock(GetMutex());
+    auto& lookup = GetLookup();
+    auto it = lookup.find(str);
+    if (it != lookup.end()) return it->second;
+
+    // only written under the lock, readers see the entry once the count includes it
+    auto& entries = GetEntries();
+    const size_t index = entries.count.load(std::memory_order_relaxed);
+    assert(index < chunkSize * maxChunks && "string table is full");
+    auto& chunk = entries.chunks[index / chunkSize];
+    if (!chunk) chunk = std::make_unique<Entry[]>(chunkSize);
+    Entry& entry = chunk[index % chunkSize];
+    entry.str = std::string(str);
+    entry.hash = std::hash<std::string_view>{}(entry.str);
+    lookup.emplace(std::string_view(entry.str), static_cast<StringId>(index));
+    entries.count.store(index + 1, std::memory_order_release);
+    return static_cast<StringId>(index);
+}
+
+bool bee::strings::Find(std::string_view str, StringId& outId)
+{
+    std::lock_guard<std::mutex> lock(GetMutex());
+    auto& lookup = GetLookup();
+    auto it = lookup.find(str);
+    if (it == lookup.end()) return false;
+    outId = it->second;
+    return true;
+}
+
+const std::string& bee::strings::Get(StringId id)
+{
+    const auto& entries = GetEntries();
+    if (id >= entries.count.load(std::memory_order_acquire)) return entries[0].str;
+    return entries[id].str;
+}
+
+size_t bee::strings::GetHash(StringId id)
+{
+    const auto& entries = GetEntries();
+    if (id >= entries.count.load(std::memory_order_acquire)) return entries[0].hash;
+    return entries[id].hash;
+}
+
+size_t bee::strings::Count() { return GetEntries().count.load(std::memory_order_acquire); }
+
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
@@ -6,15 +6,15 @@ namespace bee
 {
 static std::random_device s_RandomDevice;
 static std::mt19937_64 s_Engine(s_RandomDevice());
-static std::uniform_int_distribution<uint64_t> s_UniformDistribution;
+static std::uniform_int_distribution<uint64_t> s_UniformDistribution(1);  // 0 is reserved for invalid
 
-//bee::UUID::UUID() : m_UUID(s_UniformDistribution(s_Engine)) {}
-//
-//UUID::UUID(uint64_t uuid) : m_UUID(uuid) {}
+UUID::UUID() : m_UUID(s_UniformDistribution(s_Engine)) {}
+
+UUID::UUID(uint64_t uuid) : m_UUID(uuid) {}
 
 }  // namespace bee
 
 
 /*
 Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
-*/
\ No newline at end of file
+*/
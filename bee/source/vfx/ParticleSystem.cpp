@@ -1,9 +1,46 @@
 #include "managers/particle_manager.hpp"
 #include "core.hpp"
 
+namespace bee::internal
+{
+// particles alive right now, counted in ApplyParticleBudget and kept up to date while emitting
+static int aliveParticles = 0;
+
+// Particles sorted by emitter and cut in groups of at most particlesPerGroup, a group is the unit of work for the
+// job system. The EmitterID signals set particlesChanged whenever a particle is created or destroyed, so the groups
+// get rebuilt no matter who adds or removes them.
+struct ParticleGroup
+{
+    entt::entity emitter = entt::null;  // entt::null for particles whose emitter is gone
+    bee::Emitter* emitterComponent = nullptr;
+    uint32_t begin = 0;  // range in groupedParticles
+    uint32_t end = 0;
+};
+constexpr uint32_t particlesPerGroup = 256;
+static std::vector<entt::entity> groupedParticles;
+static std::vector<ParticleGroup> particleGroups;
+static bool particlesChanged = true;
+
+// The random properties of the particles an emitter creates in one update, drawn per property for the whole burst
+static std::vector<glm::vec3> emitDirections;
+static std::vector<glm::vec3> emitRotations;
+static std::vector<glm::vec3> emitAngularVelocities;
+static std::vector<float> emitLifetimes;
+static std::vector<float> emitColors;  // multiply rgb and add rgb per particle
+}  // namespace bee::internal
+using namespace bee::internal;
+
+void bee::ParticleManager::Initialize()
+{
+    auto& registry = bee::Engine.Registry();
+    registry.on_construct<LifeTime>().connect<&OnLifeTimeConstruct>();
+    registry.on_destroy<LifeTime>().connect<&OnLifeTimeDestroy>();
+    registry.on_construct<EmitterID>().connect<&OnParticlesChanged>();
+    registry.on_destroy<EmitterID>().connect<&OnParticlesChanged>();
+}
+
 void bee::ParticleManager::Update(float dt)
 {
-    UpdateParticleLifetime(dt);
     UpdateEmitters(dt);
     UpdateParticleColors();
 }
@@ -12,6 +49,8 @@ void bee::ParticleManager::FixedUpdate(float dt) { UpdateParticleTransforms(dt);
 
 void bee::ParticleManager::UpdateEmitters(float dt)
 {
+    ApplyParticleBudget();
+
     auto& registry = bee::Engine.Registry();
     auto view = bee::ecs::GetView<Emitter>(registry);
     for (const auto& entity : view)
@@ -54,120 +93,267 @@ void bee::ParticleManager::EmitRemainingParticles(entt::entity emitterEntt)
 {
     auto& registry = bee::Engine.Registry();
     auto& emitter = registry.get<Emitter>(emitterEntt);
+    // the budget scales the emission rate and the max particles of the emitter
+    const float spawnRate = emitter.specs.spawnCountPerSecond * emitter.budgetScale;
+    if (spawnRate <= 0.0f)
+    {
+        // a culled emitter doesn't save up time, it would burst the moment it comes back
+        const float interval = emitter.specs.spawnCountPerSecond > 0.0f ? 1.0f / emitter.specs.spawnCountPerSecond : 0.0f;
+        emitter.time = std::min(emitter.time, interval);
+        return;
+    }
+    const int maxParticles = static_cast<int>(static_cast<float>(emitter.specs.maxParticles) * emitter.budgetScale);
+    const int maxAliveParticles = bee::Engine.Settings().particleBudget.maxParticles;
+
     // calculate the number of particles to emit based on the emission rate and the emitter time
-    int particlesToEmit =
-        emitter.specs.burst ? (int)emitter.specs.spawnCountPerSecond : (int)(emitter.time * emitter.specs.spawnCountPerSecond);
-    emitter.time -= particlesToEmit / emitter.specs.spawnCountPerSecond;
+    int particlesToEmit = emitter.specs.burst ? (int)spawnRate : (int)(emitter.time * spawnRate);
+    emitter.time -= static_cast<float>(particlesToEmit) / spawnRate;
     // emitter.time = glm::max(emitter.time, 0.0f);
 
-    for (int i = 0; i < particlesToEmit; i++)
+    const int room = std::min(maxParticles - emitter.particleCount, maxAliveParticles - aliveParticles);
+    CreateParticles(emitterEntt, std::min(particlesToEmit, room));
+}
+
+void bee::ParticleManager::ApplyParticleBudget()
+{
+    PROFILE_FUNCTION();
+    auto& registry = bee::Engine.Registry();
+    const ParticleBudgetSettings& budget = bee::Engine.Settings().particleBudget;
+
+    // emitters are scaled down by how far away and how small their particles are from the camera that renders
+    const entt::entity cameraEntity = bee::Engine.IsPlaying() ? bee::Engine.MainCamera() : bee::Engine.EditorCamera();
+    const bool hasCamera = registry.valid(cameraEntity) && registry.all_of<Camera, Transform>(cameraEntity);
+    const glm::vec3 cameraPosition = hasCamera ? GetWorldPosition(cameraEntity, registry) : glm::vec3(0.0f);
+
+    float demand = 0.0f;
+    auto view = bee::ecs::GetView<Emitter>(registry);
+    for (auto entity : view)
     {
-        if (emitter.particleCount >= emitter.specs.maxParticles)
+        auto& emitter = view.get<Emitter>(entity);
+        emitter.budgetScale = emitter.specs.active ? 1.0f : 0.0f;
+        if (!emitter.specs.active) continue;
+
+        if (hasCamera)
         {
-            break;
+            const float distance = glm::length(GetWorldPosition(entity, registry) - cameraPosition);
+            if (distance > budget.cullDistance)
+            {
+                emitter.budgetScale = 0.0f;
+                continue;
+            }
+            if (distance > budget.fullDetailDistance) emitter.budgetScale = budget.fullDetailDistance / distance;
+
+            // fraction of the screen height the largest particle of the emitter covers
+            const Camera& camera = registry.get<Camera>(cameraEntity);
+            const float particleSize = glm::max(emitter.particleSpecs.startSize, emitter.particleSpecs.endSize);
+            const float viewHeight = camera.orthographic ? 2.0f * camera.orthoSize
+                                                         : 2.0f * glm::max(distance, camera.nearClip) *
+                                                               glm::tan(glm::radians(camera.fov) * 0.5f);
+            const float screenSize = particleSize / viewHeight;
+            if (screenSize < budget.minScreenSize) emitter.budgetScale *= screenSize / budget.minScreenSize;
         }
 
-        CreateParticle(emitterEntt);
+        demand += static_cast<float>(emitter.specs.maxParticles) * emitter.budgetScale;
+    }
+
+    // every emitter gives up the same share when all of them together want more than the budget
+    const float maxParticles = static_cast<float>(budget.maxParticles);
+    const float budgetScale = demand > maxParticles ? maxParticles / demand : 1.0f;
+    if (budgetScale < 1.0f)
+    {
+        for (auto entity : view) view.get<Emitter>(entity).budgetScale *= budgetScale;
     }
+
+    aliveParticles = static_cast<int>(registry.view<LifeTime>().size());
+    bee::profiler::SetCounter("Particles alive", static_cast<float>(aliveParticles));
+    bee::profiler::SetCounter("Particle demand", demand);
+    bee::profiler::SetCounter("Particle budget used (%)", 100.0f * static_cast<float>(aliveParticles) / maxParticles);
+    bee::profiler::SetCounter("Particle budget scale", budgetScale);
 }
 
-void bee::ParticleManager::UpdateParticleTransforms(float dt)
+void bee::ParticleManager::GroupParticles()
 {
-    // Process particles
     auto& registry = bee::Engine.Registry();
-    auto view = bee::ecs::GetView<Transform, ParticlePhysics, LifeTime>(registry);
-    for (auto entity : view)
+    if (particlesChanged)
     {
-        auto& transform = view.get<Transform>(entity);
-        auto& particlePhysics = view.get<ParticlePhysics>(entity);
+        PROFILE_SECTION("Group Particles");
 
-        // Update particle velocity and position
-        if (dt > 0.0f)
+        // every emitter gets a slot, found by entity index so particles don't need a map lookup
+        struct EmitterSlot
         {
-            particlePhysics.velocity += particlePhysics.acceleration * dt;
-            transform.SetPosition(transform.GetPosition() + particlePhysics.velocity * dt);
+            entt::entity emitter = entt::null;
+            uint32_t slot = 0;
+        };
+        std::vector<EmitterSlot> slotsByIndex;
+        std::vector<entt::entity> slotEmitters;
+        for (auto entity : bee::ecs::GetView<Emitter>(registry))
+        {
+            const size_t index = static_cast<size_t>(entt::to_entity(entity));
+            if (index >= slotsByIndex.size()) slotsByIndex.resize(index + 1);
+            slotsByIndex[index] = {entity, static_cast<uint32_t>(slotEmitters.size())};
+            slotEmitters.push_back(entity);
         }
-        else
+        // particles whose emitter is gone share the last slot
+        const uint32_t orphanSlot = static_cast<uint32_t>(slotEmitters.size());
+        slotEmitters.push_back(entt::null);
+
+        auto findSlot = [&](entt::entity emitter)
+        {
+            const size_t index = static_cast<size_t>(entt::to_entity(emitter));
+            if (index >= slotsByIndex.size() || slotsByIndex[index].emitter != emitter) return orphanSlot;
+            return slotsByIndex[index].slot;
+        };
+
+        // counting sort on the emitter, particles of one emitter keep their storage order
+        auto view = bee::ecs::GetView<EmitterID, LifeTime, ParticlePhysics, Transform, Renderable>(registry);
+        std::vector<uint32_t> slotStarts(slotEmitters.size() + 1, 0);
+        for (auto entity : view) slotStarts[findSlot(view.get<EmitterID>(entity).emitterEntity) + 1]++;
+        for (size_t slot = 1; slot < slotStarts.size(); slot++) slotStarts[slot] += slotStarts[slot - 1];
+
+        groupedParticles.resize(slotStarts.back());
+        std::vector<uint32_t> slotEnds(slotStarts.begin(), slotStarts.end() - 1);
+        for (auto entity : view) groupedParticles[slotEnds[findSlot(view.get<EmitterID>(entity).emitterEntity)]++] = entity;
+
+        // large emitters are split so the work stays balanced over the threads
+        particleGroups.clear();
+        for (uint32_t slot = 0; slot < slotEmitters.size(); slot++)
         {
-            transform.SetPosition(transform.GetPosition() + particlePhysics.velocity * dt);
-            particlePhysics.velocity += particlePhysics.acceleration * dt;
+            for (uint32_t begin = slotStarts[slot]; begin < slotStarts[slot + 1]; begin += particlesPerGroup)
+            {
+                const uint32_t end = std::min(begin + particlesPerGroup, slotStarts[slot + 1]);
+                particleGroups.push_back({slotEmitters[slot], nullptr, begin, end});
+            }
         }
-        transform.SetRotation(transform.GetRotationEuler() +
-                              particlePhysics.angularVelocity * particlePhysics.rotationSpeed * dt);
+
+        particlesChanged = false;
+    }
+
+    // looked up here because emitters can be added or destroyed between updates, workers only read them
+    for (auto& group : particleGroups)
+    {
+        group.emitterComponent = registry.valid(group.emitter) ? registry.try_get<Emitter>(group.emitter) : nullptr;
     }
 }
 
-void bee::ParticleManager::UpdateParticleLifetime(float dt)
+void bee::ParticleManager::UpdateParticleTransforms(float dt)
 {
-    auto& registry = bee::Engine.Registry();
-    auto view = bee::ecs::GetView<LifeTime>(registry);
-    for (auto entity : view)
-    {
-        // Retrieve the components of the entity
-        auto& lifetime = view.get<LifeTime>(entity);
-        // Update particle lifetime
-        lifetime.remaining -= dt;
-        if (lifetime.remaining <= 0.0f)
+    PROFILE_FUNCTION();
+    GroupParticles();
+
+    auto view = bee::ecs::GetView<Transform, ParticlePhysics>(bee::Engine.Registry());
+    bee::Engine.Jobs().ParallelFor(
+        particleGroups.size(),
+        1,
+        [&](size_t begin, size_t end, size_t)
         {
-            auto& emitterID = registry.get<EmitterID>(entity);
-            entt::entity emitterEntity = emitterID.emitterEntity;
-            if (registry.valid(emitterEntity) && registry.all_of<Emitter>(emitterEntity))
+            for (size_t group = begin; group < end; group++)
             {
-                auto& emitter = registry.get<Emitter>(emitterEntity);
-                emitter.particleCount--;
-            }
+                for (uint32_t i = particleGroups[group].begin; i < particleGroups[group].end; i++)
+                {
+                    auto& transform = view.get<Transform>(groupedParticles[i]);
+                    auto& particlePhysics = view.get<ParticlePhysics>(groupedParticles[i]);
 
-            registry.destroy(entity);
-        }
-    }
+                    // Update particle velocity and position
+                    if (dt > 0.0f)
+                    {
+                        particlePhysics.velocity += particlePhysics.acceleration * dt;
+                        transform.SetPosition(transform.GetPosition() + particlePhysics.velocity * dt);
+                    }
+                    else
+                    {
+                        transform.SetPosition(transform.GetPosition() + particlePhysics.velocity * dt);
+                        particlePhysics.velocity += particlePhysics.acceleration * dt;
+                    }
+                    transform.Rotate(particlePhysics.angularVelocity * particlePhysics.rotationSpeed * dt);
+                }
+            }
+        });
 }
 
-void bee::ParticleManager::UpdateParticleColors()
+void bee::ParticleManager::OnLifeTimeConstruct(entt::registry& registry, entt::entity entity)
 {
-    auto& registry = bee::Engine.Registry();
-    auto view = bee::ecs::GetView<Transform, LifeTime, Renderable, EmitterID>(registry);
-    for (auto entity : view)
-    {
-        auto& emitterID = view.get<EmitterID>(entity);
-        entt::entity emitterEntity = emitterID.emitterEntity;
+    auto& lifetime = registry.get<LifeTime>(entity);
+    lifetime.timer =
+        bee::Engine.Timers().ScheduleAt(lifetime.expiresAt, &OnParticleExpired, nullptr, entt::to_integral(entity));
+}
 
-        const bool validEmitter = registry.valid(emitterEntity) && registry.all_of<Emitter>(emitterEntity);
-        if (!validEmitter) continue;
-        Emitter emitter = registry.get<Emitter>(emitterEntity);
-        if (validEmitter) emitter = registry.get<Emitter>(emitterEntity);
+void bee::ParticleManager::OnLifeTimeDestroy(entt::registry& registry, entt::entity entity)
+{
+    bee::Engine.Timers().Cancel(registry.get<LifeTime>(entity).timer);
+}
 
-        if (!emitter.specs.active) continue;
+void bee::ParticleManager::OnParticlesChanged(entt::registry&, entt::entity) { particlesChanged = true; }
 
-        auto& transform = view.get<Transform>(entity);
-        const auto& lifetime = view.get<LifeTime>(entity);
-        auto& renderable = view.get<Renderable>(entity);
+void bee::ParticleManager::OnParticleExpired(void*, uint64_t entity)
+{
+    auto& registry = bee::Engine.Registry();
+    const auto particle = static_cast<entt::entity>(entity);
+    if (!registry.valid(particle)) return;
 
-        const float life = 1.0f - lifetime.remaining / emitter.particleSpecs.maxLifetime;
-        const float size =
-            easeLerp(emitter.particleSpecs.startSize, emitter.particleSpecs.endSize, life, emitter.particleSpecs.sizeEase);
-        transform.SetScale(glm::vec3(size));
+    const auto* emitterID = registry.try_get<EmitterID>(particle);
+    if (emitterID && registry.valid(emitterID->emitterEntity))
+    {
+        if (auto* emitter = registry.try_get<Emitter>(emitterID->emitterEntity)) emitter->particleCount--;
+    }
+    registry.destroy(particle);
+    aliveParticles--;
+}
 
-        if (!emitter.particleSpecs.randomColor)
+void bee::ParticleManager::UpdateParticleColors()
+{
+    PROFILE_FUNCTION();
+    GroupParticles();
+
+    auto view = bee::ecs::GetView<Transform, LifeTime, Renderable>(bee::Engine.Registry());
+    const double now = bee::Engine.Timers().Now();
+    bee::Engine.Jobs().ParallelFor(
+        particleGroups.size(),
+        1,
+        [&](size_t begin, size_t end, size_t)
         {
-            if (emitter.particleSpecs.multiplyColor)
-            {
-                renderable.multiplier = emitter.particleSpecs.multiplyColorGradient.getColor(life);
-            }
-            else
+            for (size_t group = begin; group < end; group++)
             {
-                renderable.multiplier = glm::vec4(1.0f);
-            }
+                const Emitter* emitter = particleGroups[group].emitterComponent;
+                if (!emitter || !emitter->specs.active) continue;
+
+                // sizes and colors of the whole group come from the baked tables in one batch
+                const ParticleSpecs& specs = emitter->particleSpecs;
+                const ParticleGroup& particles = particleGroups[group];
+                const size_t count = particles.end - particles.begin;
+                float life[particlesPerGroup];
+                float eased[particlesPerGroup];
+                glm::vec4 colors[particlesPerGroup];
+                for (size_t i = 0; i < count; i++)
+                {
+                    const auto& lifetime = view.get<LifeTime>(groupedParticles[particles.begin + i]);
+                    const float remaining = static_cast<float>(std::max(lifetime.expiresAt - now, 0.0));
+                    life[i] = 1.0f - remaining / specs.maxLifetime;
+                }
 
-            if (emitter.particleSpecs.addColor)
-            {
-                renderable.tint = emitter.particleSpecs.addColorGradient.getColor(life);
-            }
-            else
-            {
-                renderable.tint = glm::vec4(0.0f);
+                sampleEase(specs.sizeEase, life, eased, count);
+                for (size_t i = 0; i < count; i++)
+                {
+                    auto& transform = view.get<Transform>(groupedParticles[particles.begin + i]);
+                    transform.SetScale(glm::vec3(lerp(specs.startSize, specs.endSize, eased[i])));
+                }
+
+                if (specs.randomColor) continue;
+
+                if (specs.multiplyColor) specs.multiplyColorGradient.sample(life, colors, count);
+                for (size_t i = 0; i < count; i++)
+                {
+                    auto& renderable = view.get<Renderable>(groupedParticles[particles.begin + i]);
+                    renderable.multiplier = specs.multiplyColor ? colors[i] : glm::vec4(1.0f);
+                }
+
+                if (specs.addColor) specs.addColorGradient.sample(life, colors, count);
+                for (size_t i = 0; i < count; i++)
+                {
+                    auto& renderable = view.get<Renderable>(groupedParticles[particles.begin + i]);
+                    renderable.tint = specs.addColor ? colors[i] : glm::vec4(0.0f);
+                }
             }
-        }
-    }
+        });
 }
 
 void bee::ParticleManager::EmitAllParticles(entt::entity emitterEntt)
@@ -189,11 +375,13 @@ void bee::ParticleManager::EmitAllParticles(entt::entity emitterEntt)
             {
                 registry.destroy(entity);
                 newEmitter.particleCount--;
+                aliveParticles--;
             }
         }
         else
         {
             registry.destroy(entity);
+            aliveParticles--;
         }
     }
 
@@ -201,13 +389,11 @@ void bee::ParticleManager::EmitAllParticles(entt::entity emitterEntt)
     EmitRemainingParticles(emitterEntt);
 }
 
-void bee::ParticleManager::CreateParticle(entt::entity emitterEntt)
+void bee::ParticleManager::CreateParticles(entt::entity emitterEntt, int count)
 {
+    if (count <= 0) return;
+
     auto& registry = bee::Engine.Registry();
-    auto newParticle = bee::ecs::CreateEmpty();
-    glm::vec3 velocity;
-    auto& emitter = registry.get<Emitter>(emitterEntt);
-    auto& transform = registry.get<Transform>(emitterEntt);
     // check if the emitter has a renderable component
     if (!registry.all_of<Renderable>(emitterEntt))
     {
@@ -217,110 +403,100 @@ void bee::ParticleManager::CreateParticle(entt::entity emitterEntt)
         registry.emplace<Renderable>(emitterEntt, render);
         bee::Log::Warn("Emitter does not have a renderable component. Creating a default renderable component");
     }
-    auto& render = registry.get<Renderable>(emitterEntt);
+    auto& emitter = registry.get<Emitter>(emitterEntt);
+    auto& transform = registry.get<Transform>(emitterEntt);
 
-    if (transform.GetRotationEuler() == glm::vec3(0.0f))
+    if (transform.GetRotationQuat() == glm::quat(1.0f, 0.0f, 0.0f, 0.0f))
     {
         transform.SetRotation(glm::vec3(0.0f, 1.0f, 0.0f));
     }
 
-    if (emitter.particleSpecs.randomVelocity)
+    // copied, creating the particles grows the storages the references point into
+    const Renderable render = registry.get<Renderable>(emitterEntt);
+    const ParticleSpecs& specs = emitter.particleSpecs;
+    const glm::vec3 position = GetWorldPosition(emitterEntt, registry);
+    glm::vec3 direction = transform.GetDirection();
+    if (emitter.specs.useWorldSpace)
     {
-        if (emitter.specs.useWorldSpace)
-        {
-            glm::mat4 worldTransform = bee::GetWorldModel(emitterEntt, registry);
-            glm::vec3 worldDirection = glm::vec3(worldTransform * glm::vec4(transform.GetDirection(), 0.0f));
-            velocity =
-                RandomDirectionInCone(worldDirection, emitter.specs.coneSpecs.angle) * emitter.particleSpecs.startVelocity;
-        }
-        else
-        {
-            velocity = RandomDirectionInCone(transform.GetDirection(), emitter.specs.coneSpecs.angle) *
-                       emitter.particleSpecs.startVelocity;
-        }
-    }
-    else
-    {
-        if (emitter.specs.useWorldSpace)
-        {
-            glm::mat4 worldTransform = bee::GetWorldModel(emitterEntt, registry);
-            glm::vec3 worldDirection = glm::vec3(worldTransform * glm::vec4(transform.GetDirection(), 0.0f));
-            velocity = worldDirection * emitter.particleSpecs.startVelocity;
-        }
-        else
-        {
-            velocity = transform.GetDirection() * emitter.particleSpecs.startVelocity;
-        }
+        direction = glm::vec3(bee::GetWorldModel(emitterEntt, registry) * glm::vec4(direction, 0.0f));
     }
 
-    glm::vec3 startRotation;
-    if (emitter.particleSpecs.randomStartRotation)
-    {
-        startRotation = RandomDirectionInSphere();
-    }
+    const size_t particles = static_cast<size_t>(count);
+    Random& random = ThreadRandom();
+    emitDirections.resize(particles);
+    if (specs.randomVelocity)
+        random.DirectionsInCone(emitDirections.data(), particles, direction, emitter.specs.coneSpecs.angle);
     else
-    {
-        startRotation = emitter.particleSpecs.startRotation;
-    }
+        std::fill(emitDirections.begin(), emitDirections.end(), direction);
 
-    glm::vec3 angularVelocity;
-    if (emitter.particleSpecs.randomRotate)
-    {
-        angularVelocity = RandomDirectionInSphere();
-    }
+    emitRotations.resize(particles);
+    if (specs.randomStartRotation)
+        random.UnitVectors(emitRotations.data(), particles);
     else
-    {
-        angularVelocity = startRotation;
-    }
-
-    registry.emplace<ParticlePhysics>(newParticle,
-                                      velocity,
-                                      angularVelocity,
-                                      emitter.particleSpecs.acceleration,
-                                      emitter.particleSpecs.rotationSpeed);
+        std::fill(emitRotations.begin(), emitRotations.end(), specs.startRotation);
 
-    glm::vec3 position = GetWorldPosition(emitterEntt, registry);
-    registry.emplace<Transform>(newParticle, Transform(position, startRotation, glm::vec3(emitter.particleSpecs.startSize)));
-
-    float lifetime = emitter.particleSpecs.randomLifetime
-                         ? RandomFloat(emitter.particleSpecs.minLifetime, emitter.particleSpecs.maxLifetime)
-                         : emitter.particleSpecs.startLifeTime;
-    registry.emplace<LifeTime>(newParticle, lifetime);
+    emitAngularVelocities.resize(particles);
+    if (specs.randomRotate)
+        random.UnitVectors(emitAngularVelocities.data(), particles);
+    else
+        emitAngularVelocities = emitRotations;
 
-    glm::vec4 multiplyColor;
+    emitLifetimes.resize(particles);
+    if (specs.randomLifetime)
+        random.Floats(emitLifetimes.data(), particles, specs.minLifetime, specs.maxLifetime);
+    else
+        std::fill(emitLifetimes.begin(), emitLifetimes.end(), specs.startLifeTime);
 
-    glm::vec4 addColor;
-    if (emitter.particleSpecs.randomColor)
+    if (specs.randomColor)
     {
-        multiplyColor = glm::vec4(RandomFloat(0.0f, 1.0f), RandomFloat(0.0f, 1.0f), RandomFloat(0.0f, 1.0f), 1.0f);
-        addColor = glm::vec4(RandomFloat(0.0f, 1.0f), RandomFloat(0.0f, 1.0f), RandomFloat(0.0f, 1.0f), 1.0f);
+        emitColors.resize(particles * 6);
+        random.Floats(emitColors.data(), emitColors.size());
     }
-    else
+    const glm::vec4 multiplyColor = specs.multiplyColor ? specs.multiplyColorGradient.sample(0.0f) : glm::vec4(1.0f);
+    const glm::vec4 addColor = specs.addColor ? specs.addColorGradient.sample(0.0f) : glm::vec4(0.0f);
+
+    const double now = bee::Engine.Timers().Now();
+    for (size_t i = 0; i < particles; i++)
     {
-        if (emitter.particleSpecs.multiplyColor)
+        auto newParticle = bee::ecs::CreateEmpty();
+        registry.emplace<ParticlePhysics>(newParticle,
+                                          emitDirections[i] * specs.startVelocity,
+                                          emitAngularVelocities[i],
+                                          specs.acceleration,
+                                          specs.rotationSpeed);
+        registry.emplace<Transform>(newParticle, Transform(position, emitRotations[i], glm::vec3(specs.startSize)));
+        registry.emplace<LifeTime>(newParticle, now + static_cast<double>(emitLifetimes[i]));
+        registry.emplace<Interpolated>(newParticle);  // they move in the fixed step
+
+        if (specs.randomColor)
         {
-            multiplyColor = emitter.particleSpecs.multiplyColorGradient.getColor(0.0f);
+            const float* color = &emitColors[i * 6];
+            registry.emplace<Renderable>(newParticle,
+                                         Renderable(render.mesh,
+                                                    render.texture,
+                                                    glm::vec4(color[0], color[1], color[2], 1.0f),
+                                                    glm::vec4(color[3], color[4], color[5], 1.0f),
+                                                    true,
+                                                    render.billboard,
+                                                    render.receiveShadows));
         }
         else
         {
-            multiplyColor = glm::vec4(1.0f);
+            registry.emplace<Renderable>(newParticle,
+                                         Renderable(render.mesh,
+                                                    render.texture,
+                                                    multiplyColor,
+                                                    addColor,
+                                                    true,
+                                                    render.billboard,
+                                                    render.receiveShadows));
         }
 
-        if (emitter.particleSpecs.addColor)
-        {
-            addColor = emitter.particleSpecs.addColorGradient.getColor(0.0f);
-        }
-        else
-        {
-            addColor = glm::vec4(0.0f);
-        }
+        registry.emplace<EmitterID>(newParticle, emitterEntt);
     }
-    registry.emplace<Renderable>(
-        newParticle,
-        Renderable(render.mesh, render.texture, multiplyColor, addColor, true, render.billboard, render.receiveShadows));
 
-    registry.emplace<EmitterID>(newParticle, emitterEntt);
-    emitter.particleCount++;
+    emitter.particleCount += count;
+    aliveParticles += count;
 }
 
 void bee::ParticleManager::Draw()
@@ -351,19 +527,18 @@ void bee::ParticleManager::Draw()
         auto& emitterID = particleView.get<EmitterID>(entity);
         entt::entity emitterEntity = emitterID.emitterEntity;
 
-        bool validEmitter = registry.valid(emitterEntity) && registry.all_of<Emitter>(emitterEntity);
-        Emitter emitter;
-        if (validEmitter) emitter = registry.get<Emitter>(emitterEntity);
+        // read in place, the emitter carries its baked curves and is too big to copy per particle
+        const Emitter* emitter = registry.valid(emitterEntity) ? registry.try_get<Emitter>(emitterEntity) : nullptr;
 
-        if (validEmitter && emitter.specs.active && emitter.particleSpecs.drawVelocity)
+        if (emitter && emitter->specs.active && emitter->particleSpecs.drawVelocity)
         {
             auto& transform = particleView.get<Transform>(entity);
             auto& particlePhysics = particleView.get<ParticlePhysics>(entity);
 
             float velocityMagnitude = glm::length(particlePhysics.velocity);
 
-            float minVelocity = 0.0f;                                              // Minimum velocity (green)
-            float maxVelocity = glm::length(emitter.particleSpecs.startVelocity);  // Maximum velocity (red)
+            float minVelocity = 0.0f;                                               // Minimum velocity (green)
+            float maxVelocity = glm::length(emitter->particleSpecs.startVelocity);  // Maximum velocity (red)
 
             float velocityNormalized = glm::clamp((velocityMagnitude - minVelocity) / (maxVelocity - minVelocity), 0.0f, 1.0f);
 
@@ -381,7 +556,7 @@ void bee::ParticleManager::CreateEmitter(Emitter emitter, entt::entity entity)
     {
         entity = bee::ecs::CreateDefault();
     }
-    emitter.id = rand();
+    emitter.id = ThreadRandom().Int(0, std::numeric_limits<int>::max());
 
     // check if the entity already has a renderable component
     if (registry.all_of<Renderable>(entity))
@@ -420,7 +595,7 @@ void bee::ParticleManager::CreateEmitter(Emitter emitter, entt::entity entity)
     }
 
     Transform transform;
-    if (transform.GetRotationEuler() == glm::vec3(0.0f))
+    if (transform.GetRotationQuat() == glm::quat(1.0f, 0.0f, 0.0f, 0.0f))
     {
         transform.SetRotation(glm::vec3(0.0f, 1.0f, 0.0f));
     }
@@ -436,6 +611,55 @@ void bee::ParticleManager::CreateEmitter(Emitter emitter, entt::entity entity)
     }
 }
 
+std::vector<bee::benchmark::Result> bee::ParticleManager::Benchmark()
+{
+    auto& registry = bee::Engine.Registry();
+    constexpr float dt = 1.0f / 60.0f;
+
+    std::vector<benchmark::Result> results;
+    for (const int count : {1000, 10000, 100000})
+    {
+        // far away and invisible, with a lifetime that doesn't run out while the benchmark runs
+        Emitter emitter;
+        emitter.specs.active = true;
+        emitter.specs.spawnCountPerSecond = 0.0f;
+        emitter.particleSpecs.randomLifetime = false;
+        emitter.particleSpecs.startLifeTime = 1e6f;
+        emitter.particleSpecs.maxLifetime = 1e6f;
+        emitter.particleSpecs.acceleration = glm::vec3(0.0f, -9.81f, 0.0f);
+        emitter.particleSpecs.multiplyColor = true;
+        emitter.particleSpecs.multiplyColorGradient.addColor(0.0f, glm::vec4(1.0f));
+        emitter.particleSpecs.multiplyColorGradient.addColor(1.0f, glm::vec4(1.0f, 0.5f, 0.0f, 1.0f));
+        emitter.particleSpecs.addColorGradient.addColor(0.0f, glm::vec4(0.0f));
+        emitter.particleSpecs.addColorGradient.addColor(1.0f, glm::vec4(0.2f, 0.2f, 0.2f, 0.0f));
+        emitter.id = ThreadRandom().Int(0, std::numeric_limits<int>::max());
+
+        const entt::entity emitterEntity = registry.create();
+        registry.emplace<Transform>(emitterEntity, glm::vec3(1e5f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f));
+        Renderable render;
+        render.visible = false;
+        registry.emplace<Renderable>(emitterEntity, render);
+        registry.emplace<Emitter>(emitterEntity, emitter);
+        CreateParticles(emitterEntity, count);
+
+        // particles of the running scene are updated as well, run it on an empty scene for clean numbers
+        const size_t size = static_cast<size_t>(count);
+        results.push_back(
+            benchmark::MeasureSize("Update particle transforms", size, size, [&]() { UpdateParticleTransforms(dt); }));
+        results.push_back(benchmark::MeasureSize("Update particle colors", size, size, [&]() { UpdateParticleColors(); }));
+
+        std::vector<entt::entity> particles;
+        for (auto [entity, emitterID] : registry.view<EmitterID>().each())
+        {
+            if (emitterID.emitterEntity == emitterEntity) particles.push_back(entity);
+        }
+        registry.destroy(particles.begin(), particles.end());
+        registry.destroy(emitterEntity);
+        aliveParticles -= static_cast<int>(particles.size());
+    }
+    return results;
+}
+
 
 /*
 Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
@@ -0,0 +1,46 @@
+#include "core/engine.hpp"
+#include "Physics.hpp"
+#include "tools/benchmark.hpp"
+#include <cstdlib>
+#include <new>
+
+// Replaced for this program only so Measure can count what the measured code allocates, the engine and the games keep
+// the default one. The array and sized forms end up here, aligned allocations are not counted.
+void* operator new(std::size_t size)
+{
+    bee::benchmark::CountAllocation(size);
+    if (size == 0) size = 1;
+    while (true)
+    {
+        if (void* memory = std::malloc(size)) return memory;
+        const std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+// Runs every benchmark the engine and the PaintGame physics layer register and writes the results to the json file given
+// as the first argument. The engine is initialized for its resources and render context, the game loop never runs.
+// Exits with 1 when the file could not be written or any check inside the benchmarks failed.
+int main(int argc, char* argv[])
+{
+    EngineSettings settings;
+    settings.projectPath = "bee_bench";
+    bee::Engine.Initialize(settings);
+    // Run never gets called, so the layer registers its benchmarks here
+    Physics* physics = new Physics();
+    bee::Engine.PushAppLayer(physics);
+    physics->OnEngineInit();
+    bee::benchmark::RunAll();
+    const bool written = bee::benchmark::WriteJson(argc > 1 ? argv[1] : "benchmarks.json");
+    bee::Engine.Shutdown();
+    return written && bee::benchmark::GetFailures().empty() ? 0 : 1;
+}
+
+
+/*
+Read license.txt on root or https://github.com/Sven-vh/bee-engine/blob/main/license.txt
+*/
\ No newline at end of file